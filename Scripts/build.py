@@ -14,6 +14,9 @@ def run(command):
 
 
 def main():
+    # --no-trace builds a compiler without the visualizer step logging
+    trace_flags = ["-DNO_TRACE"] if "--no-trace" in sys.argv[1:] else []
+
     # Generate lexer
     run(["lex", "lexer.l"])
 
@@ -26,15 +29,26 @@ def main():
     # Compile everything
     run([
         "gcc",
+        *trace_flags,
         "logger.c",
+        "intern.c",
+        "types.c",
         "symTable.c",
         "ast.c",
         "semantic.c",
         "icg.c",
+        "cfg.c",
+        "optimizer.c",
+        "bytecode.c",
+        "interpreter.c",
+        "asmGen.c",
+        "jit.c",
+        "stats.c",
         "lex.yy.c",
         "parser.tab.c",
         "-o",
         "compiler",
+        "-pthread",
         "-ll",
         "-ly"
     ])
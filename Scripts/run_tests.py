@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+
+import glob
+import os
+import subprocess
+import sys
+import tempfile
+
+# Runs every Tests/*.c program through ./compiler on each backend and checks
+# that the final program state holds the "// expect: name = value" lines, and
+# that every backend and optimization level ends in the same state as the
+# first mode (-O0 --run).
+
+MODES = [
+    ["-O0", "--run"],
+    ["-O1", "--run"],
+    ["-O0", "--jit"],
+    ["-O1", "--jit"],
+    ["-O0", "--emit-asm"],
+    ["-O1", "--emit-asm"],
+]
+
+# Generated programs with thousands of blocks and names, checked under a time
+# limit. An optimizer pass that keeps a table of every name for every block
+# needs minutes and gigabytes on these.
+LARGE_TIMEOUT = 10
+
+
+def many_branches(count):
+    lines = ["int x = 0;"]
+    for i in range(count):
+        lines.append(f"int v{i} = {i % 7};")
+        lines.append(f"if (v{i} > 3) {{ x = x + v{i}; }}")
+    total = sum(i % 7 for i in range(count) if i % 7 > 3)
+    return "\n".join(lines) + "\n", [f"x_0 = {total}"]
+
+
+LARGE = [
+    ("many_branches", many_branches(5000), [["-O0", "--run"], ["-O1", "--run"]]),
+]
+
+
+# The generated assembly prints strings without their source quotes
+def normalize(line):
+    return line.strip().replace('"', "")
+
+
+def final_state(output):
+    lines = output.splitlines()
+    starts = [i for i, line in enumerate(lines) if line.startswith("ProgramState")]
+    if not starts:
+        return None
+    start = starts[-1]
+    return {normalize(line) for line in lines[start + 1:] if " = " in line}
+
+
+# Returns (exit code, final state) for one backend, run in a scratch directory
+def run_mode(compiler, source, mode, workdir, timeout=None):
+    result = subprocess.run([compiler, "--no-trace", *mode], input=source,
+                            capture_output=True, text=True, cwd=workdir, timeout=timeout)
+    if "--emit-asm" not in mode or result.returncode != 0:
+        return result.returncode, final_state(result.stdout)
+
+    # The generated program prints the globals itself
+    program = os.path.join(workdir, "program")
+    build = subprocess.run(["gcc", os.path.join(workdir, "ASM", "program.s"), "-o", program],
+                           capture_output=True, text=True)
+    if build.returncode != 0:
+        return build.returncode, None
+    result = subprocess.run([program], capture_output=True, text=True)
+    return result.returncode, {normalize(line) for line in result.stdout.splitlines() if " = " in line}
+
+
+# Runs source in every mode, returns the number of failed modes
+def check(compiler, name, source, expected, modes, timeout=None):
+    failed = 0
+    reference = None
+    for mode in modes:
+        label = f"{name} {' '.join(mode)}"
+        with tempfile.TemporaryDirectory() as workdir:
+            try:
+                code, state = run_mode(compiler, source, mode, workdir, timeout)
+            except subprocess.TimeoutExpired:
+                failed += 1
+                print(f"✘ {label}: over {timeout}s")
+                continue
+        if mode is modes[0]:
+            reference = state
+
+        missing = [e for e in expected if state is None or normalize(e) not in state]
+        differs = sorted(state ^ reference) if state is not None and reference is not None else []
+        if code != 0 or missing:
+            failed += 1
+            print(f"✘ {label}: exit {code}, missing {missing}")
+        elif differs:
+            failed += 1
+            print(f"✘ {label}: differs from {' '.join(modes[0])} in {differs}")
+        else:
+            print(f"✔ {label}")
+    return failed
+
+
+def main():
+    compiler = os.path.abspath(sys.argv[1] if len(sys.argv) > 1 else "./compiler")
+    failed = 0
+    total = 0
+    tests = sorted(glob.glob(os.path.join("Tests", "*.c")))
+
+    for test in tests:
+        with open(test) as f:
+            source = f.read()
+        expected = [line.split("expect:", 1)[1].strip()
+                    for line in source.splitlines() if "// expect:" in line]
+        total += len(MODES)
+        failed += check(compiler, test, source, expected, MODES)
+
+    for name, (source, expected), modes in LARGE:
+        total += len(modes)
+        failed += check(compiler, name, source, expected, modes, LARGE_TIMEOUT)
+
+    print(f"\n{total - failed} passed, {failed} failed")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,231 @@
+import os
+import struct
+import sys
+
+# Converts the binary trace written by logger.c (layout in trace.h) into the
+# compiler_logs.json read by the visualizer.
+
+HEADER = struct.Struct("<4sIIIQ")
+FIELD_COUNT = 12
+RECORD = struct.Struct("<I%di" % FIELD_COUNT)
+
+TRACE_MAGIC = b"CTRC"
+TRACE_VERSION = 1
+TRACE_PHASE_BEGIN = 0x100
+TRACE_PHASE_END = 0x101
+
+PHASE_NAMES = ["PHASE_LEX_PARSE", "PHASE_SEMANTIC", "PHASE_ICG"]
+
+# Same order as StepType in logger.h
+STEP_TYPES = [
+    "LEX_READ_TOKEN",
+    "PARSE_SHIFT",
+    "PARSE_REDUCE_RULE",
+    "PARSE_REDUCE_RULE_COMPLETE",
+    "PARSE_ENTERING_STATE",
+    "PARSE_STACK_SNAPSHOT",
+    "PARSE_LOOKAHEAD_TOKEN",
+    "PARSE_ERROR",
+    "PARSE_SEMANTIC_STEP",
+    "PARSE_ENTER_SCOPE",
+    "PARSE_CREATE_SCOPE",
+    "PARSE_EXIT_SCOPE",
+    "PARSE_ADD_SYM",
+    "PARSE_ASSGN_SYM_TYPE",
+    "PARSE_CREATE_AST_NODE",
+    "SEMANTIC_PASS_STATUS",
+    "SEMANTIC_SYMBOL_HIGHLIGHT",
+    "SEMANTIC_NODE_HIGHLIGHT",
+    "SEMANTIC_ERROR_LOG",
+    "SEMANTIC_ANALYSIS_COMPLETE",
+    "ICG_NODE_VISIT",
+    "ICG_CREATE_TEMP",
+    "ICG_CREATE_LABEL",
+    "ICG_EMIT",
+    "ICG_PATCH_LABEL",
+    "ICG_ENTER_FUNCTION",
+    "ICG_EXIT_FUNCTION",
+    "ICG_COMPLETE",
+]
+
+# Record fields in the order logger.c stores them:
+#   ("i", key)   integer, written as a quoted number
+#   ("s", key)   string id, NULL written as ""
+#   ("s?", key)  string id, left out when NULL
+#   ("-", None)  stored but not written on its own
+ICG_LOCATION = [("i", "ast_node_id"), ("s", "node_type"), ("i", "line_no"), ("i", "char_no")]
+
+LAYOUTS = {
+    "PARSE_REDUCE_RULE": [("i", "ruleNo"), ("s", "rule")],
+    "PARSE_REDUCE_RULE_COMPLETE": [("i", "ruleNo"), ("s", "lhs"), ("i", "rhsLength")],
+    "PARSE_SEMANTIC_STEP": [("i", "ruleNo"), ("i", "stepNo"), ("s", "instr")],
+    "PARSE_CREATE_SCOPE": [("i", "table_id"), ("s", "name"), ("i", "parent_id")],
+    "PARSE_ENTER_SCOPE": [("i", "table_id"), ("s", "name")],
+    "PARSE_EXIT_SCOPE": [("i", "table_id"), ("s", "name")],
+    "PARSE_ADD_SYM": [("s", "name"), ("s", "sym_type"), ("i", "scope_id"), ("i", "is_function"),
+                      ("i", "line_no"), ("i", "char_no"), ("i", "is_duplicate")],
+    "PARSE_ASSGN_SYM_TYPE": [("s", "name"), ("s", "sym_type"), ("i", "scope_id")],
+    "PARSE_CREATE_AST_NODE": [("i", "node_id")],
+    "PARSE_ENTERING_STATE": [("i", "state")],
+    "PARSE_ERROR": [("s", "message"), ("i", "line_no"), ("i", "char_no")],
+    "SEMANTIC_PASS_STATUS": [("s", "pass"), ("s", "status"), ("s", "message")],
+    "SEMANTIC_NODE_HIGHLIGHT": [("s", "pass"), ("i", "node_id"), ("s", "node_type"), ("i", "line_no"),
+                                ("i", "char_no"), ("s", "action"), ("s?", "message")],
+    "SEMANTIC_ERROR_LOG": [("s", "pass"), ("s", "message"), ("i", "line_no"), ("i", "char_no"),
+                           ("s?", "node_id"), ("s?", "scope_id"), ("s?", "symbol_name")],
+    "SEMANTIC_ANALYSIS_COMPLETE": [("s", "status"), ("i", "total_errors")],
+    "ICG_NODE_VISIT": ICG_LOCATION + [("s", "action"), ("s?", "operator")],
+    "ICG_CREATE_TEMP": ICG_LOCATION + [("s", "temp_name")],
+    "ICG_CREATE_LABEL": ICG_LOCATION + [("s", "label_name"), ("i", "target_tac_id")],
+    "ICG_EMIT": ICG_LOCATION + [("i", "instruction_no"), ("i", "source_tac_id"), ("s", "opcode"),
+                                ("s", "result"), ("s", "arg1"), ("s", "arg2"),
+                                ("s", "target_label"), ("s", "text")],
+    "ICG_PATCH_LABEL": ICG_LOCATION + [("i", "instruction_no"), ("s", "label_name"), ("s", "text")],
+    "ICG_ENTER_FUNCTION": ICG_LOCATION + [("s", "function_name")],
+    "ICG_EXIT_FUNCTION": ICG_LOCATION + [("s", "function_name")],
+    "ICG_COMPLETE": [("s", "status"), ("i", "instruction_count"), ("i", "temporary_count"),
+                     ("i", "label_count")],
+}
+
+# Names the visualizer knows these steps by
+JSON_NAMES = {"SEMANTIC_ERROR_LOG": "SEMANTIC_ERROR"}
+
+# These close their data object without the leading space
+TIGHT_CLOSE = {"PARSE_ASSGN_SYM_TYPE", "PARSE_CREATE_AST_NODE", "PARSE_ENTERING_STATE"}
+
+
+def json_string(value):
+    if value is None:
+        return b'""'
+    out = bytearray(b'"')
+    for byte in value:
+        if byte == 0x5C:
+            out += b"\\\\"
+        elif byte == 0x22:
+            out += b'\\"'
+        elif byte == 0x0A:
+            out += b"\\n"
+        elif byte == 0x0D:
+            out += b"\\r"
+        elif byte == 0x09:
+            out += b"\\t"
+        elif byte < 0x20:
+            out += b"\\u%04x" % byte
+        else:
+            out.append(byte)
+    out += b'"'
+    return bytes(out)
+
+
+def read_trace(data):
+    magic, version, record_count, string_count, string_offset = HEADER.unpack_from(data, 0)
+    if magic != TRACE_MAGIC:
+        raise ValueError("not a compiler trace")
+    if version != TRACE_VERSION:
+        raise ValueError("unsupported trace version %d" % version)
+
+    strings = [None]
+    pos = string_offset
+    for _ in range(string_count):
+        (length,) = struct.unpack_from("<I", data, pos)
+        pos += 4
+        strings.append(data[pos:pos + length])
+        pos += length
+
+    records = [RECORD.unpack_from(data, HEADER.size + i * RECORD.size) for i in range(record_count)]
+    return records, strings
+
+
+def format_step(kind, fields, strings):
+    name = STEP_TYPES[kind] if kind < len(STEP_TYPES) else None
+
+    def string(index):
+        return json_string(strings[fields[index]])
+
+    def number(index):
+        return b'"%d"' % fields[index]
+
+    if name == "LEX_READ_TOKEN":
+        data = b'{"token": ' + string(0) + b', "value": ' + string(1)
+        data += b', "location": "%d:%d" }' % (fields[2], fields[3])
+    elif name == "PARSE_STACK_SNAPSHOT":
+        blob = strings[fields[0]] or b""
+        states = struct.unpack("<%di" % (len(blob) // 4), blob)
+        data = b'{ "states": [' + b", ".join(b"%d" % s for s in states) + b']'
+        data += b', "size": "%d" }' % fields[1]
+    elif name == "SEMANTIC_SYMBOL_HIGHLIGHT":
+        data = b'{"scope_id": ' + number(0) + b', "symbol_name": ' + string(1) + b', "reason": ' + string(2)
+        if fields[3]:
+            data += b', "old_type": ' + string(3)
+        if fields[4]:
+            data += b', "new_type": ' + string(4)
+        if fields[7]:
+            data += b', "line_no": ' + number(5) + b', "char_no": ' + number(6)
+        data += b' }'
+    elif name in LAYOUTS:
+        parts = []
+        for index, (field_kind, key) in enumerate(LAYOUTS[name]):
+            if field_kind == "i":
+                value = number(index)
+            elif field_kind == "s?" and not fields[index]:
+                continue
+            else:
+                value = string(index)
+            parts.append(b'"' + key.encode() + b'": ' + value)
+        data = b"{" + b", ".join(parts) + (b"}" if name in TIGHT_CLOSE else b" }")
+    else:
+        return b'    { "type": "UNKNOWN" },\n'
+
+    type_name = JSON_NAMES.get(name, name).encode()
+    return b'    { "type": "' + type_name + b'", "data": ' + data + b'},\n'
+
+
+def trace_to_json(data):
+    records, strings = read_trace(data)
+
+    # Mirrors how the logger used to write the JSON directly, trailing commas
+    # are dropped from the last step of a phase and from the last phase
+    out = bytearray(b'{ "phases": [\n')
+    phase_steps = 0
+    phases_written = 0
+    for kind, *fields in records:
+        if kind == TRACE_PHASE_BEGIN:
+            phase_steps = 0
+            out += b'  { "phase": "' + PHASE_NAMES[fields[0]].encode() + b'", "steps": [\n'
+        elif kind == TRACE_PHASE_END:
+            if phase_steps > 0:
+                del out[-2:]
+            out += b"\n  ]},\n"
+            phases_written += 1
+        else:
+            out += format_step(kind, fields, strings)
+            phase_steps += 1
+
+    if phases_written > 0:
+        del out[-2:]
+    out += b"\n]}\n"
+    return bytes(out)
+
+
+def main():
+    input_file = sys.argv[1] if len(sys.argv) > 1 else os.path.join("Logs", "compiler_trace.bin")
+    output_file = sys.argv[2] if len(sys.argv) > 2 else os.path.join("Logs", "compiler_logs.json")
+
+    with open(input_file, "rb") as f:
+        data = f.read()
+
+    try:
+        output = trace_to_json(data)
+    except (ValueError, struct.error) as e:
+        print(f"✘ {input_file}: {e}")
+        sys.exit(1)
+
+    with open(output_file, "wb") as f:
+        f.write(output)
+
+    print(f"✔ Converted {input_file}")
+    print(f"✔ Output written to {output_file}")
+
+
+if __name__ == "__main__":
+    main()
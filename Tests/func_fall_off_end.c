@@ -0,0 +1,7 @@
+// The if branch jumps past f's last return: f must return, not run on into g
+// expect: x_0 = 1000
+// expect: v_0 = 0
+int x = 0;
+int f(int p){ if(p > 0){ x = x + 1000; } else { return 2; } }
+int g(int q){ x = x + 1000; return 7; }
+int v = f(1);
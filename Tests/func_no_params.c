@@ -0,0 +1,6 @@
+// A function without parameters must be entered at its first statement
+// expect: x_0 = 6
+// expect: z_0 = 6
+int x = 5;
+int inc(){ x = x + 1; return x; }
+int z = inc();
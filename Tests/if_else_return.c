@@ -0,0 +1,7 @@
+// Both branches of pick's final if/else return, the jump over the else
+// branch leaves the function
+// expect: v_0 = 1
+// expect: w_0 = 2
+int pick(int p){ if(p > 0){ return 1; } else { return 2; } }
+int v = pick(3);
+int w = pick(-3);
@@ -0,0 +1,11 @@
+// Integer arithmetic wraps, INT_MIN / -1 included, instead of trapping
+// expect: c_0 = -2147483648
+// expect: d_0 = 2
+// expect: e_0 = -2147483648
+// expect: f_0 = -2147483648
+int a = -2147483647 - 1;
+int b = -1;
+int c = a / b;
+int d = 7 / 3;
+int e = a * b;
+int f = 2147483647 + 1;
@@ -0,0 +1,12 @@
+// Every path of sign returns, the jumps over the inner returns leave the
+// function and must not run into after
+// expect: total_0 = 0
+// expect: a_0 = 1
+// expect: b_0 = -1
+// expect: c_0 = 0
+int total = 0;
+int sign(int p){ if(p > 0){ return 1; } else { if(p < 0){ return -1; } else { return 0; } } }
+int after(int q){ total = total + 100; return 5; }
+int a = sign(4);
+int b = sign(-4);
+int c = sign(0);
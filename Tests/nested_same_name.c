@@ -0,0 +1,13 @@
+// Nested functions in different scopes may share a name, and a branch that
+// jumps to the end of a function returns from it
+// expect: x_0 = 3
+// expect: v_0 = 1
+// expect: w_0 = 2
+int a(){ int h(){ return 1; } return h(); }
+int b(){ int h(){ return 2; } return h(); }
+int x = a() + b();
+int pick(int p){
+  if(p > 0){ return 1; } else { return 2; }
+}
+int v = pick(3);
+int w = pick(0);
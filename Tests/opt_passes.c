@@ -0,0 +1,23 @@
+// Constants through loops and branches, a call clobbering a global, repeated
+// expressions, copies of ret_val and a branch that is never taken, so -O1
+// has work for every pass
+// expect: g_0 = 31
+// expect: s_0 = 128
+// expect: m_0 = 31
+// expect: p_0 = 261
+// expect: q_0 = 261
+// expect: z_0 = 36
+// expect: dead_0 = 0
+int g = 3;
+int f(int a){ g = g + a; return g; }
+int i = 0; int k = 5; int s = 0; int m = 2;
+while(i < 10){ s = s + k * m; if (i > 3) { k = 5; } else { m = 2; } i = i + 1; }
+int j = 0;
+while(j < 4){ int c = 7; s = s + c; m = f(c); j++; }
+int p = s * 2 + k;
+int q = s * 2 + k;
+int z = m + k;
+int dead = 0;
+int lim = 10;
+if (lim < 5) { dead = 1; }
+if (k > 10) { dead = 2; }
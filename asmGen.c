@@ -0,0 +1,394 @@
+#include "asmGen.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+static bool isAsmGenDebugOn = false;
+void setAsmGenDebugger(){
+    isAsmGenDebugOn = true;
+}
+
+typedef struct AsmContext {
+    const BytecodeProgram* program;
+    FILE* out;
+    const char** globalNames;   // Slot name for every global index
+    bool* isTarget;             // Instruction starts a jump target
+    int function;               // Function being emitted
+} AsmContext;
+
+static void emitLoad(AsmContext* ctx, uint8_t mode, int32_t value, const char* reg) {
+    const BCFunction* fn = &ctx->program->functions[ctx->function];
+    switch (mode) {
+        case BC_MODE_INT:
+        case BC_MODE_CHAR:
+            fprintf(ctx->out, "    movq $%d, %%%s\n", value, reg);
+            break;
+        case BC_MODE_STR:
+            fprintf(ctx->out, "    leaq .Lstr%d(%%rip), %%%s\n", value, reg);
+            break;
+        case BC_MODE_GLOBAL:
+            fprintf(ctx->out, "    movq v_%s(%%rip), %%%s\n", ctx->globalNames[value], reg);
+            break;
+        case BC_MODE_LOCAL:
+            fprintf(ctx->out, "    movq -%d(%%rbp), %%%s\n", 8 * (value + 1), reg);
+            break;
+        case BC_MODE_ARG:
+            // Arguments are pushed in order, so the last one sits right above the return address
+            fprintf(ctx->out, "    movq %d(%%rbp), %%%s\n", 16 + 8 * (fn->param_count - 1 - value), reg);
+            break;
+        default:
+            fprintf(ctx->out, "    movq $0, %%%s\n", reg);
+            break;
+    }
+}
+
+static void emitStore(AsmContext* ctx, uint8_t mode, int32_t value, const char* reg) {
+    switch (mode) {
+        case BC_MODE_GLOBAL:
+            fprintf(ctx->out, "    movq %%%s, v_%s(%%rip)\n", reg, ctx->globalNames[value]);
+            break;
+        case BC_MODE_LOCAL:
+            fprintf(ctx->out, "    movq %%%s, -%d(%%rbp)\n", reg, 8 * (value + 1));
+            break;
+        default:
+            break;
+    }
+}
+
+// Label of a jump target, jumps past the end of the top level code end the
+// program and jumps past the end of a function return from it
+static void emitJumpTo(AsmContext* ctx, const char* jump, int target) {
+    const BCFunction* fn = &ctx->program->functions[ctx->function];
+    if (ctx->function == 0 && target >= fn->end) {
+        fprintf(ctx->out, "    %s .Lprogram_end\n", jump);
+    } else if (target >= fn->end) {
+        fprintf(ctx->out, "    %s .Lfn%d_end\n", jump, ctx->function);
+    } else {
+        fprintf(ctx->out, "    %s .L%d\n", jump, target);
+    }
+}
+
+static const char* setccFor(BCOp op) {
+    switch (op) {
+        case BC_EQ:  return "sete";
+        case BC_NEQ: return "setne";
+        case BC_LT:  return "setl";
+        case BC_GT:  return "setg";
+        case BC_LEQ: return "setle";
+        default:     return "setge";
+    }
+}
+
+static AsmGenStatus emitInstr(AsmContext* ctx, int pc) {
+    const BytecodeProgram* program = ctx->program;
+    const BCInstr* ins = &program->code[pc];
+    FILE* out = ctx->out;
+
+    if (ctx->isTarget[pc]) fprintf(out, ".L%d:\n", pc);
+    fprintf(out, "    # %s (TAC %d)\n", getBCOpString(ins->op), program->tac_ids[pc]);
+
+    // Values are 64 bit slots holding 32 bit ints (sign extended) or string pointers
+    switch (ins->op) {
+        case BC_MOV:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            emitStore(ctx, ins->dst_mode, ins->dst, "rax");
+            break;
+        case BC_ADD:
+        case BC_SUB:
+        case BC_MUL:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            emitLoad(ctx, ins->b_mode, ins->b, "rcx");
+            fprintf(out, "    %s %%ecx, %%eax\n", ins->op == BC_ADD ? "addl" : ins->op == BC_SUB ? "subl" : "imull");
+            fprintf(out, "    cltq\n");
+            emitStore(ctx, ins->dst_mode, ins->dst, "rax");
+            break;
+        case BC_DIV:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            emitLoad(ctx, ins->b_mode, ins->b, "rcx");
+            fprintf(out, "    testl %%ecx, %%ecx\n");
+            fprintf(out, "    je .Ldiv_zero\n");
+            // idivl traps on INT_MIN / -1, divide by -1 as a wrapping negation
+            fprintf(out, "    cmpl $-1, %%ecx\n");
+            fprintf(out, "    jne .Ldiv%d\n", pc);
+            fprintf(out, "    negl %%eax\n");
+            fprintf(out, "    jmp .Ldiv%d_done\n", pc);
+            fprintf(out, ".Ldiv%d:\n", pc);
+            fprintf(out, "    cltd\n");
+            fprintf(out, "    idivl %%ecx\n");
+            fprintf(out, ".Ldiv%d_done:\n", pc);
+            fprintf(out, "    cltq\n");
+            emitStore(ctx, ins->dst_mode, ins->dst, "rax");
+            break;
+        case BC_LT:
+        case BC_GT:
+        case BC_LEQ:
+        case BC_GEQ:
+        case BC_EQ:
+        case BC_NEQ:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            emitLoad(ctx, ins->b_mode, ins->b, "rcx");
+            // Equality compares the full slot so interned string literals compare by identity
+            if (ins->op == BC_EQ || ins->op == BC_NEQ) fprintf(out, "    cmpq %%rcx, %%rax\n");
+            else fprintf(out, "    cmpl %%ecx, %%eax\n");
+            fprintf(out, "    %s %%al\n", setccFor(ins->op));
+            fprintf(out, "    movzbl %%al, %%eax\n");
+            emitStore(ctx, ins->dst_mode, ins->dst, "rax");
+            break;
+        case BC_AND:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            emitLoad(ctx, ins->b_mode, ins->b, "rcx");
+            fprintf(out, "    testq %%rax, %%rax\n");
+            fprintf(out, "    setne %%al\n");
+            fprintf(out, "    testq %%rcx, %%rcx\n");
+            fprintf(out, "    setne %%cl\n");
+            fprintf(out, "    andb %%cl, %%al\n");
+            fprintf(out, "    movzbl %%al, %%eax\n");
+            emitStore(ctx, ins->dst_mode, ins->dst, "rax");
+            break;
+        case BC_OR:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            emitLoad(ctx, ins->b_mode, ins->b, "rcx");
+            fprintf(out, "    orq %%rcx, %%rax\n");
+            fprintf(out, "    setne %%al\n");
+            fprintf(out, "    movzbl %%al, %%eax\n");
+            emitStore(ctx, ins->dst_mode, ins->dst, "rax");
+            break;
+        case BC_NOT:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            fprintf(out, "    testq %%rax, %%rax\n");
+            fprintf(out, "    sete %%al\n");
+            fprintf(out, "    movzbl %%al, %%eax\n");
+            emitStore(ctx, ins->dst_mode, ins->dst, "rax");
+            break;
+        case BC_NEG:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            fprintf(out, "    negl %%eax\n");
+            fprintf(out, "    cltq\n");
+            emitStore(ctx, ins->dst_mode, ins->dst, "rax");
+            break;
+        case BC_PRE_INC:
+        case BC_PRE_DEC:
+        case BC_POST_INC:
+        case BC_POST_DEC: {
+            int delta = (ins->op == BC_PRE_INC || ins->op == BC_POST_INC) ? 1 : -1;
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            fprintf(out, "    leal %d(%%rax), %%ecx\n", delta);
+            fprintf(out, "    movslq %%ecx, %%rcx\n");
+            emitStore(ctx, ins->a_mode, ins->a, "rcx");
+            emitStore(ctx, ins->dst_mode, ins->dst,
+                (ins->op == BC_PRE_INC || ins->op == BC_PRE_DEC) ? "rcx" : "rax");
+            break;
+        }
+        case BC_JMP:
+            emitJumpTo(ctx, "jmp", ins->dst);
+            break;
+        case BC_JMP_IF:
+        case BC_JMP_IF_NOT:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            fprintf(out, "    testq %%rax, %%rax\n");
+            emitJumpTo(ctx, ins->op == BC_JMP_IF ? "jne" : "je", ins->dst);
+            break;
+        case BC_PUSH_ARG:
+            emitLoad(ctx, ins->a_mode, ins->a, "rax");
+            fprintf(out, "    pushq %%rax\n");
+            break;
+        case BC_CALL: {
+            const BCFunction* callee = &program->functions[ins->a];
+            fprintf(out, "    call fn_%d_%s\n", ins->a, callee->name);
+            if (callee->param_count > 0) fprintf(out, "    addq $%d, %%rsp\n", 8 * callee->param_count);
+            break;
+        }
+        case BC_RET:
+            if (ctx->function == 0) {
+                fprintf(out, "    jmp .Lprogram_end\n");
+            } else {
+                fprintf(out, "    leave\n");
+                fprintf(out, "    ret\n");
+            }
+            break;
+        case BC_END:
+            fprintf(out, "    jmp .Lprogram_end\n");
+            break;
+        default:
+            fprintf(stderr, "ASM error: unsupported instruction %s at TAC %d\n",
+                getBCOpString(ins->op), program->tac_ids[pc]);
+            return ASM_ERROR;
+    }
+    return ASM_SUCCESS;
+}
+
+static void emitPrologue(AsmContext* ctx, const char* label) {
+    const BCFunction* fn = &ctx->program->functions[ctx->function];
+    int frameBytes = ((fn->frame_size * 8) + 15) & ~15;
+
+    fprintf(ctx->out, "\n%s:\n", label);
+    fprintf(ctx->out, "    pushq %%rbp\n");
+    fprintf(ctx->out, "    movq %%rsp, %%rbp\n");
+    if (frameBytes > 0) fprintf(ctx->out, "    subq $%d, %%rsp\n", frameBytes);
+    for (int i = 0; i < fn->frame_size; i++) {
+        fprintf(ctx->out, "    movq $0, -%d(%%rbp)\n", 8 * (i + 1));
+    }
+}
+
+// Print every user declared global, then return 0 from main
+static void emitProgramEnd(AsmContext* ctx) {
+    const BytecodeProgram* program = ctx->program;
+    FILE* out = ctx->out;
+
+    fprintf(out, ".Lprogram_end:\n");
+    fprintf(out, "    andq $-16, %%rsp\n");
+    for (int id = 0; id < program->slot_count; id++) {
+        const BCSlot* slot = &program->slots[id];
+        if (slot->is_local || slot->is_temp) continue;
+
+        const char* fmt = ".Lfmt_int";
+        if (slot->type == TYPE_CHAR) fmt = ".Lfmt_char";
+        else if (slot->type == TYPE_STRING) fmt = ".Lfmt_str";
+
+        fprintf(out, "    leaq %s(%%rip), %%rdi\n", fmt);
+        fprintf(out, "    leaq .Lname%d(%%rip), %%rsi\n", id);
+        fprintf(out, "    movq v_%s(%%rip), %%rdx\n", slot->name);
+        fprintf(out, "    xorl %%eax, %%eax\n");
+        fprintf(out, "    call printf@PLT\n");
+    }
+    fprintf(out, "    xorl %%eax, %%eax\n");
+    fprintf(out, "    leave\n");
+    fprintf(out, "    ret\n");
+
+    fprintf(out, ".Ldiv_zero:\n");
+    fprintf(out, "    andq $-16, %%rsp\n");
+    fprintf(out, "    leaq .Ldiv_msg(%%rip), %%rdi\n");
+    fprintf(out, "    call puts@PLT\n");
+    fprintf(out, "    movl $1, %%edi\n");
+    fprintf(out, "    call exit@PLT\n");
+}
+
+static void emitData(AsmContext* ctx) {
+    const BytecodeProgram* program = ctx->program;
+    FILE* out = ctx->out;
+
+    fprintf(out, "\n    .bss\n");
+    fprintf(out, "    .align 8\n");
+    for (int g = 0; g < program->global_count; g++) {
+        fprintf(out, "v_%s:\n    .zero 8\n", ctx->globalNames[g]);
+    }
+
+    fprintf(out, "\n    .section .rodata\n");
+    fprintf(out, ".Lfmt_int:\n    .string \"%%s = %%d\\n\"\n");
+    fprintf(out, ".Lfmt_char:\n    .string \"%%s = '%%c'\\n\"\n");
+    fprintf(out, ".Lfmt_str:\n    .string \"%%s = %%s\\n\"\n");
+    fprintf(out, ".Ldiv_msg:\n    .string \"Runtime error: division by zero\"\n");
+    for (int id = 0; id < program->slot_count; id++) {
+        const BCSlot* slot = &program->slots[id];
+        if (slot->is_local || slot->is_temp) continue;
+        fprintf(out, ".Lname%d:\n    .string \"%s\"\n", id, slot->name);
+    }
+    for (int s = 0; s < program->string_count; s++) {
+        // Literals keep the quotes from the lexer
+        const char* str = program->strings[s];
+        if (str[0] == '"') fprintf(out, ".Lstr%d:\n    .string %s\n", s, str);
+        else fprintf(out, ".Lstr%d:\n    .string \"%s\"\n", s, str);
+    }
+    fprintf(out, "\n    .section .note.GNU-stack,\"\",@progbits\n");
+}
+
+AsmGenStatus emitX86Assembly(const BytecodeProgram* program, FILE* out) {
+    if (!program || !out) return ASM_ERROR;
+
+    AsmContext ctx;
+    ctx.program = program;
+    ctx.out = out;
+    ctx.function = 0;
+    ctx.globalNames = calloc(program->global_count + 1, sizeof(char*));
+    ctx.isTarget = calloc(program->code_count + 1, sizeof(bool));
+    if (!ctx.globalNames || !ctx.isTarget) {
+        fprintf(stderr, "Memory allocation failed for assembly generation\n");
+        exit(1);
+    }
+
+    for (int id = 0; id < program->slot_count; id++) {
+        if (!program->slots[id].is_local) ctx.globalNames[program->slots[id].index] = program->slots[id].name;
+    }
+    for (int pc = 0; pc < program->code_count; pc++) {
+        const BCInstr* ins = &program->code[pc];
+        if (ins->dst_mode == BC_MODE_TARGET) ctx.isTarget[ins->dst] = true;
+    }
+
+    fprintf(out, "# Generated from TAC\n");
+    fprintf(out, "    .text\n");
+    fprintf(out, "    .globl main\n");
+
+    AsmGenStatus status = ASM_SUCCESS;
+    for (int f = 0; f < program->function_count && status == ASM_SUCCESS; f++) {
+        const BCFunction* fn = &program->functions[f];
+        if (isAsmGenDebugOn) printf("[ASM] Emitting %s [%d, %d)\n", fn->name, fn->entry, fn->end);
+
+        ctx.function = f;
+        if (f == 0) {
+            emitPrologue(&ctx, "main");
+        } else {
+            char label[256];
+            // Nested functions in different scopes may share a name
+            snprintf(label, sizeof(label), "fn_%d_%s", f, fn->name);
+            emitPrologue(&ctx, label);
+        }
+
+        for (int pc = fn->entry; pc < fn->end && status == ASM_SUCCESS; pc++) {
+            status = emitInstr(&ctx, pc);
+        }
+
+        if (f == 0) {
+            emitProgramEnd(&ctx);
+        } else {
+            // Falling off the end of a function returns
+            fprintf(out, ".Lfn%d_end:\n", f);
+            fprintf(out, "    leave\n");
+            fprintf(out, "    ret\n");
+        }
+    }
+
+    if (status == ASM_SUCCESS) emitData(&ctx);
+
+    free(ctx.globalNames);
+    free(ctx.isTarget);
+    return status;
+}
+
+// Function to create directory if it doesn't exist
+static int createDirectory(const char *folderPath){
+    #ifdef _WIN32
+    if (_mkdir(folderPath) == -1) {
+    #else
+    if (mkdir(folderPath, 0777) == -1) {
+    #endif
+
+        if (errno != EEXIST) {
+            perror("Error creating directory");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+AsmGenStatus exportX86Assembly(const char* folderPath, TACList* code) {
+    BytecodeProgram* program = lowerTACToBytecode(code);
+    if (!program) return ASM_ERROR;
+
+    char filePath[256];
+    snprintf(filePath, sizeof(filePath), "%s/program.s", folderPath);
+    createDirectory(folderPath);
+
+    FILE* file = fopen(filePath, "w");
+    if (!file) {
+        perror("Error opening assembly file");
+        freeBytecode(program);
+        return ASM_ERROR;
+    }
+
+    AsmGenStatus status = emitX86Assembly(program, file);
+    fclose(file);
+    freeBytecode(program);
+
+    if (status == ASM_SUCCESS) printf("\nAssembly written to %s\n", filePath);
+    return status;
+}
@@ -0,0 +1,22 @@
+#ifndef ASMGEN_H
+#define ASMGEN_H
+
+#include <stdio.h>
+#include "bytecode.h"
+
+typedef enum {
+    ASM_SUCCESS,
+    ASM_ERROR
+} AsmGenStatus;
+
+void setAsmGenDebugger();
+
+// Writes GNU assembler x86-64 (AT&T syntax, System V) for the program to out.
+// The generated main runs the top level code and prints every user declared
+// global on exit, so it can be checked against --run.
+AsmGenStatus emitX86Assembly(const BytecodeProgram* program, FILE* out);
+
+// Lowers codeList and writes it to <folderPath>/program.s
+AsmGenStatus exportX86Assembly(const char* folderPath, TACList* code);
+
+#endif
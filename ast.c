@@ -6,48 +6,122 @@
 #include <stdbool.h>
 #include "logger.h"
 
-ASTRegistry astRegistry;
+ASTArena astArena;
 
 bool isASTDebugOn = false;
 void setASTDebugger(){
     isASTDebugOn = true;
 }
 
-void initASTRegistry(void) {
-    astRegistry.capacity = 1024;
-    astRegistry.count = 0;
-    astRegistry.nodes = malloc(
-        sizeof(ASTNode*) * astRegistry.capacity
-    );
+static void freeWalkStack(void);
+
+static void addArenaBlock(void) {
+    if (astArena.block_count == astArena.block_capacity) {
+        int capacity = astArena.block_capacity ? astArena.block_capacity * 2 : 16;
+        ASTArenaBlock** blocks = realloc(astArena.blocks, sizeof(ASTArenaBlock*) * capacity);
+        if (!blocks) {
+            fprintf(stderr, "Memory allocation error\n");
+            exit(1);
+        }
+        astArena.blocks = blocks;
+        astArena.block_capacity = capacity;
+    }
+    ASTArenaBlock* block = malloc(sizeof(ASTArenaBlock));
+    if (!block) {
+        fprintf(stderr, "Memory allocation error\n");
+        exit(1);
+    }
+    block->used = 0;
+    astArena.blocks[astArena.block_count++] = block;
 }
 
-void registerASTNode(ASTNode* node) {
-    if (astRegistry.count >= astRegistry.capacity) {
-        astRegistry.capacity *= 2;
+void initASTArena(void) {
+    astArena.count = 0;
+    addArenaBlock();
+}
 
-        astRegistry.nodes = realloc(
-            astRegistry.nodes,
-            sizeof(ASTNode*) * astRegistry.capacity
-        );
+static void growNodeInfo(void) {
+    int capacity = astArena.info_capacity ? astArena.info_capacity * 2 : AST_ARENA_BLOCK_SIZE;
+    SourceSpan* spans = realloc(astArena.spans, sizeof(SourceSpan) * capacity);
+    int* export_ids = realloc(astArena.export_ids, sizeof(int) * capacity);
+    if (!spans || !export_ids) {
+        fprintf(stderr, "Memory allocation error\n");
+        exit(1);
     }
+    astArena.spans = spans;
+    astArena.export_ids = export_ids;
+    astArena.info_capacity = capacity;
+}
 
-    astRegistry.nodes[astRegistry.count++] = node;
+static ASTNode* allocASTNode(void) {
+    if (!astArena.block_count) initASTArena();
+    ASTArenaBlock* block = astArena.blocks[astArena.block_count - 1];
+    if (block->used == AST_ARENA_BLOCK_SIZE) {
+        addArenaBlock();
+        block = astArena.blocks[astArena.block_count - 1];
+    }
+    if (astArena.count == astArena.info_capacity) growNodeInfo();
+    ASTNode* node = &block->nodes[block->used++];
+    node->node_id = astArena.count++;
+    astArena.export_ids[node->node_id] = -1;
+    return node;
 }
 
-void freeASTRegistry(void) {
-    free(astRegistry.nodes);
-    astRegistry.nodes = NULL;
-    astRegistry.count = 0;
-    astRegistry.capacity = 0;
+void freeASTArena(void) {
+    for (int b = 0; b < astArena.block_count; b++) {
+        ASTArenaBlock* block = astArena.blocks[b];
+        for (int i = 0; i < block->used; i++) {
+            if (isASTListNode(&block->nodes[i])) free(block->nodes[i].list_data.items);
+        }
+        free(block);
+    }
+    printf("Freed %d nodes\n", astArena.count);
+    free(astArena.blocks);
+    free(astArena.spans);
+    free(astArena.export_ids);
+    astArena.blocks = NULL;
+    astArena.block_count = astArena.block_capacity = 0;
+    astArena.spans = NULL;
+    astArena.export_ids = NULL;
+    astArena.info_capacity = 0;
+    freeWalkStack();
+    astArena.count = 0;
 }
 
 void logASTCreation(int node_id) {
+    if (!isTraceOn()) return;
     Step s;
     s.type = PARSE_CREATE_AST_NODE;
     s.CreateASTNode.node_id = node_id;
     log_step(s);
 }
 
+static const char* operatorNames[OPERATOR_COUNT] = {
+    [OP_NONE]     = NULL,
+    [OP_ADD]      = "+",
+    [OP_SUB]      = "-",
+    [OP_MUL]      = "*",
+    [OP_DIV]      = "/",
+    [OP_EQ]       = "==",
+    [OP_NEQ]      = "!=",
+    [OP_LT]       = "<",
+    [OP_GT]       = ">",
+    [OP_LEQ]      = "<=",
+    [OP_GEQ]      = ">=",
+    [OP_AND]      = "&&",
+    [OP_OR]       = "||",
+    [OP_NOT]      = "!",
+    [OP_PRE_INC]  = "PRE_INC",
+    [OP_PRE_DEC]  = "PRE_DEC",
+    [OP_POST_INC] = "POST_INC",
+    [OP_POST_DEC] = "POST_DEC",
+};
+
+const char* getOperatorName(Operator op) {
+    if (op < 0 || op >= OPERATOR_COUNT) return NULL;
+    return operatorNames[op];
+}
+
 const char* getNodeName(NodeType type) {
     switch (type) {
         case NODE_PROGRAM:       return "PROGRAM";
@@ -119,415 +193,311 @@ SourceSpan spanFromNode(ASTNode* node) {
         return makeSourceSpan(0, 0, 0, 0);
     }
 
-    return makeSourceSpan(
-        node->start_line_no,
-        node->start_char_no,
-        node->end_line_no,
-        node->end_char_no
-    );
+    return *nodeSpan(node);
 }
 
 void applySourceSpan(ASTNode* node, SourceSpan span) {
     if (!node) return;
 
-    node->line_no = span.start_line;
-    node->char_no = span.start_col;
-    node->start_line_no = span.start_line;
-    node->start_char_no = span.start_col;
-    node->end_line_no = span.end_line;
-    node->end_char_no = span.end_col;
+    *nodeSpan(node) = span;
 }
 
 ASTNode* createASTNode(NodeType type, SourceSpan span) {
-    static int node_id = 0;
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
-    if (!node) {
-        fprintf(stderr, "Memory allocation error\n");
-        exit(1);
-    }
-    node->node_id = node_id++;
-    node->export_id = -1;
+    ASTNode* node = allocASTNode();
     node->type = type;
-    node->visited = false;
+    node->inferedType = TYPE_NONE;
     applySourceSpan(node, span);
-    registerASTNode(node);
+    if (isASTListNode(node)) {
+        node->list_data.items = NULL;
+        node->list_data.count = node->list_data.capacity = 0;
+    }
     logASTCreation(node->node_id);
     return node;
 }
 
+bool isASTListNode(ASTNode* node) {
+    switch (node->type) {
+        case NODE_STMT_LIST:
+        case NODE_VAR_LIST:
+        case NODE_PARAM_LIST:
+        case NODE_ARG_LIST:
+            return true;
+        default:
+            return false;
+    }
+}
+
+#define AST_LIST_INITIAL_CAPACITY 4
+
+void appendASTListItem(ASTNode* list, ASTNode* item) {
+    if (!item) return;
+    if (list->list_data.count == list->list_data.capacity) {
+        int capacity = list->list_data.capacity ? list->list_data.capacity * 2 : AST_LIST_INITIAL_CAPACITY;
+        ASTRef* items = realloc(list->list_data.items, sizeof(ASTRef) * capacity);
+        if (!items) {
+            fprintf(stderr, "Memory allocation error\n");
+            exit(1);
+        }
+        list->list_data.items = items;
+        list->list_data.capacity = capacity;
+    }
+    list->list_data.items[list->list_data.count++] = astRef(item);
+}
+
 void deriveRangeFromChildren(ASTNode* node, ASTNode* first_child, ASTNode* last_child) {
     if (!node) return;
 
+    SourceSpan* span = nodeSpan(node);
     if (first_child) {
-        node->line_no = first_child->start_line_no;
-        node->char_no = first_child->start_char_no;
-        node->start_line_no = first_child->start_line_no;
-        node->start_char_no = first_child->start_char_no;
-        node->end_line_no = first_child->end_line_no;
-        node->end_char_no = first_child->end_char_no;
+        *span = *nodeSpan(first_child);
     } 
     if (last_child) {
-        node->end_line_no = last_child->end_line_no;
-        node->end_char_no = last_child->end_char_no;
+        span->end_line = nodeSpan(last_child)->end_line;
+        span->end_col = nodeSpan(last_child)->end_col;
     }
 }
 
 
-void traverseAST(ASTNode* node, ASTTraversalCallback callback, void* context, ASTTraversalVisitHook visit_hook, void* visit_context) {
-    if (!node) return;
-
-    if (visit_hook) {
-        visit_hook(node, visit_context);
+// Children of a node in the order traverseAST visits them, missing ones left out
+ASTRef* getASTChildren(ASTNode* node, ASTRef buffer[AST_MAX_CHILDREN], int* count) {
+    if (isASTListNode(node)) {
+        *count = node->list_data.count;
+        return node->list_data.items;
     }
 
-    // Call the callback function for the current node
-    if(callback(node, context) == 0){
-        // STOP TRAVERSAL
-        return;
-    }
+    ASTRef all[AST_MAX_CHILDREN] = {0};
 
-    // Traverse based on node type
     switch (node->type) {
         case NODE_PROGRAM:
-            traverseAST(node->program_data.stmt_list, callback, context, visit_hook, visit_context);
+            all[0] = node->program_data.stmt_list;
             break;
 
         case NODE_RETURN:
-            traverseAST(node->return_data.return_value, callback, context, visit_hook, visit_context);
+            all[0] = node->return_data.return_value;
             break;
 
-        case NODE_INT_LITERAL:
-        case NODE_CHAR_LITERAL:
-        case NODE_STR_LITERAL:
-        case NODE_TYPE_SPEC:
-        case NODE_ID:
-        case NODE_ID_REF:
-        case NODE_BREAK_STMT:
-        case NODE_CONTINUE_STMT:
-            // Leaf nodes
-            break;
-
-        case NODE_STMT_LIST:
-            traverseAST(node->stmt_list_data.stmt_list, callback, context, visit_hook, visit_context);
-            traverseAST(node->stmt_list_data.stmt, callback, context, visit_hook, visit_context);
-            break;
-        
         case NODE_STMT:
-            traverseAST(node->stmt_data.stmt, callback, context, visit_hook, visit_context);
+            all[0] = node->stmt_data.stmt;
             break;
 
         case NODE_BLOCK_STMT:
-            traverseAST(node->block_stmt_data.stmt_list, callback, context, visit_hook, visit_context);
+            all[0] = node->block_stmt_data.stmt_list;
             break;
 
         case NODE_DECL:
-            traverseAST(node->decl_data.type_spec, callback, context, visit_hook, visit_context);
-            traverseAST(node->decl_data.var_list, callback, context, visit_hook, visit_context);
-            break;
-
-        case NODE_VAR_LIST:
-            traverseAST(node->var_list_data.var_list, callback, context, visit_hook, visit_context);
-            traverseAST(node->var_list_data.var, callback, context, visit_hook, visit_context);
+            all[0] = node->decl_data.type_spec;
+            all[1] = node->decl_data.var_list;
             break;
 
         case NODE_VAR:
-            traverseAST(node->var_data.id, callback, context, visit_hook, visit_context);
-            traverseAST(node->var_data.value, callback, context, visit_hook, visit_context);
+            all[0] = node->var_data.id;
+            all[1] = node->var_data.value;
             break;
 
         case NODE_ASSGN:
-            traverseAST(node->assgn_data.left, callback, context, visit_hook, visit_context);
-            traverseAST(node->assgn_data.right, callback, context, visit_hook, visit_context);
+            all[0] = node->assgn_data.left;
+            all[1] = node->assgn_data.right;
             break;
 
         case NODE_EXPR_BINARY:
-            traverseAST(node->expr_data.left, callback, context, visit_hook, visit_context);
-            traverseAST(node->expr_data.right, callback, context, visit_hook, visit_context);
+            all[0] = node->expr_data.left;
+            all[1] = node->expr_data.right;
             break;
 
         case NODE_EXPR_UNARY:
-            traverseAST(node->expr_data.left, callback, context, visit_hook, visit_context);
-            break;
-
         case NODE_EXPR_TERM:
-            traverseAST(node->expr_data.left, callback, context, visit_hook, visit_context);
+            all[0] = node->expr_data.left;
             break;
 
         case NODE_IF:
-            traverseAST(node->if_else_data.condition, callback, context, visit_hook, visit_context);
-            traverseAST(node->if_else_data.if_branch, callback, context, visit_hook, visit_context);
+            all[0] = node->if_else_data.condition;
+            all[1] = node->if_else_data.if_branch;
             break;
 
         case NODE_IF_ELSE:
-            traverseAST(node->if_else_data.condition, callback, context, visit_hook, visit_context);
-            traverseAST(node->if_else_data.if_branch, callback, context, visit_hook, visit_context);
-            traverseAST(node->if_else_data.else_branch, callback, context, visit_hook, visit_context);
+            all[0] = node->if_else_data.condition;
+            all[1] = node->if_else_data.if_branch;
+            all[2] = node->if_else_data.else_branch;
             break;
 
         case NODE_IF_COND:
-            traverseAST(node->if_cond_data.cond, callback, context, visit_hook, visit_context); 
+            all[0] = node->if_cond_data.cond;
             break;
 
         case NODE_IF_BRANCH:
         case NODE_ELSE_BRANCH:
-            traverseAST(node->if_else_branch.branch, callback, context, visit_hook, visit_context);;
+            all[0] = node->if_else_branch.branch;
             break;
 
         case NODE_WHILE:
-            traverseAST(node->while_data.condition, callback, context, visit_hook, visit_context);
-            traverseAST(node->while_data.while_body, callback, context, visit_hook, visit_context);
+            all[0] = node->while_data.condition;
+            all[1] = node->while_data.while_body;
             break;
-        case NODE_WHILE_COND:   
-            traverseAST(node->while_cond_data.cond, callback, context, visit_hook, visit_context);
+
+        case NODE_WHILE_COND:
+            all[0] = node->while_cond_data.cond;
             break;
 
-        case NODE_WHILE_BODY:   
-            traverseAST(node->while_body_data.body, callback, context, visit_hook, visit_context);
-            break;            
+        case NODE_WHILE_BODY:
+            all[0] = node->while_body_data.body;
+            break;
 
         case NODE_FOR:
-            traverseAST(node->for_data.init, callback, context, visit_hook, visit_context);
-            traverseAST(node->for_data.condition, callback, context, visit_hook, visit_context);
-            traverseAST(node->for_data.updation, callback, context, visit_hook, visit_context);
-            traverseAST(node->for_data.body, callback, context, visit_hook, visit_context);
+            all[0] = node->for_data.init;
+            all[1] = node->for_data.condition;
+            all[2] = node->for_data.updation;
+            all[3] = node->for_data.body;
             break;
 
         case NODE_FOR_INIT:
-            traverseAST(node->for_init_data.init, callback, context, visit_hook, visit_context);            
+            all[0] = node->for_init_data.init;
             break;
 
         case NODE_FOR_COND:
-            traverseAST(node->for_cond_data.cond, callback, context, visit_hook, visit_context); 
+            all[0] = node->for_cond_data.cond;
             break;
 
         case NODE_FOR_UPDATION:
-            traverseAST(node->for_updation_data.updation, callback, context, visit_hook, visit_context); 
+            all[0] = node->for_updation_data.updation;
             break;
 
         case NODE_FOR_BODY:
-            traverseAST(node->for_body_data.body, callback, context, visit_hook, visit_context); 
-            break; 
+            all[0] = node->for_body_data.body;
+            break;
 
         case NODE_EXPR_COMMA_LIST:
-            traverseAST(node->expr_comma_list_data.expr_comma_list, callback, context, visit_hook, visit_context);
-            traverseAST(node->expr_comma_list_data.expr_comma_list_item, callback, context, visit_hook, visit_context);
+            all[0] = node->expr_comma_list_data.expr_comma_list;
+            all[1] = node->expr_comma_list_data.expr_comma_list_item;
             break;
+
         case NODE_FUNC_DECL:
-            traverseAST(node->func_decl_data.id, callback, context, visit_hook, visit_context);
-            traverseAST(node->func_decl_data.params, callback, context, visit_hook, visit_context);
-            traverseAST(node->func_decl_data.body, callback, context, visit_hook, visit_context);
+            all[0] = node->func_decl_data.id;
+            all[1] = node->func_decl_data.params;
+            all[2] = node->func_decl_data.body;
             break;
 
         case NODE_FUNC_BODY:
-            traverseAST(node->func_body_data.body, callback, context, visit_hook, visit_context);
+            all[0] = node->func_body_data.body;
             break;
 
         case NODE_FUNC_CALL:
-            traverseAST(node->func_call_data.id, callback, context, visit_hook, visit_context);
-            traverseAST(node->func_call_data.arg_list, callback, context, visit_hook, visit_context);
-            break;
-
-        case NODE_PARAM_LIST:
-            traverseAST(node->param_list_data.param_list, callback, context, visit_hook, visit_context);
-            traverseAST(node->param_list_data.param, callback, context, visit_hook, visit_context);
+            all[0] = node->func_call_data.id;
+            all[1] = node->func_call_data.arg_list;
             break;
 
         case NODE_PARAM:
-            traverseAST(node->param_data.id, callback, context, visit_hook, visit_context);
-            break;
-
-        case NODE_ARG_LIST:
-            traverseAST(node->arg_list_data.arg, callback, context, visit_hook, visit_context);
-            traverseAST(node->arg_list_data.arg_list, callback, context, visit_hook, visit_context);
+            all[0] = node->param_data.id;
             break;
 
         case NODE_ARG:
-            traverseAST(node->arg_data.arg, callback, context, visit_hook, visit_context);
+            all[0] = node->arg_data.arg;
             break;
 
         default:
-            break;
-    }
-}
-void traverseASTPostorder(ASTNode* node, ASTTraversalCallback callback, void* context) {
-    if (!node) return;
-
-    // Traverse based on node type
-    switch (node->type) {
-        case NODE_PROGRAM:
-            traverseASTPostorder(node->program_data.stmt_list, callback, context);
-            break;
-
-        case NODE_RETURN:
-            traverseASTPostorder(node->return_data.return_value, callback, context);
-            break;
-
-        case NODE_INT_LITERAL:
-        case NODE_CHAR_LITERAL:
-        case NODE_STR_LITERAL:
-        case NODE_TYPE_SPEC:
-        case NODE_ID:
-        case NODE_ID_REF:
-        case NODE_BREAK_STMT:
-        case NODE_CONTINUE_STMT:
             // Leaf nodes
             break;
+    }
 
-        case NODE_STMT_LIST:
-            traverseASTPostorder(node->stmt_list_data.stmt_list, callback, context);
-            traverseASTPostorder(node->stmt_list_data.stmt, callback, context);
-            break;
-        
-        case NODE_STMT:
-            traverseASTPostorder(node->stmt_data.stmt, callback, context);
-            break;
-
-        case NODE_BLOCK_STMT:
-            traverseASTPostorder(node->block_stmt_data.stmt_list, callback, context);
-            break;
-
-        case NODE_DECL:
-            traverseASTPostorder(node->decl_data.type_spec, callback, context);
-            traverseASTPostorder(node->decl_data.var_list, callback, context);
-            break;
-
-        case NODE_VAR_LIST:
-            traverseASTPostorder(node->var_list_data.var_list, callback, context);
-            traverseASTPostorder(node->var_list_data.var, callback, context);
-            break;
-
-        case NODE_VAR:
-            traverseASTPostorder(node->var_data.id, callback, context);
-            traverseASTPostorder(node->var_data.value, callback, context);
-            break;
-
-        case NODE_ASSGN:
-            traverseASTPostorder(node->assgn_data.left, callback, context);
-            traverseASTPostorder(node->assgn_data.right, callback, context);
-            break;
-
-        case NODE_EXPR_BINARY:
-            traverseASTPostorder(node->expr_data.left, callback, context);
-            traverseASTPostorder(node->expr_data.right, callback, context);
-            break;
-
-        case NODE_EXPR_UNARY:
-            traverseASTPostorder(node->expr_data.left, callback, context);
-            break;
-
-        case NODE_EXPR_TERM:
-            traverseASTPostorder(node->expr_data.left, callback, context);
-            break;
-
-        case NODE_IF:
-            traverseASTPostorder(node->if_else_data.condition, callback, context);
-            traverseASTPostorder(node->if_else_data.if_branch, callback, context);
-            break;
-
-        case NODE_IF_ELSE:
-            traverseASTPostorder(node->if_else_data.condition, callback, context);
-            traverseASTPostorder(node->if_else_data.if_branch, callback, context);
-            traverseASTPostorder(node->if_else_data.else_branch, callback, context);
-            break;
-
-        case NODE_IF_COND:
-            traverseASTPostorder(node->if_cond_data.cond, callback, context); 
-            break;
-
-        case NODE_IF_BRANCH:
-        case NODE_ELSE_BRANCH:
-            traverseASTPostorder(node->if_else_branch.branch, callback, context);;
-            break;
-
-        case NODE_WHILE:
-            traverseASTPostorder(node->while_data.condition, callback, context);
-            traverseASTPostorder(node->while_data.while_body, callback, context);
-            break;
-        case NODE_WHILE_COND:   
-            traverseASTPostorder(node->while_cond_data.cond, callback, context);
-            break;
-
-        case NODE_WHILE_BODY:   
-            traverseASTPostorder(node->while_body_data.body, callback, context);
-            break;            
-
-        case NODE_FOR:
-            traverseASTPostorder(node->for_data.init, callback, context);
-            traverseASTPostorder(node->for_data.condition, callback, context);
-            traverseASTPostorder(node->for_data.updation, callback, context);
-            traverseASTPostorder(node->for_data.body, callback, context);
-            break;
-
-        case NODE_FOR_INIT:
-            traverseASTPostorder(node->for_init_data.init, callback, context);            
-            break;
-
-        case NODE_FOR_COND:
-            traverseASTPostorder(node->for_cond_data.cond, callback, context); 
-            break;
+    *count = 0;
+    for (int i = 0; i < AST_MAX_CHILDREN; i++) {
+        if (all[i]) buffer[(*count)++] = all[i];
+    }
+    return buffer;
+}
 
-        case NODE_FOR_UPDATION:
-            traverseASTPostorder(node->for_updation_data.updation, callback, context); 
-            break;
+// Explicit stack shared by every walk in this file, so list chains thousands
+// of nodes long do not turn into as many C stack frames. Walks can nest (a
+// callback may start another one), each walk only pops what it pushed.
+typedef struct ASTWalkFrame {
+    ASTNode* node;
+    int data;       // Walk specific: indent for printAST, parent id for the JSON export
+    bool flag;      // Walk specific: children pushed for walkAST, last child for printAST
+} ASTWalkFrame;
 
-        case NODE_FOR_BODY:
-            traverseASTPostorder(node->for_body_data.body, callback, context); 
-            break;
+#define AST_WALK_INITIAL_CAPACITY 256
 
-        case NODE_EXPR_COMMA_LIST:
-            traverseASTPostorder(node->expr_comma_list_data.expr_comma_list, callback, context);
-            traverseASTPostorder(node->expr_comma_list_data.expr_comma_list_item, callback, context);
-            break;
-        case NODE_FUNC_DECL:
-            traverseASTPostorder(node->func_decl_data.id, callback, context);
-            traverseASTPostorder(node->func_decl_data.params, callback, context);
-            traverseASTPostorder(node->func_decl_data.body, callback, context);
-            break;
+static ASTWalkFrame* walkFrames = NULL;
+static int walkTop = 0;
+static int walkCapacity = 0;
 
-        case NODE_FUNC_BODY:
-            traverseASTPostorder(node->func_body_data.body, callback, context);
-            break;
+static void pushWalkFrame(ASTNode* node, int data, bool flag) {
+    if (!node) return;
+    if (walkTop == walkCapacity) {
+        walkCapacity = walkCapacity ? walkCapacity * 2 : AST_WALK_INITIAL_CAPACITY;
+        walkFrames = realloc(walkFrames, sizeof(ASTWalkFrame) * walkCapacity);
+        if (!walkFrames) {
+            fprintf(stderr, "Memory allocation error\n");
+            exit(1);
+        }
+    }
+    walkFrames[walkTop].node = node;
+    walkFrames[walkTop].data = data;
+    walkFrames[walkTop].flag = flag;
+    walkTop++;
+}
 
-        case NODE_FUNC_CALL:
-            traverseASTPostorder(node->func_call_data.id, callback, context);
-            traverseASTPostorder(node->func_call_data.arg_list, callback, context);
-            break;
+static void freeWalkStack(void) {
+    free(walkFrames);
+    walkFrames = NULL;
+    walkTop = walkCapacity = 0;
+}
 
-        case NODE_PARAM_LIST:
-            traverseASTPostorder(node->param_list_data.param_list, callback, context);
-            traverseASTPostorder(node->param_list_data.param, callback, context);
-            break;
+void walkAST(ASTNode* node, ASTTraversalCallback pre, ASTTraversalCallback post, void* context, ASTTraversalVisitHook visit_hook, void* visit_context) {
+    int base = walkTop;
+    pushWalkFrame(node, 0, false);
 
-        case NODE_PARAM:
-            traverseASTPostorder(node->param_data.type_spec, callback, context);
-            traverseASTPostorder(node->param_data.id, callback, context);
-            break;
+    while (walkTop > base) {
+        // Copied out, a nested walk may move the frames
+        ASTWalkFrame frame = walkFrames[walkTop - 1];
 
-        case NODE_ARG_LIST:
-            traverseASTPostorder(node->arg_list_data.arg, callback, context);
-            traverseASTPostorder(node->arg_list_data.arg_list, callback, context);
-            break;
+        if (frame.flag) {
+            // Children done
+            walkTop--;
+            post(frame.node, context);
+            continue;
+        }
+        if (post) {
+            walkFrames[walkTop - 1].flag = true;
+        } else {
+            walkTop--;
+        }
 
-        case NODE_ARG:
-            traverseASTPostorder(node->arg_data.arg, callback, context);
-            break;
+        if (visit_hook) {
+            visit_hook(frame.node, visit_context);
+        }
+        if (pre && pre(frame.node, context) == 0) {
+            // STOP TRAVERSAL of this subtree
+            continue;
+        }
 
-        default:
-            break;
+        ASTRef buffer[AST_MAX_CHILDREN];
+        int count;
+        ASTRef* children = getASTChildren(frame.node, buffer, &count);
+        for (int i = count - 1; i >= 0; i--) {
+            pushWalkFrame(astNode(children[i]), 0, false);
+        }
     }
+}
 
-      // Call the callback function for the current node
-    if(callback(node, context) == 0){
-        // STOP TRAVERSAL
-        return;
-    }
+void traverseAST(ASTNode* node, ASTTraversalCallback callback, void* context, ASTTraversalVisitHook visit_hook, void* visit_context) {
+    walkAST(node, callback, NULL, context, visit_hook, visit_context);
 }
 
+void traverseASTPostorder(ASTNode* node, ASTTraversalCallback callback, void* context) {
+    walkAST(node, NULL, callback, context, NULL, NULL);
+}
 
 
-// Function to print the AST recursively
-void printAST(ASTNode* node, int indent, bool isLast) {
-    if (node == NULL) return;
+
+typedef struct PrintChild {
+    ASTNode* node;
+    bool isLast;
+} PrintChild;
+
+// Prints one line of the tree and returns the children to print below it,
+// list items are left to the caller
+static int printASTNode(ASTNode* node, int indent, bool isLast, PrintChild children[AST_MAX_CHILDREN]) {
+    int count = 0;
 
     // Print indentation, vertical lines, and dashes
     for (int i = 0; i < indent - 1; i++) {
@@ -545,12 +515,12 @@ void printAST(ASTNode* node, int indent, bool isLast) {
     switch (node->type) {
         case NODE_PROGRAM:
             printf("PROGRAM\n");
-            printAST(node->program_data.stmt_list, indent + 1, true);
+            children[count++] = (PrintChild){astNode(node->program_data.stmt_list), true};
             break;
 
         case NODE_RETURN:
             printf("RETURN\n");
-            printAST(node->return_data.return_value, indent + 1, true); // Recursively print the return value
+            children[count++] = (PrintChild){astNode(node->return_data.return_value), true};
             break;
 
         case NODE_BREAK_STMT:
@@ -575,40 +545,36 @@ void printAST(ASTNode* node, int indent, bool isLast) {
 
         case NODE_STMT_LIST:
             printf("STMT LIST\n");
-            printAST(node->stmt_list_data.stmt, indent + 1, true);      // Print the individual statement
-            printAST(node->stmt_list_data.stmt_list, indent + 1, false); // Print the statement list
             break;
 
         case NODE_STMT:
             printf("STMT\n");
-            printAST(node->stmt_data.stmt, indent + 1, true);          // Recursively print the statement
+            children[count++] = (PrintChild){astNode(node->stmt_data.stmt), true};
             break;
 
         case NODE_BLOCK_STMT:
             printf("BLOCK STMT\n");
-            printAST(node->block_stmt_data.stmt_list, indent + 1, true);
+            children[count++] = (PrintChild){astNode(node->block_stmt_data.stmt_list), true};
             break;
 
         case NODE_DECL:
             printf("DECL\n");
-            printAST(node->decl_data.var_list, indent + 1, false);
-            printAST(node->decl_data.type_spec, indent + 1, true);
+            children[count++] = (PrintChild){astNode(node->decl_data.var_list), false};
+            children[count++] = (PrintChild){astNode(node->decl_data.type_spec), true};
             break;
 
         case NODE_TYPE_SPEC:
-            printf("TYPE_SPEC (type: %s)\n", node->type_data.type);
+            printf("TYPE_SPEC (type: %s)\n", getTypeName(node->type_data.type));
             break;
 
         case NODE_VAR_LIST:
             printf("VAR_LIST\n");
-            printAST(node->var_list_data.var, indent + 1, false);
-            printAST(node->var_list_data.var_list, indent + 1, false);
             break;
 
         case NODE_VAR:
             printf("VAR\n");
-            printAST(node->var_data.value, indent + 1, false);
-            printAST(node->var_data.id, indent + 1, true);
+            children[count++] = (PrintChild){astNode(node->var_data.value), false};
+            children[count++] = (PrintChild){astNode(node->var_data.id), true};
             break;
 
         case NODE_ID:
@@ -616,181 +582,179 @@ void printAST(ASTNode* node, int indent, bool isLast) {
             break;
 
         case NODE_ID_REF:
-            printf("ID REF (name: %s)\n", node->id_ref_data.name);
+            printf("ID REF (name: %s, depth: %d, slot: %d)\n", node->id_ref_data.name, node->id_ref_data.depth, node->id_ref_data.slot);
             break;
 
         case NODE_ASSGN:
             printf("ASSGN\n");
-            printAST(node->assgn_data.right, indent+1, true);
-            printAST(node->assgn_data.left, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->assgn_data.right), true};
+            children[count++] = (PrintChild){astNode(node->assgn_data.left), true};
             break;
 
         case NODE_EXPR_BINARY:
-            printf("EXPR (op: %s)\n", node->expr_data.op);
-            printAST(node->expr_data.right, indent + 1, true);
-            printAST(node->expr_data.left, indent + 1, false);
+            printf("EXPR (op: %s)\n", getOperatorName(node->expr_data.op));
+            children[count++] = (PrintChild){astNode(node->expr_data.right), true};
+            children[count++] = (PrintChild){astNode(node->expr_data.left), false};
             break;
 
         case NODE_EXPR_UNARY:
-            printf("EXPR (op: %s)\n", node->expr_data.op);
-            printAST(node->expr_data.left, indent + 1, true);
+            printf("EXPR (op: %s)\n", getOperatorName(node->expr_data.op));
+            children[count++] = (PrintChild){astNode(node->expr_data.left), true};
             break;
 
         case NODE_EXPR_TERM:
             printf("EXPR (term)\n");
-            printAST(node->expr_data.left, indent + 1, true);
+            children[count++] = (PrintChild){astNode(node->expr_data.left), true};
             break;
 
         case NODE_IF:
             printf("IF\n");
-            printAST(node->if_else_data.if_branch, indent+1, true);
-            printAST(node->if_else_data.condition, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->if_else_data.if_branch), true};
+            children[count++] = (PrintChild){astNode(node->if_else_data.condition), true};
             break;
 
         case NODE_IF_ELSE:
             printf("IF ELSE\n");
-            printAST(node->if_else_data.else_branch, indent+1, true);
-            printAST(node->if_else_data.if_branch, indent+1, true);
-            printAST(node->if_else_data.condition, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->if_else_data.else_branch), true};
+            children[count++] = (PrintChild){astNode(node->if_else_data.if_branch), true};
+            children[count++] = (PrintChild){astNode(node->if_else_data.condition), true};
             break;
         
         case NODE_IF_COND:
             printf("IF COND\n");
-            printAST(node->if_cond_data.cond, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->if_cond_data.cond), true};
             break;
 
         case NODE_IF_BRANCH:
             printf("IF BRANCH\n");
-            printAST(node->if_else_branch.branch, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->if_else_branch.branch), true};
             break;
 
         case NODE_ELSE_BRANCH:
             printf("ELSE BRANCH\n");
-            printAST(node->if_else_branch.branch, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->if_else_branch.branch), true};
             break;
 
         case NODE_WHILE:
             printf("WHILE\n");
-            printAST(node->while_data.while_body, indent+1, true);
-            printAST(node->while_data.condition, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->while_data.while_body), true};
+            children[count++] = (PrintChild){astNode(node->while_data.condition), true};
             break;
 
         case NODE_WHILE_COND:   
             printf("WHILE COND\n");
-            printAST(node->while_cond_data.cond, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->while_cond_data.cond), true};
             break;
 
         case NODE_WHILE_BODY:   
             printf("WHILE BODY\n");
-            printAST(node->while_body_data.body, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->while_body_data.body), true};
             break;
 
         case NODE_FOR:
             printf("FOR\n");
-            printAST(node->for_data.body, indent+1, true);
-            printAST(node->for_data.updation, indent+1, true);
-            printAST(node->for_data.condition, indent+1, true);
-            printAST(node->for_data.init, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->for_data.body), true};
+            children[count++] = (PrintChild){astNode(node->for_data.updation), true};
+            children[count++] = (PrintChild){astNode(node->for_data.condition), true};
+            children[count++] = (PrintChild){astNode(node->for_data.init), true};
             break;
 
         case NODE_FOR_INIT:
             printf("FOR_INIT\n");
-            printAST(node->for_init_data.init, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->for_init_data.init), true};
             break;
 
         case NODE_FOR_COND:
             printf("FOR_COND\n");
-            printAST(node->for_cond_data.cond, indent+1, true); 
+            children[count++] = (PrintChild){astNode(node->for_cond_data.cond), true}; 
             break;
 
         case NODE_FOR_UPDATION:
             printf("FOR_UPDATION\n");
-            printAST(node->for_updation_data.updation, indent+1, true); 
+            children[count++] = (PrintChild){astNode(node->for_updation_data.updation), true}; 
             break;
 
         case NODE_FOR_BODY:
             printf("FOR_BODY\n");
-            printAST(node->for_body_data.body, indent+1, true); 
+            children[count++] = (PrintChild){astNode(node->for_body_data.body), true}; 
             break; 
 
         case NODE_EXPR_COMMA_LIST:
             printf("EXPR COMMA LIST\n");
-            printAST(node->expr_comma_list_data.expr_comma_list_item, indent+1, true);
-            printAST(node->expr_comma_list_data.expr_comma_list, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->expr_comma_list_data.expr_comma_list_item), true};
+            children[count++] = (PrintChild){astNode(node->expr_comma_list_data.expr_comma_list), true};
             break;
 
         case NODE_FUNC_DECL:
             printf("FUNC DECL (type: %s, name: %s, params: %d)\n",
-            node->func_decl_data.id->id_data.sym->type, 
-            node->func_decl_data.id->id_data.sym->name,
+            getTypeName(astNode(node->func_decl_data.id)->id_data.sym->type), 
+            astNode(node->func_decl_data.id)->id_data.sym->name,
             node->func_decl_data.param_count);
 
-            printAST(node->func_decl_data.body, indent+1, true);
-            printAST(node->func_decl_data.params, indent+1, true);
-            printAST(node->func_decl_data.id, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->func_decl_data.body), true};
+            children[count++] = (PrintChild){astNode(node->func_decl_data.params), true};
+            children[count++] = (PrintChild){astNode(node->func_decl_data.id), true};
             break;
 
         case NODE_FUNC_BODY:
             printf("FUNC BODY\n");
-            printAST(node->func_body_data.body, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->func_body_data.body), true};
             break;
 
         case NODE_PARAM_LIST:
             printf("PARAM LIST\n");
-            printAST(node->param_list_data.param, indent+1, true);
-            printAST(node->param_list_data.param_list, indent+1, true);
             break;
 
         case NODE_PARAM:
-            printf("PARAM (type: %s)\n", node->param_data.type_spec->type_data.type);
-            printAST(node->param_data.id, indent+1, true);
-            printAST(node->param_data.type_spec, indent+1, true);
+            printf("PARAM (type: %s)\n", getTypeName(astNode(node->param_data.type_spec)->type_data.type));
+            children[count++] = (PrintChild){astNode(node->param_data.id), true};
+            children[count++] = (PrintChild){astNode(node->param_data.type_spec), true};
             break;
 
         case NODE_FUNC_CALL:
             printf("FUNC CALL (name: %s, arg_count: %d)\n", 
-            node->func_call_data.id->id_ref_data.name,
+            astNode(node->func_call_data.id)->id_ref_data.name,
             node->func_call_data.arg_count);
-            printAST(node->func_call_data.arg_list, indent+1, false);
-            printAST(node->func_call_data.id, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->func_call_data.arg_list), false};
+            children[count++] = (PrintChild){astNode(node->func_call_data.id), true};
             break;
 
         case NODE_ARG_LIST:
             printf("ARG_LIST\n");
-            printAST(node->arg_list_data.arg, indent+1, false);
-            printAST(node->arg_list_data.arg_list, indent+1, true);
             break;
 
         case NODE_ARG:
             printf("ARG\n");
-            printAST(node->arg_data.arg, indent+1, true);
+            children[count++] = (PrintChild){astNode(node->arg_data.arg), true};
             break;
 
         default:
             printf("Unknown Node Type\n");
     }
-}
-
-int freeASTCallback(ASTNode* node, void* context) {
-    if (node == NULL) return 0;
-
-    if(isASTDebugOn) printf("Freeing %s\n", getNodeName(node->type));
-
-    (*(int*)context)++;
-    // Free any dynamically allocated data within the node if necessary
-    // e.g., freeing identifiers, literals, or other node-specific data
-
 
-    // Free the node itself
-    free(node);
-
-    return 1; // Continue traversal
+    return count;
 }
 
-void freeAST(ASTNode* node) {
-   int cnt = 0;
-   traverseASTPostorder(node, freeASTCallback, &cnt);
-   printf("Freed %d nodes\n", cnt);
+// Function to print the AST
+void printAST(ASTNode* node, int indent, bool isLast) {
+    int base = walkTop;
+    pushWalkFrame(node, indent, isLast);
+
+    while (walkTop > base) {
+        ASTWalkFrame frame = walkFrames[--walkTop];
+        PrintChild children[AST_MAX_CHILDREN];
+        int count = printASTNode(frame.node, frame.data, frame.flag, children);
+        if (isASTListNode(frame.node)) {
+            ASTRef* items = frame.node->list_data.items;
+            for (int i = frame.node->list_data.count - 1; i >= 0; i--) {
+                pushWalkFrame(astNode(items[i]), frame.data + 1, i == frame.node->list_data.count - 1);
+            }
+            continue;
+        }
+        for (int i = count - 1; i >= 0; i--) {
+            pushWalkFrame(children[i].node, frame.data + 1, children[i].isLast);
+        }
+    }
 }
 
 int nodeCounter = 0;  // Unique ID counter for each node
@@ -804,21 +768,18 @@ int generateNodeID() {
 
 
 
-#define INITIAL_EDGE_BUFFER_SIZE 1024
-
-// Helper function to export AST node as JSON
-void exportASTNodeAsJSON(FILE *file, ASTNode *node, int parentID, int *edgeBufferSize, char **edgeBuffer, int isFirstNode) {
-    if (!node) return;
-    int currentID;
-    if (!node->visited) {
-        currentID = generateNodeID();
-        node->export_id = currentID;
-        node->visited = true;
+// Writes a node the first time it is reached and gives it its export id
+static void exportASTNode(FILE *file, ASTNode *node, bool *isFirstNode) {
+    if (astArena.export_ids[node->node_id] < 0) {
+        int currentID = generateNodeID();
+        astArena.export_ids[node->node_id] = currentID;
+        SourceSpan* span = nodeSpan(node);
         // Add current node, ensuring proper formatting (comma-separated) based on whether it's the first node or not
-        if (!isFirstNode) {
+        if (!*isFirstNode) {
             fprintf(file, ", ");
         }
-        fprintf(file, "{ \"id\": %d, \"node_id\": %d, \"line_no\": %d, \"char_no\": %d, \"start_line_no\": %d, \"start_char_no\": %d, \"end_line_no\": %d, \"end_char_no\": %d,  \"label\": \"", currentID, node->node_id, node->line_no, node->char_no, node->start_line_no, node->start_char_no, node->end_line_no, node->end_char_no);
+        *isFirstNode = false;
+        fprintf(file, "{ \"id\": %d, \"node_id\": %d, \"line_no\": %d, \"char_no\": %d, \"start_line_no\": %d, \"start_char_no\": %d, \"end_line_no\": %d, \"end_char_no\": %d,  \"label\": \"", currentID, node->node_id, span->start_line, span->start_col, span->start_line, span->start_col, span->end_line, span->end_col);
 
         // Handle different node types
         switch (node->type) {
@@ -826,18 +787,18 @@ void exportASTNodeAsJSON(FILE *file, ASTNode *node, int parentID, int *edgeBuffe
                 fprintf(file, "PROGRAM\" }");
                 break;
             case NODE_BREAK_STMT:{
-                char* status = node->break_continue_stmt_data.associated_loop_node != NULL ? "Assigned" : "Unassigned";
+                char* status = node->break_continue_stmt_data.associated_loop_node ? "Assigned" : "Unassigned";
                 fprintf(file, "BREAK\\n(%s)\" }", status);
                 break;
             }
             case NODE_CONTINUE_STMT:{
-                char* status = node->break_continue_stmt_data.associated_loop_node != NULL ? "Assigned" : "Unassigned";
+                char* status = node->break_continue_stmt_data.associated_loop_node ? "Assigned" : "Unassigned";
                 fprintf(file, "CONTINUE\\n(%s)\" }", status);
                 break;
             }
                 
             case NODE_RETURN:
-                fprintf(file, "RETURN\\n(type: %s)\" }", node->inferedType);
+                fprintf(file, "RETURN\\n(type: %s)\" }", getTypeName(node->inferedType));
                 break;
             case NODE_INT_LITERAL:
                 fprintf(file, "LITERAL\\n(int: %d)\" }", node->literal_data.value.int_value);
@@ -861,13 +822,13 @@ void exportASTNodeAsJSON(FILE *file, ASTNode *node, int parentID, int *edgeBuffe
                 fprintf(file, "DECL\" }");
                 break;
             case NODE_TYPE_SPEC:
-                fprintf(file, "TYPE_SPEC (%s)\" }", node->type_data.type);
+                fprintf(file, "TYPE_SPEC (%s)\" }", getTypeName(node->type_data.type));
                 break;
             case NODE_VAR_LIST:
                 fprintf(file, "VAR_LIST\" }");
                 break;
             case NODE_VAR:
-                fprintf(file, "VAR\\n(name: %s, valueType: %s)\" }", node->var_data.id->id_data.sym->name, node->inferedType);
+                fprintf(file, "VAR\\n(name: %s, valueType: %s)\" }", astNode(node->var_data.id)->id_data.sym->name, getTypeName(node->inferedType));
                 break;
             case NODE_ID:
                 fprintf(file, "ID\\n(name: %s)\" }", node->id_data.sym->name);
@@ -876,16 +837,16 @@ void exportASTNodeAsJSON(FILE *file, ASTNode *node, int parentID, int *edgeBuffe
                 fprintf(file, "ID_REF\\n(name: %s)\" }", node->id_ref_data.name);
                 break;
             case NODE_ASSGN:
-                fprintf(file, "ASSGN (type: %s)\" }", node->inferedType);
+                fprintf(file, "ASSGN (type: %s)\" }", getTypeName(node->inferedType));
                 break;
             case NODE_EXPR_BINARY:
-                fprintf(file, "EXPR\\n(binary: %s, type: %s)\" }", node->expr_data.op, node->inferedType);
+                fprintf(file, "EXPR\\n(binary: %s, type: %s)\" }", getOperatorName(node->expr_data.op), getTypeName(node->inferedType));
                 break;
             case NODE_EXPR_UNARY:
-                fprintf(file, "EXPR\\n(unary: %s, type: %s)\" }", node->expr_data.op, node->inferedType);
+                fprintf(file, "EXPR\\n(unary: %s, type: %s)\" }", getOperatorName(node->expr_data.op), getTypeName(node->inferedType));
                 break;
             case NODE_EXPR_TERM:
-                fprintf(file, "EXPR\\n(term, type: %s)\" }", node->inferedType);
+                fprintf(file, "EXPR\\n(term, type: %s)\" }", getTypeName(node->inferedType));
                 break;
             case NODE_IF:
                 fprintf(file, "IF\" }");
@@ -930,7 +891,7 @@ void exportASTNodeAsJSON(FILE *file, ASTNode *node, int parentID, int *edgeBuffe
                 fprintf(file, "FOR_BODY\" }");
                 break;
             case NODE_FUNC_DECL:
-                fprintf(file, "FUNC_DECL\\n(name: %s, param_cnt: %d)\" }", node->func_decl_data.id->id_data.sym->name, node->func_decl_data.param_count);
+                fprintf(file, "FUNC_DECL\\n(name: %s, param_cnt: %d)\" }", astNode(node->func_decl_data.id)->id_data.sym->name, node->func_decl_data.param_count);
                 break;
             case NODE_FUNC_BODY:
                 fprintf(file, "FUNC_BODY\" }");
@@ -939,10 +900,10 @@ void exportASTNodeAsJSON(FILE *file, ASTNode *node, int parentID, int *edgeBuffe
                 fprintf(file, "PARAM_LIST\" }");
                 break;
             case NODE_PARAM:
-                fprintf(file, "PARAM\\n(type: %s)\" }", node->param_data.type_spec->type_data.type);
+                fprintf(file, "PARAM\\n(type: %s)\" }", getTypeName(astNode(node->param_data.type_spec)->type_data.type));
                 break;
             case NODE_FUNC_CALL:
-                fprintf(file, "FUNC_CALL\\n(name: %s, arg_cnt: %d)\" }", node->func_call_data.id->id_ref_data.name, node->func_call_data.arg_count);
+                fprintf(file, "FUNC_CALL\\n(name: %s, arg_cnt: %d)\" }", astNode(node->func_call_data.id)->id_ref_data.name, node->func_call_data.arg_count);
                 break;
             case NODE_ARG_LIST:
                 fprintf(file, "ARG_LIST\" }");
@@ -954,160 +915,50 @@ void exportASTNodeAsJSON(FILE *file, ASTNode *node, int parentID, int *edgeBuffe
                 fprintf(file, "UNKNOWN\" }");
                 break;
         }
-    } else {
-        currentID = node->export_id;
-    }
-
-    // Store edge in the buffer if there's a parent
-    if (parentID != -1) {
-        // Resize buffer if needed
-        if (*edgeBufferSize <= 0) {
-            *edgeBufferSize = INITIAL_EDGE_BUFFER_SIZE;
-            *edgeBuffer = malloc(*edgeBufferSize);
-            (*edgeBuffer)[0] = '\0'; // Initialize the buffer
-        }
-
-        // Prepare the edge representation
-        char edge[64]; // Temporary buffer for the edge
-        snprintf(edge, sizeof(edge), "{ \"from\": %d, \"to\": %d }, ", parentID, currentID);
-
-        // Check if the buffer needs to be resized
-        if (strlen(*edgeBuffer) + strlen(edge) >= *edgeBufferSize) {
-            *edgeBufferSize *= 2; // Double the size
-            *edgeBuffer = realloc(*edgeBuffer, *edgeBufferSize);
-        }
-
-        strcat(*edgeBuffer, edge);
     }
+}
 
-    // Recurse for child nodes
-    switch (node->type) {
-        case NODE_PROGRAM:
-            exportASTNodeAsJSON(file, node->program_data.stmt_list, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_RETURN:
-            exportASTNodeAsJSON(file, node->return_data.return_value, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        
-        case NODE_STMT_LIST:
-            exportASTNodeAsJSON(file, node->stmt_list_data.stmt_list, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->stmt_list_data.stmt, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_DECL:
-            exportASTNodeAsJSON(file, node->decl_data.type_spec, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->decl_data.var_list, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_VAR_LIST:
-            exportASTNodeAsJSON(file, node->var_list_data.var_list, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->var_list_data.var, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_VAR:
-            exportASTNodeAsJSON(file, node->var_data.id, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->var_data.value, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_ASSGN:
-            exportASTNodeAsJSON(file, node->assgn_data.left, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->assgn_data.right, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_EXPR_BINARY:
-            exportASTNodeAsJSON(file, node->expr_data.left, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->expr_data.right, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_EXPR_UNARY:
-            exportASTNodeAsJSON(file, node->expr_data.left, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-
-        case NODE_EXPR_TERM:
-            exportASTNodeAsJSON(file, node->expr_data.left, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        
-        case NODE_IF:
-            exportASTNodeAsJSON(file, node->if_else_data.condition, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->if_else_data.if_branch, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_IF_ELSE:
-            exportASTNodeAsJSON(file, node->if_else_data.condition, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->if_else_data.if_branch, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->if_else_data.else_branch, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_IF_COND:
-            exportASTNodeAsJSON(file, node->if_cond_data.cond, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;        
-        case NODE_IF_BRANCH:
-            exportASTNodeAsJSON(file, node->if_else_branch.branch, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;        
-        case NODE_ELSE_BRANCH:
-            exportASTNodeAsJSON(file, node->if_else_branch.branch, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;        
-        
+// Children in the order the export lists them: as traverseAST, except that
+// parameter types are included
+static ASTRef* getExportChildren(ASTNode* node, ASTRef buffer[AST_MAX_CHILDREN], int* count) {
+    if (node->type != NODE_PARAM) return getASTChildren(node, buffer, count);
 
+    *count = 0;
+    if (node->param_data.type_spec) buffer[(*count)++] = node->param_data.type_spec;
+    if (node->param_data.id) buffer[(*count)++] = node->param_data.id;
+    return buffer;
+}
 
-        case NODE_WHILE:
-            exportASTNodeAsJSON(file, node->while_data.condition, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->while_data.while_body, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_WHILE_COND:
-            exportASTNodeAsJSON(file, node->while_cond_data.cond, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_WHILE_BODY:
-            exportASTNodeAsJSON(file, node->while_body_data.body, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
+// The export walks the tree twice, writing the nodes on the first walk and
+// the edges between them on the second, so neither is held in memory
+typedef enum ExportPass {
+    EXPORT_NODES,
+    EXPORT_EDGES
+} ExportPass;
 
-        case NODE_FOR:
-            exportASTNodeAsJSON(file, node->for_data.init, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->for_data.condition, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->for_data.updation, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->for_data.body, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_FOR_INIT:
-            exportASTNodeAsJSON(file, node->for_init_data.init, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_FOR_COND:
-            exportASTNodeAsJSON(file, node->for_cond_data.cond, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_EXPR_COMMA_LIST:
-            exportASTNodeAsJSON(file, node->expr_comma_list_data.expr_comma_list, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->expr_comma_list_data.expr_comma_list_item, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;            
-        case NODE_FOR_UPDATION:
-            exportASTNodeAsJSON(file, node->for_updation_data.updation, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_FOR_BODY:
-            exportASTNodeAsJSON(file, node->for_body_data.body, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
+// Helper function to export AST node as JSON
+static void exportASTNodeAsJSON(FILE *file, ASTNode *node, ExportPass pass, bool *isFirst) {
+    int base = walkTop;
+    pushWalkFrame(node, -1, false);
+
+    while (walkTop > base) {
+        ASTWalkFrame frame = walkFrames[--walkTop];
+        int parentID = frame.data;
+        if (pass == EXPORT_NODES) {
+            exportASTNode(file, frame.node, isFirst);
+        } else if (parentID != -1) {
+            if (!*isFirst) fprintf(file, ", ");
+            *isFirst = false;
+            fprintf(file, "{ \"from\": %d, \"to\": %d }", parentID, astArena.export_ids[frame.node->node_id]);
+        }
+        int currentID = astArena.export_ids[frame.node->node_id];
 
-        case NODE_FUNC_DECL:
-            exportASTNodeAsJSON(file, node->func_decl_data.id, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->func_decl_data.params, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->func_decl_data.body, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_FUNC_BODY:
-            exportASTNodeAsJSON(file, node->func_body_data.body, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_BLOCK_STMT:
-            exportASTNodeAsJSON(file, node->block_stmt_data.stmt_list, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_PARAM_LIST:
-            exportASTNodeAsJSON(file, node->param_list_data.param_list, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->param_list_data.param, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_PARAM:
-            exportASTNodeAsJSON(file, node->param_data.type_spec, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->param_data.id, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_FUNC_CALL:
-            exportASTNodeAsJSON(file, node->func_call_data.id, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->func_call_data.arg_list, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_ARG_LIST:
-            exportASTNodeAsJSON(file, node->arg_list_data.arg_list, currentID, edgeBufferSize, edgeBuffer, 0);
-            exportASTNodeAsJSON(file, node->arg_list_data.arg, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        case NODE_ARG:
-            exportASTNodeAsJSON(file, node->arg_data.arg, currentID, edgeBufferSize, edgeBuffer, 0);
-            break;
-        default:
-            break;
+        ASTRef buffer[AST_MAX_CHILDREN];
+        int count;
+        ASTRef* children = getExportChildren(frame.node, buffer, &count);
+        for (int i = count - 1; i >= 0; i--) {
+            pushWalkFrame(astNode(children[i]), currentID, false);
+        }
     }
 }
 
@@ -1139,31 +990,27 @@ void exportASTAsJSON(const char *folderPath, ASTNode *root) {
     createDirectory(folderPath);
 
     FILE *file = fopen(filePath, "w");
-    
-    
-
-    fprintf(file, "{ \"nodes\": [");
-    
-    int edgeBufferSize = 0;
-    char *edgeBuffer = NULL;
-    
-    if (root) {
-        exportASTNodeAsJSON(file, root, -1, &edgeBufferSize, &edgeBuffer, 1); // isFirstNode flag set to 1 for the root node
-    } else {
-        int firstNodeFlag = 1; // Flag to track the first node for proper comma placement
-        for (int i = 0; i < astRegistry.count; i++) {
-            exportASTNodeAsJSON(file, astRegistry.nodes[i], -1, &edgeBufferSize, &edgeBuffer, firstNodeFlag); // isFirstNode flag set to 1 for the first node
-            firstNodeFlag = 0;
-        }
+    if (!file) {
+        printf("Error: Unable to open %s for writing.\n", filePath);
+        return;
     }
-    
 
-    // Clean up the edge buffer by removing the last comma and space
-    if (edgeBuffer && strlen(edgeBuffer) > 0) {
-        edgeBuffer[strlen(edgeBuffer) - 2] = '\0'; // Remove last ", "
+    for (ExportPass pass = EXPORT_NODES; pass <= EXPORT_EDGES; pass++) {
+        fputs(pass == EXPORT_NODES ? "{ \"nodes\": [" : "], \"edges\": [", file);
+        bool isFirst = true;
+        if (root) {
+            exportASTNodeAsJSON(file, root, pass, &isFirst);
+        } else {
+            for (int b = 0; b < astArena.block_count; b++) {
+                ASTArenaBlock* block = astArena.blocks[b];
+                for (int i = 0; i < block->used; i++) {
+                    exportASTNodeAsJSON(file, &block->nodes[i], pass, &isFirst);
+                }
+            }
+        }
     }
-
-    fprintf(file, "], \"edges\": [%s]}", edgeBuffer ? edgeBuffer : ""); // Insert the collected edges here
+    fprintf(file, "]}");
+    fclose(file);
 
     // Generate the index.html file
     snprintf(filePath, sizeof(filePath), "%s/index.html", folderPath);
@@ -1223,9 +1070,5 @@ void exportASTAsJSON(const char *folderPath, ASTNode *root) {
         printf("Error: Unable to open index.html for writing.\n");
     }
 
-    // Free the edge buffer if it was allocated
-    free(edgeBuffer);
-    fclose(htmlFile);
-    fclose(file);
     printf("Exported AST with %d nodes to %s/ast.json\n", nodeCounter, folderPath);
 }
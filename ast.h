@@ -2,7 +2,9 @@
 #define AST_H
 
 #include "symTable.h"
+#include "types.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include <errno.h>
@@ -69,6 +71,31 @@ typedef enum NodeType {
 } NodeType;
 
 const char* getNodeName(NodeType type); 
+
+// Operator of an EXPR_BINARY or EXPR_UNARY node
+typedef enum Operator {
+    OP_NONE = 0,
+    OP_ADD,
+    OP_SUB,         // Binary minus or unary negation
+    OP_MUL,
+    OP_DIV,
+    OP_EQ,
+    OP_NEQ,
+    OP_LT,
+    OP_GT,
+    OP_LEQ,
+    OP_GEQ,
+    OP_AND,
+    OP_OR,
+    OP_NOT,
+    OP_PRE_INC,
+    OP_PRE_DEC,
+    OP_POST_INC,
+    OP_POST_DEC,
+    OPERATOR_COUNT
+} Operator;
+
+const char* getOperatorName(Operator op);
 void setASTDebugger();
 
 typedef struct SourceSpan {
@@ -78,21 +105,20 @@ typedef struct SourceSpan {
     int end_col;
 } SourceSpan;
 
+// Children are linked by arena index rather than pointer, node_id + 1 so
+// that 0 means no child. astNode() and astRef() convert between the two.
+typedef uint32_t ASTRef;
+
+// Only what the passes read on every visit lives in the node, source spans
+// and export ids sit in the arena's arrays indexed by node_id
 typedef struct ASTNode {
     NodeType type;  // Type of the node (enum to identify node type)
-    int node_id;
-    int line_no, char_no;
-    int start_line_no, start_char_no;
-    int end_line_no, end_char_no;
-    int export_id;
-    SymbolTable* scope;
-    bool visited; // For traversal purposes
-
-    const char* inferedType;
+    int node_id;    // Creation order, also the node's index in the arena arrays
+    TypeId inferedType;
     union {
 
         struct {
-          struct ASTNode* stmt_list;
+          ASTRef stmt_list;
           SymbolTable* scope;
         } program_data;
 
@@ -102,42 +128,32 @@ typedef struct ASTNode {
         // Function decl node data
         struct {
             int global_id;                // Global function id
-            struct ASTNode* id;           // Function identifier
-            struct ASTNode* params;       // Root of the parameter list binary tree
-            struct ASTNode* body;         // Function body (block of statements)
             int param_count;              // Number of parameters
+            ASTRef id;                    // Function identifier
+            ASTRef params;                // PARAM_LIST node, 0 without parameters
+            ASTRef body;                  // Function body (block of statements)
             SymbolTable* scope;
         } func_decl_data;
         
         struct {
-            struct ASTNode* body;
+            ASTRef body;
         } func_body_data;
 
         struct {
-            struct ASTNode* param_list;
-            struct ASTNode* param;
-        } param_list_data;
-
-        struct {
-            struct ASTNode* type_spec;
-            struct ASTNode* id;
+            ASTRef type_spec;
+            ASTRef id;
         } param_data;
 
 
         // Function call node data
         struct {
-            ASTNode* id;
-            ASTNode* arg_list;
+            ASTRef id;
+            ASTRef arg_list;
             int arg_count;                 // Number of arguments
         } func_call_data;
 
         struct {
-            ASTNode* arg_list;
-            ASTNode* arg;
-        } arg_list_data;
-
-        struct {
-            ASTNode* arg;
+            ASTRef arg;
         } arg_data;
 
         // // Assignment node data
@@ -160,91 +176,86 @@ typedef struct ASTNode {
 
         // Binary operator node data (for operations like +, -, *, /, etc.)
         struct {
-            const char* op;               // Operator, e.g. "+", "-", "=="
-            struct ASTNode* left;         // Left operand
-            struct ASTNode* right;        // Right operand
+            Operator op;                  // OP_NONE for EXPR_TERM
+            ASTRef left;                  // Left operand
+            ASTRef right;                 // Right operand
         } expr_data;
 
         // If-Else node data (for conditional statements)
         struct {
-            struct ASTNode* condition;    // The condition expression
-            struct ASTNode* if_branch;    // Code to execute if condition is true
-            struct ASTNode* else_branch;  // Code to execute if condition is false (can be NULL)
+            ASTRef condition;             // The condition expression
+            ASTRef if_branch;             // Code to execute if condition is true
+            ASTRef else_branch;           // Code to execute if condition is false (can be 0)
         } if_else_data;
 
         struct {
-            struct ASTNode* cond;
+            ASTRef cond;
         } if_cond_data;
 
         struct {
-            struct ASTNode* branch;
+            ASTRef branch;
         } if_else_branch;
 
         // For loop node data
         struct {
-            struct ASTNode* init;         // Initialization statement
-            struct ASTNode* condition;    // Loop condition
-            struct ASTNode* updation;    // Increment statement
-            struct ASTNode* body;         // The body of the for loop
+            ASTRef init;                  // Initialization statement
+            ASTRef condition;             // Loop condition
+            ASTRef updation;             // Increment statement
+            ASTRef body;                  // The body of the for loop
         } for_data;
 
         struct{
-            struct ASTNode* init;
+            ASTRef init;
         } for_init_data;
 
         struct{
-            struct ASTNode* cond;
+            ASTRef cond;
         } for_cond_data;
 
         struct{
-            struct ASTNode* updation;
+            ASTRef updation;
         } for_updation_data;
 
         struct {
-            struct ASTNode* body;
+            ASTRef body;
         } for_body_data;
 
         // Expr Comma List
 
         struct {
-            struct ASTNode* expr_comma_list;
-            struct ASTNode* expr_comma_list_item;
+            ASTRef expr_comma_list;
+            ASTRef expr_comma_list_item;
         } expr_comma_list_data;
         
         // While loop node data
         struct {
-            struct ASTNode* condition;    // The condition expression
-            struct ASTNode* while_body; // The body of the while loop
+            ASTRef condition;             // The condition expression
+            ASTRef while_body;          // The body of the while loop
         } while_data;
 
         struct {
-            struct ASTNode* cond;
+            ASTRef cond;
         } while_cond_data;
 
         struct {
-            struct ASTNode* body;
+            ASTRef body;
         } while_body_data;
 
         // Declarations
 
         struct {
-            struct ASTNode* type_spec;
-            struct ASTNode* var_list;
+            ASTRef type_spec;
+            ASTRef var_list;
         } decl_data;
 
         struct{
-          struct ASTNode* var_list;
-          struct ASTNode* var;
-        } var_list_data;
-
-        struct{
-          struct ASTNode* id;
-          struct ASTNode* value;
+          ASTRef id;
+          ASTRef value;
         } var_data;
 
         
         struct{
-            const char* type;
+            TypeId type;
         } type_data;
 
         struct {
@@ -255,55 +266,87 @@ typedef struct ASTNode {
             const char *name;
             symbol* ref;
             SymbolTable* scope; // Usage's scope
-            int line_no;
-            int char_no;
+            // Lexical address for semantic analysis and --print-ast only. The back ends
+            // address storage by interned TAC name, see lowerName() in bytecode.c.
+            int depth;          // Parent hops from scope to the declaring scope, -1 until resolved
+            int slot;           // ref's position in the declaring scope, -1 until resolved
         } id_ref_data;
         
         struct {
-            struct ASTNode* left;
-            struct ASTNode* right;
+            ASTRef left;
+            ASTRef right;
         } assgn_data;
-        // Statements
+        // STMT_LIST, VAR_LIST, PARAM_LIST and ARG_LIST: children in source
+        // order, appended to while parsing
         struct {
-            struct ASTNode* stmt_list;
-            struct ASTNode* stmt;
-        } stmt_list_data;
+            ASTRef* items;
+            int count;
+            int capacity;
+        } list_data;
         
         struct {
-            struct ASTNode* stmt;
+            ASTRef stmt;
         } stmt_data;
 
         // Block statement (contains multiple statements)
         struct {
-            struct ASTNode* stmt_list;  // Array of statements (children)
+            ASTRef stmt_list;           // Array of statements (children)
         } block_stmt_data;
 
         
         // Return node data (for return statements in functions)
         struct {
-            struct ASTNode* return_value; // The expression being returned (can be NULL for "void" return)
-            struct ASTNode* associated_node; 
+            ASTRef return_value;          // The expression being returned (can be 0 for "void" return)
+            ASTRef associated_node;
         } return_data;
 
         struct {
-            struct ASTNode* associated_loop_node;
+            ASTRef associated_loop_node;
         } break_continue_stmt_data;
 
     };
 
 } ASTNode;
 
-typedef struct ASTRegistry {
-    ASTNode** nodes;
+// Nodes are bump allocated, in creation order, from fixed size blocks so that
+// a node_id maps straight to its block and slot. Released together by
+// freeASTArena()
+#define AST_ARENA_BLOCK_SHIFT 10
+#define AST_ARENA_BLOCK_SIZE  (1 << AST_ARENA_BLOCK_SHIFT)
+
+typedef struct ASTArenaBlock {
+    int used;
+    ASTNode nodes[AST_ARENA_BLOCK_SIZE];
+} ASTArenaBlock;
+
+typedef struct ASTArena {
+    ASTArenaBlock** blocks;
+    int block_count;
+    int block_capacity;
     int count;
-    int capacity;
-} ASTRegistry;
+    int info_capacity;
+    SourceSpan* spans;     // Per node_id
+    int* export_ids;       // Per node_id, -1 until exported
+} ASTArena;
+
+extern ASTArena astArena;
+
+static inline ASTNode* astNode(ASTRef ref) {
+    if (!ref) return NULL;
+    uint32_t id = ref - 1;
+    return &astArena.blocks[id >> AST_ARENA_BLOCK_SHIFT]->nodes[id & (AST_ARENA_BLOCK_SIZE - 1)];
+}
 
-extern ASTRegistry astRegistry;
+static inline ASTRef astRef(ASTNode* node) {
+    return node ? (ASTRef)node->node_id + 1 : 0;
+}
 
-void initASTRegistry(void);
-void registerASTNode(ASTNode* node);
-void freeASTRegistry(void);
+static inline SourceSpan* nodeSpan(ASTNode* node) {
+    return &astArena.spans[node->node_id];
+}
+
+void initASTArena(void);
+void freeASTArena(void);
 
 // Function prototypes for AST operations
 SourceSpan makeSourceSpan(int start_line, int start_col, int end_line, int end_col);
@@ -311,13 +354,25 @@ SourceSpan spanFromNode(ASTNode* node);
 void applySourceSpan(ASTNode* node, SourceSpan span);
 ASTNode* createASTNode(NodeType, SourceSpan span);
 void deriveRangeFromChildren(ASTNode* node, ASTNode* first_child, ASTNode* last_child);
+bool isASTListNode(ASTNode* node);
+void appendASTListItem(ASTNode* list, ASTNode* item);
 void printAST(ASTNode* node, int indent, bool isLast);
-void freeAST(ASTNode* node);
 void exportASTAsJSON(const char *folderPath, ASTNode *root);
 
 typedef int (*ASTTraversalCallback)(ASTNode* node, void* context);
 typedef void (*ASTTraversalVisitHook)(ASTNode* node, void* context);
+
+// Most children any node but a list has (NODE_FOR)
+#define AST_MAX_CHILDREN 4
+// Returns buffer, or a list node's own items, filled with count children
+ASTRef* getASTChildren(ASTNode* node, ASTRef buffer[AST_MAX_CHILDREN], int* count);
+
+// Walks the tree with an explicit heap stack instead of recursion. pre runs
+// before a node's children and skips them by returning 0, post runs after
+// them; either may be NULL. Callbacks may start walks of their own.
+void walkAST(ASTNode* node, ASTTraversalCallback pre, ASTTraversalCallback post, void* context, ASTTraversalVisitHook visit_hook, void* visit_context);
 void traverseAST(ASTNode* node, ASTTraversalCallback callback, void* context, ASTTraversalVisitHook visit_hook, void* visit_context);
+void traverseASTPostorder(ASTNode* node, ASTTraversalCallback callback, void* context);
 const char* getDataTypeFromAST(ASTNode* node);
 
 #endif // AST_H
@@ -0,0 +1,619 @@
+#include "bytecode.h"
+#include "intern.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_SLOT_CAPACITY 64
+
+// Per-name bookkeeping while lowering. TAC names and string operands are
+// interned, so both tables below are keyed by pointer.
+typedef struct SlotUse {
+    const char* name;
+    int owner;            // Function index whose code uses this name, -1 = unused
+    int shared;           // Used by more than one function
+    int declared_in;      // Function index of the declaration, 0 = top level, -1 = compiler generated
+    TypeId type;          // Declared type, TYPE_NONE for compiler generated names
+} SlotUse;
+
+typedef struct Lowering {
+    BytecodeProgram* program;
+
+    SlotUse* uses;
+    int use_count;
+    int use_capacity;
+    int* use_index;       // Open addressing table of use ids
+    int use_index_capacity;
+
+    int string_capacity;
+    const char** string_keys; // Interned operand of every program->strings entry
+    int* string_index;    // Open addressing table of program->strings positions
+    int string_index_capacity;
+
+    int* scope_function;  // Function index per symbol table id, UNRESOLVED_SCOPE until known
+} Lowering;
+
+#define UNRESOLVED_SCOPE -2
+
+static void* checkedAlloc(size_t size) {
+    void* ptr = calloc(1, size ? size : 1);
+    if (!ptr) {
+        fprintf(stderr, "Memory allocation failed for bytecode\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+static int findUse(Lowering* lw, const char* name) {
+    if (!lw->use_index_capacity) return -1;
+    unsigned int mask = lw->use_index_capacity - 1;
+    unsigned int pos = hashInterned(name) & mask;
+    while (lw->use_index[pos] != -1) {
+        if (lw->uses[lw->use_index[pos]].name == name) return lw->use_index[pos];
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+static void growUseIndex(Lowering* lw) {
+    int capacity = lw->use_index_capacity ? lw->use_index_capacity * 2 : INITIAL_SLOT_CAPACITY * 2;
+    int* index = malloc(sizeof(int) * capacity);
+    if (!index) {
+        fprintf(stderr, "Memory allocation failed for bytecode slot index\n");
+        exit(1);
+    }
+    for (int i = 0; i < capacity; i++) index[i] = -1;
+
+    for (int id = 0; id < lw->use_count; id++) {
+        unsigned int pos = hashInterned(lw->uses[id].name) & (capacity - 1);
+        while (index[pos] != -1) pos = (pos + 1) & (capacity - 1);
+        index[pos] = id;
+    }
+    free(lw->use_index);
+    lw->use_index = index;
+    lw->use_index_capacity = capacity;
+}
+
+// Returns the id for name, creating it on first use
+static int internUse(Lowering* lw, const char* name) {
+    int id = findUse(lw, name);
+    if (id != -1) return id;
+
+    if (lw->use_count == lw->use_capacity) {
+        lw->use_capacity = lw->use_capacity ? lw->use_capacity * 2 : INITIAL_SLOT_CAPACITY;
+        lw->uses = realloc(lw->uses, sizeof(SlotUse) * lw->use_capacity);
+        if (!lw->uses) {
+            fprintf(stderr, "Memory allocation failed for bytecode slots\n");
+            exit(1);
+        }
+    }
+    if ((lw->use_count + 1) * 2 > lw->use_index_capacity) growUseIndex(lw);
+
+    id = lw->use_count++;
+    lw->uses[id].name = name;
+    lw->uses[id].owner = -1;
+    lw->uses[id].shared = 0;
+    lw->uses[id].declared_in = -1;
+    lw->uses[id].type = TYPE_NONE;
+
+    unsigned int mask = lw->use_index_capacity - 1;
+    unsigned int pos = hashInterned(name) & mask;
+    while (lw->use_index[pos] != -1) pos = (pos + 1) & mask;
+    lw->use_index[pos] = id;
+    return id;
+}
+
+static void noteUse(Lowering* lw, const char* name, int owner) {
+    int id = internUse(lw, name);
+    if (lw->uses[id].owner == -1) {
+        lw->uses[id].owner = owner;
+    } else if (lw->uses[id].owner != owner) {
+        lw->uses[id].shared = 1;
+    }
+}
+
+// Function index of the innermost function enclosing scope, 0 for the top
+// level. Resolved scopes are recorded so each scope is walked once.
+static int scopeFunction(Lowering* lw, SymbolTable* scope) {
+    SymbolTable* known = scope;
+    while (known && lw->scope_function[known->table_id] == UNRESOLVED_SCOPE) known = known->parent;
+    int function = known ? lw->scope_function[known->table_id] : 0;
+    for (SymbolTable* cur = scope; cur != known; cur = cur->parent) {
+        lw->scope_function[cur->table_id] = function;
+    }
+    return function;
+}
+
+// Mark every user declared variable with the function it is declared in
+static void markDeclaration(Lowering* lw, ASTNode* node) {
+    if (node->type != NODE_ID || !node->id_data.sym) return;
+    symbol* sym = node->id_data.sym;
+    if (sym->is_function || !sym->scope) return;
+
+    int id = findUse(lw, getSymbolTACName(sym));
+    if (id == -1) return;
+
+    lw->uses[id].declared_in = scopeFunction(lw, sym->scope);
+    lw->uses[id].type = sym->type;
+}
+
+static void markDeclarations(Lowering* lw) {
+    BytecodeProgram* program = lw->program;
+
+    // Scope ids are handed out in creation order, a parent's is always the smaller
+    int scopeCount = 0;
+    int maxGlobalId = 0;
+    for (int b = 0; b < astArena.block_count; b++) {
+        ASTArenaBlock* block = astArena.blocks[b];
+        for (int i = 0; i < block->used; i++) {
+            ASTNode* node = &block->nodes[i];
+            SymbolTable* scope = NULL;
+            if (node->type == NODE_FUNC_DECL) {
+                scope = node->func_decl_data.scope;
+                if (node->func_decl_data.global_id > maxGlobalId) maxGlobalId = node->func_decl_data.global_id;
+            } else if (node->type == NODE_ID && node->id_data.sym) {
+                scope = node->id_data.sym->scope;
+            }
+            if (scope && scope->table_id >= scopeCount) scopeCount = scope->table_id + 1;
+        }
+    }
+
+    // Functions that were declared but emitted no code map to -1, compiler generated
+    int* functionOfGlobalId = malloc(sizeof(int) * (maxGlobalId + 1));
+    lw->scope_function = malloc(sizeof(int) * (scopeCount + 1));
+    if (!functionOfGlobalId || !lw->scope_function) {
+        fprintf(stderr, "Memory allocation failed for bytecode\n");
+        exit(1);
+    }
+    for (int g = 0; g <= maxGlobalId; g++) functionOfGlobalId[g] = -1;
+    for (int f = program->function_count - 1; f >= 1; f--) {
+        int g = program->functions[f].global_id;
+        if (g >= 0 && g <= maxGlobalId) functionOfGlobalId[g] = f;
+    }
+    for (int t = 0; t <= scopeCount; t++) lw->scope_function[t] = UNRESOLVED_SCOPE;
+
+    for (int b = 0; b < astArena.block_count; b++) {
+        ASTArenaBlock* block = astArena.blocks[b];
+        for (int i = 0; i < block->used; i++) {
+            ASTNode* node = &block->nodes[i];
+            if (node->type == NODE_FUNC_DECL && node->func_decl_data.scope &&
+                lw->scope_function[node->func_decl_data.scope->table_id] == UNRESOLVED_SCOPE) {
+                lw->scope_function[node->func_decl_data.scope->table_id] = functionOfGlobalId[node->func_decl_data.global_id];
+            }
+        }
+    }
+
+    for (int b = 0; b < astArena.block_count; b++) {
+        ASTArenaBlock* block = astArena.blocks[b];
+        for (int i = 0; i < block->used; i++) markDeclaration(lw, &block->nodes[i]);
+    }
+    free(functionOfGlobalId);
+}
+
+static void growStringIndex(Lowering* lw) {
+    int capacity = lw->string_index_capacity ? lw->string_index_capacity * 2 : INITIAL_SLOT_CAPACITY;
+    int* index = malloc(sizeof(int) * capacity);
+    if (!index) {
+        fprintf(stderr, "Memory allocation failed for bytecode strings\n");
+        exit(1);
+    }
+    for (int i = 0; i < capacity; i++) index[i] = -1;
+
+    for (int id = 0; id < lw->program->string_count; id++) {
+        unsigned int pos = hashInterned(lw->string_keys[id]) & (capacity - 1);
+        while (index[pos] != -1) pos = (pos + 1) & (capacity - 1);
+        index[pos] = id;
+    }
+    free(lw->string_index);
+    lw->string_index = index;
+    lw->string_index_capacity = capacity;
+}
+
+static int internString(Lowering* lw, const char* str) {
+    BytecodeProgram* program = lw->program;
+    if ((program->string_count + 1) * 2 > lw->string_index_capacity) growStringIndex(lw);
+
+    unsigned int mask = lw->string_index_capacity - 1;
+    unsigned int pos = hashInterned(str) & mask;
+    while (lw->string_index[pos] != -1) {
+        if (lw->string_keys[lw->string_index[pos]] == str) return lw->string_index[pos];
+        pos = (pos + 1) & mask;
+    }
+
+    if (program->string_count == lw->string_capacity) {
+        lw->string_capacity = lw->string_capacity ? lw->string_capacity * 2 : INITIAL_SLOT_CAPACITY;
+        program->strings = realloc(program->strings, sizeof(char*) * lw->string_capacity);
+        lw->string_keys = realloc(lw->string_keys, sizeof(char*) * lw->string_capacity);
+        if (!program->strings || !lw->string_keys) {
+            fprintf(stderr, "Memory allocation failed for bytecode strings\n");
+            exit(1);
+        }
+    }
+    program->strings[program->string_count] = strdup(str);
+    lw->string_keys[program->string_count] = str;
+    lw->string_index[pos] = program->string_count;
+    return program->string_count++;
+}
+
+// Storage is looked up by interned TAC name rather than by the (depth, slot)
+// semantic analysis binds. A function's nested scopes share one frame, names
+// used by several functions become globals, and the optimizer writes operands
+// that carry no symbol, so the lexical address does not name a slot here.
+static void lowerName(Lowering* lw, const char* name, uint8_t* mode, int32_t* value) {
+    BCSlot* slot = &lw->program->slots[findUse(lw, name)];
+    *mode = slot->is_local ? BC_MODE_LOCAL : BC_MODE_GLOBAL;
+    *value = slot->index;
+}
+
+static int lowerOperand(Lowering* lw, Operand* opr, uint8_t* mode, int32_t* value) {
+    *mode = BC_MODE_NONE;
+    *value = 0;
+    if (!opr) return 1;
+
+    switch (opr->type) {
+        case INT_VAL:
+            *mode = BC_MODE_INT;
+            *value = opr->int_val;
+            break;
+        case CHAR_VAL:
+            *mode = BC_MODE_CHAR;
+            *value = opr->char_val;
+            break;
+        case STR_VAL:
+            *mode = BC_MODE_STR;
+            *value = internString(lw, opr->str_val);
+            break;
+        case VOID_VAL:
+            *mode = BC_MODE_VOID;
+            break;
+        case POP_ARG:
+            *mode = BC_MODE_ARG;
+            *value = opr->pop_stk.argNum - 1;
+            break;
+        case ID_REF:
+            lowerName(lw, opr->id_ref.name, mode, value);
+            break;
+        default:
+            fprintf(stderr, "Bytecode error: unsupported operand type %d\n", opr->type);
+            return 0;
+    }
+    return 1;
+}
+
+static BCOp lowerOp(TACOp op) {
+    switch (op) {
+        case TAC_ADD:           return BC_ADD;
+        case TAC_SUB:           return BC_SUB;
+        case TAC_MUL:           return BC_MUL;
+        case TAC_DIV:           return BC_DIV;
+        case TAC_AND:           return BC_AND;
+        case TAC_OR:            return BC_OR;
+        case TAC_NOT:           return BC_NOT;
+        case TAC_NEG:           return BC_NEG;
+        case TAC_EQ:            return BC_EQ;
+        case TAC_NEQ:           return BC_NEQ;
+        case TAC_LT:            return BC_LT;
+        case TAC_GT:            return BC_GT;
+        case TAC_LEQ:           return BC_LEQ;
+        case TAC_GEQ:           return BC_GEQ;
+        case TAC_PRE_INC:       return BC_PRE_INC;
+        case TAC_PRE_DEC:       return BC_PRE_DEC;
+        case TAC_POST_INC:      return BC_POST_INC;
+        case TAC_POST_DEC:      return BC_POST_DEC;
+        case TAC_GOTO:          return BC_JMP;
+        case TAC_IF_GOTO:       return BC_JMP_IF;
+        case TAC_IF_FALSE_GOTO: return BC_JMP_IF_NOT;
+        case TAC_PUSH_ARG:      return BC_PUSH_ARG;
+        case TAC_CALL:          return BC_CALL;
+        case TAC_RETURN:        return BC_RET;
+        case TAC_END:           return BC_END;
+        default:                return BC_MOV;  // ASSIGN, POP_ARG
+    }
+}
+
+// Jumps whose target belongs to another function, or lies past the end of
+// the code, leave the function they are in
+static int leavesFunctionAt(TAC* tac, const int* ownerOf, int maxId, int function) {
+    if (tac->op != TAC_GOTO && tac->op != TAC_IF_GOTO && tac->op != TAC_IF_FALSE_GOTO) return 0;
+    if (tac->target_jump <= 0 || tac->target_jump > maxId + 1) return 0;
+    return tac->target_jump == maxId + 1 || ownerOf[tac->target_jump] != function;
+}
+
+// Fills the BC_RET pass 1 reserved at the end of a function left by a jump
+static void emitFunctionEndReturn(BytecodeProgram* program, int function, TAC* exit, int* index) {
+    if (*index >= program->functions[function].end) return;
+    BCInstr* ins = &program->code[*index];
+    memset(ins, 0, sizeof(*ins));
+    ins->op = BC_RET;
+    program->tac_ids[*index] = exit->tac_id;
+    (*index)++;
+}
+
+BytecodeProgram* lowerTACToBytecode(TACList* code) {
+    if (!code || !code->head) {
+        fprintf(stderr, "Bytecode error: no TAC to lower\n");
+        return NULL;
+    }
+
+    int tacCount = 0;
+    int maxId = 0;
+    for (TAC* tac = code->head; tac; tac = tac->next) {
+        tacCount++;
+        if (tac->tac_id > maxId) maxId = tac->tac_id;
+    }
+
+    BytecodeProgram* program = checkedAlloc(sizeof(BytecodeProgram));
+    program->functions = checkedAlloc(sizeof(BCFunction) * (tacCount + 1));
+
+    Lowering lw = {0};
+    lw.program = program;
+
+    // Instruction index every TAC id lowers to. Labels emit nothing and map
+    // onto the following instruction.
+    int* idToIndex = malloc(sizeof(int) * (maxId + 2));
+    int* ownerOf = malloc(sizeof(int) * (maxId + 2));
+    if (!idToIndex || !ownerOf) {
+        fprintf(stderr, "Memory allocation failed for bytecode\n");
+        exit(1);
+    }
+    for (int i = 0; i <= maxId + 1; i++) {
+        idToIndex[i] = -1;
+        ownerOf[i] = -1;
+    }
+
+    // Function index owning every TAC id, 0 for the top level
+    int current = 0;
+    int functionCount = 1;
+    for (TAC* tac = code->head; tac; tac = tac->next) {
+        if (tac->enter_function) current = functionCount++;
+        ownerOf[tac->tac_id] = current;
+        if (tac->exit_function) current = 0;
+    }
+
+    program->functions[0].name = strdup("<program>");
+    program->function_count = 1;
+
+    // Pass 1: instruction numbering, function ranges and name uses. A jump
+    // that leaves its function returns from it: the function gets a BC_RET
+    // after its last instruction for such jumps to land on.
+    current = 0;
+    int index = 0;
+    int leavesFunction = 0;
+    for (TAC* tac = code->head; tac; tac = tac->next) {
+        idToIndex[tac->tac_id] = index;
+
+        if (tac->enter_function) {
+            if (current == 0 && program->functions[0].end == 0) program->functions[0].end = index;
+            BCFunction* fn = &program->functions[program->function_count];
+            fn->name = strdup(tac->enter_function);
+            fn->entry = index;
+            fn->global_id = tac->function_node ? tac->function_node->func_decl_data.global_id : -1;
+            fn->param_count = tac->function_node ? tac->function_node->func_decl_data.param_count : 0;
+            current = program->function_count++;
+            leavesFunction = 0;
+        }
+        if (current > 0 && leavesFunctionAt(tac, ownerOf, maxId, current)) leavesFunction = 1;
+
+        if (tac->result) noteUse(&lw, tac->result, current);
+        if (tac->operand1 && tac->operand1->type == ID_REF && tac->op != TAC_CALL)
+            noteUse(&lw, tac->operand1->id_ref.name, current);
+        if (tac->operand2 && tac->operand2->type == ID_REF)
+            noteUse(&lw, tac->operand2->id_ref.name, current);
+
+        if (tac->op != TAC_LABEL) index++;
+        if (tac->exit_function) {
+            if (leavesFunction) index++;
+            program->functions[current].end = index;
+            current = 0;
+        }
+    }
+    program->code_count = index;
+    program->code = checkedAlloc(sizeof(BCInstr) * index);
+    program->tac_ids = checkedAlloc(sizeof(int) * index);
+    idToIndex[maxId + 1] = index;  // Jumping past the last instruction ends the program
+    if (program->functions[0].end == 0) program->functions[0].end = index;
+
+    // Pass 2: storage. A name lives in a call frame when only its own function
+    // touches it and it is either a temporary or declared inside that function.
+    markDeclarations(&lw);
+    program->slot_count = lw.use_count;
+    program->slots = checkedAlloc(sizeof(BCSlot) * lw.use_count);
+    for (int id = 0; id < lw.use_count; id++) {
+        SlotUse* use = &lw.uses[id];
+        BCSlot* slot = &program->slots[id];
+        slot->name = strdup(use->name);
+        slot->owner = use->owner;
+        slot->is_temp = use->declared_in == -1;
+        slot->type = use->type;
+        slot->is_local = use->owner > 0 && !use->shared &&
+            (use->declared_in == -1 || use->declared_in == use->owner);
+        slot->index = slot->is_local
+            ? program->functions[use->owner].frame_size++
+            : program->global_count++;
+    }
+
+    // Pass 3: encode
+    int ok = 1;
+    index = 0;
+    for (TAC* tac = code->head; tac && ok; tac = tac->next) {
+        int owner = ownerOf[tac->tac_id];
+        if (tac->exit_function && tac->op == TAC_LABEL) {
+            emitFunctionEndReturn(program, owner, tac, &index);
+        }
+        if (tac->op == TAC_LABEL) continue;
+
+        BCInstr* ins = &program->code[index];
+        program->tac_ids[index] = tac->tac_id;
+        ins->op = lowerOp(tac->op);
+
+        switch (tac->op) {
+            case TAC_GOTO:
+            case TAC_IF_GOTO:
+            case TAC_IF_FALSE_GOTO: {
+                int target = (tac->target_jump > 0 && tac->target_jump <= maxId + 1) ? idToIndex[tac->target_jump] : -1;
+                if (target == -1) {
+                    fprintf(stderr, "Bytecode error: instruction %d has unresolved jump target %d\n", tac->tac_id, tac->target_jump);
+                    ok = 0;
+                    break;
+                }
+                ins->dst_mode = BC_MODE_TARGET;
+                ins->dst = owner > 0 && leavesFunctionAt(tac, ownerOf, maxId, owner)
+                    ? program->functions[owner].end - 1
+                    : target;
+                ok = lowerOperand(&lw, tac->operand1, &ins->a_mode, &ins->a);
+                break;
+            }
+            case TAC_CALL: {
+                int target = (tac->target_jump > 0 && tac->target_jump <= maxId) ? idToIndex[tac->target_jump] : -1;
+                int callee = -1;
+                for (int f = 1; f < program->function_count && target != -1; f++) {
+                    if (program->functions[f].entry == target) {
+                        callee = f;
+                        break;
+                    }
+                }
+                if (callee == -1) {
+                    fprintf(stderr, "Bytecode error: call at instruction %d does not target a function entry\n", tac->tac_id);
+                    ok = 0;
+                    break;
+                }
+                // The call result is always overwritten by the following "tN = ret_val"
+                ins->a_mode = BC_MODE_FUNC;
+                ins->a = callee;
+                break;
+            }
+            case TAC_POP_ARG: {
+                BCFunction* fn = &program->functions[owner];
+                int arg = tac->operand1 ? tac->operand1->pop_stk.argNum : 0;
+                if (owner == 0 || arg < 1 || arg > fn->param_count) {
+                    fprintf(stderr, "Bytecode error: instruction %d pops argument %d outside of its function's parameters\n", tac->tac_id, arg);
+                    ok = 0;
+                    break;
+                }
+                lowerName(&lw, tac->result, &ins->dst_mode, &ins->dst);
+                ok = lowerOperand(&lw, tac->operand1, &ins->a_mode, &ins->a);
+                break;
+            }
+            case TAC_ASSIGN:
+                lowerName(&lw, tac->result, &ins->dst_mode, &ins->dst);
+                if (tac->operand1) {
+                    ok = lowerOperand(&lw, tac->operand1, &ins->a_mode, &ins->a);
+                } else {
+                    // Uninitialized declaration
+                    ins->a_mode = BC_MODE_INT;
+                    ins->a = 0;
+                }
+                break;
+            default:
+                if (tac->result) lowerName(&lw, tac->result, &ins->dst_mode, &ins->dst);
+                ok = lowerOperand(&lw, tac->operand1, &ins->a_mode, &ins->a) &&
+                     lowerOperand(&lw, tac->operand2, &ins->b_mode, &ins->b);
+                break;
+        }
+        index++;
+        if (tac->exit_function) emitFunctionEndReturn(program, owner, tac, &index);
+    }
+
+    free(idToIndex);
+    free(ownerOf);
+    free(lw.uses);
+    free(lw.use_index);
+    free(lw.string_index);
+    free(lw.string_keys);
+    free(lw.scope_function);
+
+    if (!ok) {
+        freeBytecode(program);
+        return NULL;
+    }
+    return program;
+}
+
+const char* getBCOpString(BCOp op) {
+    switch (op) {
+        case BC_MOV:        return "mov";
+        case BC_ADD:        return "add";
+        case BC_SUB:        return "sub";
+        case BC_MUL:        return "mul";
+        case BC_DIV:        return "div";
+        case BC_AND:        return "and";
+        case BC_OR:         return "or";
+        case BC_NOT:        return "not";
+        case BC_NEG:        return "neg";
+        case BC_EQ:         return "eq";
+        case BC_NEQ:        return "neq";
+        case BC_LT:         return "lt";
+        case BC_GT:         return "gt";
+        case BC_LEQ:        return "leq";
+        case BC_GEQ:        return "geq";
+        case BC_PRE_INC:    return "preinc";
+        case BC_PRE_DEC:    return "predec";
+        case BC_POST_INC:   return "postinc";
+        case BC_POST_DEC:   return "postdec";
+        case BC_JMP:        return "jmp";
+        case BC_JMP_IF:     return "jmpif";
+        case BC_JMP_IF_NOT: return "jmpifnot";
+        case BC_PUSH_ARG:   return "push";
+        case BC_CALL:       return "call";
+        case BC_RET:        return "ret";
+        case BC_END:        return "end";
+        default:            return "?";
+    }
+}
+
+static void printField(const BytecodeProgram* program, uint8_t mode, int32_t value) {
+    switch (mode) {
+        case BC_MODE_INT:    printf(" #%d", value); break;
+        case BC_MODE_CHAR:   printf(" '%c'", value); break;
+        case BC_MODE_STR:    printf(" %s", program->strings[value]); break;
+        case BC_MODE_VOID:   printf(" void"); break;
+        case BC_MODE_GLOBAL: printf(" g%d", value); break;
+        case BC_MODE_LOCAL:  printf(" l%d", value); break;
+        case BC_MODE_ARG:    printf(" arg%d", value); break;
+        case BC_MODE_TARGET: printf(" @%d", value); break;
+        case BC_MODE_FUNC:   printf(" %s", program->functions[value].name); break;
+        default: break;
+    }
+}
+
+void printBytecodeInstr(const BytecodeProgram* program, int index) {
+    const BCInstr* ins = &program->code[index];
+    printf("%4d : %-9s", index, getBCOpString(ins->op));
+    printField(program, ins->dst_mode, ins->dst);
+    printField(program, ins->a_mode, ins->a);
+    printField(program, ins->b_mode, ins->b);
+    printf("\t\t(TAC %d)\n", program->tac_ids[index]);
+}
+
+void printBytecode(const BytecodeProgram* program) {
+    if (!program) {
+        printf("No Bytecode\n");
+        return;
+    }
+
+    for (int f = 0; f < program->function_count; f++) {
+        const BCFunction* fn = &program->functions[f];
+        printf("%s: [%d, %d) params %d, frame %d\n", fn->name, fn->entry, fn->end, fn->param_count, fn->frame_size);
+    }
+    printf("globals %d, %zu bytes per instruction\n\n", program->global_count, sizeof(BCInstr));
+
+    for (int i = 0; i < program->code_count; i++) {
+        for (int f = 1; f < program->function_count; f++) {
+            if (program->functions[f].entry == i) printf("%s:\n", program->functions[f].name);
+        }
+        printBytecodeInstr(program, i);
+    }
+}
+
+void freeBytecode(BytecodeProgram* program) {
+    if (!program) return;
+    for (int f = 0; f < program->function_count; f++) free(program->functions[f].name);
+    for (int s = 0; s < program->slot_count; s++) free(program->slots[s].name);
+    for (int s = 0; s < program->string_count; s++) free(program->strings[s]);
+    free(program->functions);
+    free(program->slots);
+    free(program->strings);
+    free(program->code);
+    free(program->tac_ids);
+    free(program);
+}
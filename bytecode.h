@@ -0,0 +1,107 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <stdint.h>
+#include "ast.h"
+#include "icg.h"
+
+// Flat register bytecode lowered from the TAC list. Every variable and
+// temporary is a numbered slot, every jump an absolute instruction index.
+typedef enum {
+    BC_MOV,          // dst = a (also covers popArg and uninitialized declarations)
+    BC_ADD,
+    BC_SUB,
+    BC_MUL,
+    BC_DIV,
+    BC_AND,
+    BC_OR,
+    BC_NOT,
+    BC_NEG,
+    BC_EQ,
+    BC_NEQ,
+    BC_LT,
+    BC_GT,
+    BC_LEQ,
+    BC_GEQ,
+    BC_PRE_INC,      // a += 1, dst = a
+    BC_PRE_DEC,
+    BC_POST_INC,     // dst = a, a += 1
+    BC_POST_DEC,
+    BC_JMP,          // goto dst
+    BC_JMP_IF,       // if a goto dst
+    BC_JMP_IF_NOT,   // ifFalse a goto dst
+    BC_PUSH_ARG,     // push a
+    BC_CALL,         // call function a
+    BC_RET,
+    BC_END
+} BCOp;
+
+// How an instruction field is interpreted
+typedef enum {
+    BC_MODE_NONE,
+    BC_MODE_INT,     // Immediate int
+    BC_MODE_CHAR,    // Immediate char
+    BC_MODE_STR,     // Index into the string pool
+    BC_MODE_VOID,
+    BC_MODE_GLOBAL,  // Global slot
+    BC_MODE_LOCAL,   // Slot in the current call frame
+    BC_MODE_ARG,     // Argument of the current call (0 based)
+    BC_MODE_TARGET,  // Absolute instruction index
+    BC_MODE_FUNC     // Index into the function table
+} BCMode;
+
+typedef struct BCInstr {
+    uint8_t op;      // BCOp
+    uint8_t dst_mode;
+    uint8_t a_mode;
+    uint8_t b_mode;
+    int32_t dst;
+    int32_t a;
+    int32_t b;
+} BCInstr;
+
+typedef struct BCFunction {
+    char* name;
+    int global_id;   // func_decl_data.global_id, 0 for the top level program
+    int entry;       // First instruction
+    int end;         // One past the last instruction
+    int param_count;
+    int frame_size;  // Number of local slots
+} BCFunction;
+
+// Debug info for every named slot
+typedef struct BCSlot {
+    char* name;
+    int is_local;
+    int is_temp;     // Compiler generated (temporaries, ret_val)
+    TypeId type;     // Declared type, TYPE_NONE for temporaries
+    int owner;       // Function index for locals
+    int index;       // Global or frame slot number
+} BCSlot;
+
+typedef struct BytecodeProgram {
+    BCInstr* code;
+    int code_count;
+    int* tac_ids;            // Source TAC id for every instruction
+
+    BCFunction* functions;   // functions[0] is the top level program
+    int function_count;
+
+    char** strings;
+    int string_count;
+
+    BCSlot* slots;
+    int slot_count;
+    int global_count;
+} BytecodeProgram;
+
+// Lowers codeList into bytecode. The AST registry is used to find which variables
+// are declared inside functions (they get per-call frame slots). Returns NULL and
+// reports to stderr if the TAC cannot be lowered.
+BytecodeProgram* lowerTACToBytecode(TACList* code);
+void printBytecode(const BytecodeProgram* program);
+void printBytecodeInstr(const BytecodeProgram* program, int index);
+const char* getBCOpString(BCOp op);
+void freeBytecode(BytecodeProgram* program);
+
+#endif
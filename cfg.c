@@ -0,0 +1,289 @@
+#include "cfg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool isCFGDebugOn = false;
+void setCFGDebugger(){
+    isCFGDebugOn = true;
+}
+
+static bool isJump(TACOp op) {
+    return op == TAC_GOTO || op == TAC_IF_GOTO || op == TAC_IF_FALSE_GOTO;
+}
+
+// Control does not continue to the next instruction
+static bool endsFlow(TACOp op) {
+    return op == TAC_GOTO || op == TAC_RETURN || op == TAC_END;
+}
+
+static void addEdge(CFG* cfg, int from, int to) {
+    BasicBlock* src = &cfg->blocks[from];
+    for (int i = 0; i < src->succ_count; i++) {
+        if (src->succs[i] == to) return;
+    }
+    src->succs[src->succ_count++] = to;
+
+    BasicBlock* dst = &cfg->blocks[to];
+    if (dst->pred_count == dst->pred_capacity) {
+        dst->pred_capacity = dst->pred_capacity ? dst->pred_capacity * 2 : 2;
+        dst->preds = realloc(dst->preds, sizeof(int) * dst->pred_capacity);
+        if (!dst->preds) {
+            fprintf(stderr, "Memory allocation failed for CFG predecessors\n");
+            exit(1);
+        }
+    }
+    dst->preds[dst->pred_count++] = from;
+}
+
+int getBlockOfTAC(const CFG* cfg, const TAC* tac) {
+    if (!tac) return -1;
+    int offset = tac->tac_id - cfg->first_tac_id;
+    if (offset < 0 || offset >= cfg->tac_span) return -1;
+    return cfg->block_of[offset];
+}
+
+static int blockOfId(const CFG* cfg, int tac_id) {
+    int offset = tac_id - cfg->first_tac_id;
+    if (offset < 0 || offset >= cfg->tac_span) return -1;
+    return cfg->block_of[offset];
+}
+
+// Iterative DFS from the entry, recording reverse post order
+static void computeRPO(CFG* cfg) {
+    int n = cfg->block_count;
+    cfg->rpo = malloc(sizeof(int) * (n + 1));
+    int* stack = malloc(sizeof(int) * (n + 1));
+    int* nextSucc = calloc(n + 1, sizeof(int));
+    bool* visited = calloc(n + 1, sizeof(bool));
+    int* postorder = malloc(sizeof(int) * (n + 1));
+    if (!cfg->rpo || !stack || !nextSucc || !visited || !postorder) {
+        fprintf(stderr, "Memory allocation failed for CFG order\n");
+        exit(1);
+    }
+
+    int top = 0;
+    int post = 0;
+    if (n > 0) {
+        stack[top++] = 0;
+        visited[0] = true;
+    }
+    while (top > 0) {
+        int b = stack[top - 1];
+        if (nextSucc[b] < cfg->blocks[b].succ_count) {
+            int s = cfg->blocks[b].succs[nextSucc[b]++];
+            if (!visited[s]) {
+                visited[s] = true;
+                stack[top++] = s;
+            }
+        } else {
+            postorder[post++] = b;
+            top--;
+        }
+    }
+
+    cfg->rpo_count = post;
+    for (int i = 0; i < n; i++) cfg->blocks[i].rpo_index = -1;
+    for (int i = 0; i < post; i++) {
+        cfg->rpo[i] = postorder[post - 1 - i];
+        cfg->blocks[cfg->rpo[i]].rpo_index = i;
+    }
+
+    free(stack);
+    free(nextSucc);
+    free(visited);
+    free(postorder);
+}
+
+static int intersect(const CFG* cfg, int a, int b) {
+    while (a != b) {
+        while (cfg->blocks[a].rpo_index > cfg->blocks[b].rpo_index) a = cfg->blocks[a].idom;
+        while (cfg->blocks[b].rpo_index > cfg->blocks[a].rpo_index) b = cfg->blocks[b].idom;
+    }
+    return a;
+}
+
+// Cooper, Harvey and Kennedy's iterative dominator algorithm over reverse post order
+void computeDominators(CFG* cfg) {
+    if (cfg->block_count == 0) return;
+    for (int i = 0; i < cfg->block_count; i++) cfg->blocks[i].idom = -1;
+    cfg->blocks[0].idom = 0;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 1; i < cfg->rpo_count; i++) {
+            int b = cfg->rpo[i];
+            BasicBlock* block = &cfg->blocks[b];
+            int newIdom = -1;
+            for (int p = 0; p < block->pred_count; p++) {
+                int pred = block->preds[p];
+                if (cfg->blocks[pred].idom == -1) continue;
+                newIdom = newIdom == -1 ? pred : intersect(cfg, pred, newIdom);
+            }
+            if (newIdom != -1 && block->idom != newIdom) {
+                block->idom = newIdom;
+                changed = true;
+            }
+        }
+    }
+    // The entry has no immediate dominator
+    cfg->blocks[0].idom = -1;
+}
+
+bool dominates(const CFG* cfg, int a, int b) {
+    if (a < 0 || b < 0 || cfg->blocks[b].rpo_index == -1) return false;
+    while (b != -1) {
+        if (b == a) return true;
+        b = cfg->blocks[b].idom;
+    }
+    return false;
+}
+
+void buildCFG(CFG* cfg, TAC* first, TAC* last, const char* name) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->name = name;
+    cfg->function_node = first ? first->function_node : NULL;
+    if (!first || !last) return;
+
+    // tac_ids are increasing along codeList
+    cfg->first_tac_id = first->tac_id;
+    cfg->tac_span = last->tac_id - first->tac_id + 1;
+    cfg->block_of = malloc(sizeof(int) * cfg->tac_span);
+    bool* leader = calloc(cfg->tac_span + 1, sizeof(bool));
+    if (!cfg->block_of || !leader) {
+        fprintf(stderr, "Memory allocation failed for CFG\n");
+        exit(1);
+    }
+    for (int i = 0; i < cfg->tac_span; i++) cfg->block_of[i] = -1;
+
+    // Leaders: the first instruction, jump targets and whatever follows a jump, call or return
+    leader[0] = true;
+    for (TAC* tac = first; tac; tac = tac->next) {
+        int offset = tac->tac_id - cfg->first_tac_id;
+        if (isJump(tac->op) || tac->op == TAC_CALL || endsFlow(tac->op)) leader[offset + 1] = true;
+        if (isJump(tac->op)) {
+            int target = tac->target_jump - cfg->first_tac_id;
+            if (target >= 0 && target < cfg->tac_span) leader[target] = true;
+        }
+        if (tac == last) break;
+    }
+
+    int capacity = 0;
+    for (int i = 0; i < cfg->tac_span; i++) if (leader[i]) capacity++;
+    cfg->blocks = calloc(capacity + 1, sizeof(BasicBlock));
+    if (!cfg->blocks) {
+        fprintf(stderr, "Memory allocation failed for CFG blocks\n");
+        exit(1);
+    }
+
+    BasicBlock* current = NULL;
+    for (TAC* tac = first; tac; tac = tac->next) {
+        int offset = tac->tac_id - cfg->first_tac_id;
+        if (leader[offset] || !current) {
+            current = &cfg->blocks[cfg->block_count];
+            current->id = cfg->block_count++;
+            current->first = tac;
+            current->succs[0] = current->succs[1] = -1;
+        }
+        current->last = tac;
+        current->instr_count++;
+        cfg->block_of[offset] = current->id;
+        if (tac == last) break;
+    }
+    free(leader);
+
+    for (int b = 0; b < cfg->block_count; b++) {
+        TAC* end = cfg->blocks[b].last;
+        if (isJump(end->op)) {
+            // Jumps out of this range (past the end of the program) have no block
+            int target = blockOfId(cfg, end->target_jump);
+            if (target != -1) addEdge(cfg, b, target);
+        }
+        if (!endsFlow(end->op) && b + 1 < cfg->block_count) addEdge(cfg, b, b + 1);
+    }
+
+    computeRPO(cfg);
+    computeDominators(cfg);
+
+    if (isCFGDebugOn) {
+        printf("[CFG] %s: %d blocks, %d reachable\n", name, cfg->block_count, cfg->rpo_count);
+    }
+}
+
+ProgramCFG* buildProgramCFG(TACList* code) {
+    ProgramCFG* program = calloc(1, sizeof(ProgramCFG));
+    if (!program) {
+        fprintf(stderr, "Memory allocation failed for program CFG\n");
+        exit(1);
+    }
+    if (!code || !code->head) return program;
+
+    int functions = 0;
+    for (TAC* tac = code->head; tac; tac = tac->next) {
+        if (tac->enter_function) functions++;
+    }
+    program->cfgs = calloc(functions + 1, sizeof(CFG));
+    if (!program->cfgs) {
+        fprintf(stderr, "Memory allocation failed for program CFG\n");
+        exit(1);
+    }
+
+    // Top level code runs up to the first function
+    TAC* tac = code->head;
+    TAC* first = tac;
+    TAC* last = NULL;
+    while (tac && !tac->enter_function) {
+        last = tac;
+        tac = tac->next;
+    }
+    if (last) buildCFG(&program->cfgs[program->count++], first, last, "<program>");
+
+    while (tac) {
+        first = tac;
+        while (tac->next && !tac->exit_function && !tac->next->enter_function) tac = tac->next;
+        buildCFG(&program->cfgs[program->count++], first, tac, first->enter_function);
+        tac = tac->next;
+    }
+    return program;
+}
+
+void printCFG(const CFG* cfg) {
+    printf("CFG %s: %d blocks\n", cfg->name, cfg->block_count);
+    for (int b = 0; b < cfg->block_count; b++) {
+        const BasicBlock* block = &cfg->blocks[b];
+        printf("  B%d [%d..%d]", block->id, block->first->tac_id, block->last->tac_id);
+        if (block->rpo_index == -1) printf(" unreachable");
+
+        printf(" preds:");
+        for (int p = 0; p < block->pred_count; p++) printf(" B%d", block->preds[p]);
+        printf(" succs:");
+        for (int s = 0; s < block->succ_count; s++) printf(" B%d", block->succs[s]);
+        if (block->idom != -1) printf(" idom: B%d", block->idom);
+        printf("\n");
+    }
+}
+
+void printProgramCFG(const ProgramCFG* program) {
+    if (!program) return;
+    for (int i = 0; i < program->count; i++) {
+        printCFG(&program->cfgs[i]);
+        printf("\n");
+    }
+}
+
+void freeCFG(CFG* cfg) {
+    if (!cfg) return;
+    for (int b = 0; b < cfg->block_count; b++) free(cfg->blocks[b].preds);
+    free(cfg->blocks);
+    free(cfg->rpo);
+    free(cfg->block_of);
+    memset(cfg, 0, sizeof(*cfg));
+}
+
+void freeProgramCFG(ProgramCFG* program) {
+    if (!program) return;
+    for (int i = 0; i < program->count; i++) freeCFG(&program->cfgs[i]);
+    free(program->cfgs);
+    free(program);
+}
@@ -0,0 +1,59 @@
+#ifndef CFG_H
+#define CFG_H
+
+#include <stdbool.h>
+#include "icg.h"
+
+// A maximal straight line run of TAC. Blocks end at jumps, calls, returns
+// and the end of the program, and start at every jump target.
+typedef struct BasicBlock {
+    int id;
+    TAC* first;
+    TAC* last;           // Inclusive
+    int instr_count;
+
+    int succs[2];        // Fall through / branch target, -1 if absent
+    int succ_count;
+    int* preds;
+    int pred_count;
+    int pred_capacity;
+
+    int idom;            // Immediate dominator, -1 for the entry and unreachable blocks
+    int rpo_index;       // Position in reverse post order, -1 if unreachable
+} BasicBlock;
+
+typedef struct CFG {
+    const char* name;    // Function name, "<program>" for the top level code
+    ASTNode* function_node;
+    BasicBlock* blocks;  // blocks[0] is the entry
+    int block_count;
+
+    int* rpo;            // Reachable block ids in reverse post order
+    int rpo_count;
+
+    int first_tac_id;
+    int tac_span;
+    int* block_of;       // Block id of every tac_id in [first_tac_id, first_tac_id + tac_span)
+} CFG;
+
+// One CFG for the top level code and one per function
+typedef struct ProgramCFG {
+    CFG* cfgs;
+    int count;
+} ProgramCFG;
+
+void setCFGDebugger();
+
+ProgramCFG* buildProgramCFG(TACList* code);
+// Builds the CFG for the instructions first..last (inclusive) and computes dominators
+void buildCFG(CFG* cfg, TAC* first, TAC* last, const char* name);
+void computeDominators(CFG* cfg);
+bool dominates(const CFG* cfg, int a, int b);
+int getBlockOfTAC(const CFG* cfg, const TAC* tac);
+
+void printCFG(const CFG* cfg);
+void printProgramCFG(const ProgramCFG* program);
+void freeCFG(CFG* cfg);
+void freeProgramCFG(ProgramCFG* program);
+
+#endif
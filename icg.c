@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "logger.h"
+#include "intern.h"
 
 int tempVarCounter = 1;
 int labelCounter = 1;
@@ -13,13 +14,78 @@ const char* ret_val_var = "ret_val";
 #define MAX_FUNCTIONS 100
 ASTNode* functionQueue[MAX_FUNCTIONS];
 int functionCount = 1;
-TACList* funcCalls[INT16_MAX];
+List* funcCalls[MAX_FUNCTIONS];
 
 bool isDebug = false;
 void setICGDebugger(){
     isDebug = true;
 }
 
+// Every TAC, Operand, List, Label and TAC string of a compilation is bump
+// allocated from this arena and released at once by freeICG()
+#define ICG_ARENA_BLOCK_SIZE (64 * 1024)
+#define ICG_ARENA_ALIGN 16
+
+typedef struct ICGArenaBlock {
+    struct ICGArenaBlock* next;
+    size_t used;
+    size_t capacity;
+} ICGArenaBlock;
+
+#define ICG_ARENA_HEADER ((sizeof(ICGArenaBlock) + ICG_ARENA_ALIGN - 1) & ~(size_t)(ICG_ARENA_ALIGN - 1))
+
+static ICGArenaBlock* icgArena = NULL;
+static size_t icgAllocCount = 0;
+static size_t icgAllocBytes = 0;
+
+static void* icgAlloc(size_t size) {
+    size = (size + ICG_ARENA_ALIGN - 1) & ~(size_t)(ICG_ARENA_ALIGN - 1);
+    if (!icgArena || icgArena->used + size > icgArena->capacity) {
+        size_t capacity = size > ICG_ARENA_BLOCK_SIZE ? size : ICG_ARENA_BLOCK_SIZE;
+        ICGArenaBlock* block = malloc(ICG_ARENA_HEADER + capacity);
+        if (!block) {
+            fprintf(stderr, "Memory allocation failed for ICG arena\n");
+            exit(1);
+        }
+        block->next = icgArena;
+        block->used = 0;
+        block->capacity = capacity;
+        icgArena = block;
+    }
+    void* ptr = (char*)icgArena + ICG_ARENA_HEADER + icgArena->used;
+    icgArena->used += size;
+    icgAllocCount++;
+    icgAllocBytes += size;
+    return ptr;
+}
+
+void getICGArenaUsage(size_t* allocations, size_t* bytes) {
+    if (allocations) *allocations = icgAllocCount;
+    if (bytes) *bytes = icgAllocBytes;
+}
+
+static char* icgStrdup(const char* str) {
+    size_t len = strlen(str) + 1;
+    char* copy = icgAlloc(len);
+    memcpy(copy, str, len);
+    return copy;
+}
+
+void freeICG() {
+    size_t bytes = 0;
+    while (icgArena) {
+        ICGArenaBlock* next = icgArena->next;
+        bytes += icgArena->used;
+        free(icgArena);
+        icgArena = next;
+    }
+    if (isDebug) printf("[DEBUG] Freed %zu bytes of ICG data\n", bytes);
+    icgAllocCount = 0;
+    icgAllocBytes = 0;
+    codeList = NULL;
+    memset(funcCalls, 0, sizeof(funcCalls));
+}
+
 #define MAX_LOOP_STACK_SIZE 100
 LoopInfo loopStack[MAX_LOOP_STACK_SIZE];
 int loopStackTop = -1;
@@ -125,21 +191,22 @@ ASTNode* dequeue(FuncQ* funcQ) {
 
 
 // Generate a new temporary variable name
-char* newTempVar() {
-    char* temp = malloc(8);
-    snprintf(temp, 8, "t%d", tempVarCounter++);
-    return temp;
+// Temporaries are interned like every other TAC name
+const char* newTempVar() {
+    char temp[12];
+    snprintf(temp, sizeof(temp), "t%d", tempVarCounter++);
+    return intern(temp);
 }
 
 // Generate a new label name
 char* newLabel() {
-    char* label = malloc(8);
-    snprintf(label, 8, "L%d", labelCounter++);
+    char* label = icgAlloc(12);
+    snprintf(label, 12, "L%d", labelCounter++);
     return label;
 }
 
 Label* createLabel(TAC* tac){
-    Label* label = (Label*)malloc(sizeof(Label));
+    Label* label = icgAlloc(sizeof(Label));
     label->name = newLabel();
     label->tac = tac;
     return label;
@@ -147,22 +214,24 @@ Label* createLabel(TAC* tac){
 
 
 // Create a new TAC instruction
-TAC* createTAC(TACOp op, char* result, Operand* operand1, Operand* operand2) {
-    TAC* instr = (TAC*)malloc(sizeof(TAC));
-    if (!instr) {
-        fprintf(stderr, "Memory allocation failed for createTAC()\n");
-        exit(1);
-    } 
+TAC* createTAC(TACOp op, const char* result, Operand* operand1, Operand* operand2) {
+    TAC* instr = icgAlloc(sizeof(TAC));
     instr->op = op;
-    instr->result = result ? strdup(result) : NULL;
+    instr->result = intern(result);
     instr->operand1 = operand1;
     instr->operand2 = operand2;
+    instr->label = NULL;
+    instr->truelist = NULL;
+    instr->falselist = NULL;
+    instr->target_label = NULL;
+    instr->target_jump = 0;
     instr->next = NULL;
     instr->comments = NULL;
     instr->origin_node = NULL;
     instr->function_node = NULL;
     instr->enter_function = NULL;
     instr->exit_function = NULL;
+    instr->is_removed = false;
     if(isDebug){
         printf("[DEBUG] Created TAC for operation: %s, Result: %s\n", getOperatorString(op), result ? result : "NULL");
     } 
@@ -175,31 +244,21 @@ void appendComments(TAC* instr, const char* new_comment) {
     if (isDebug) printf("[DEBUG] appending comments\n");
     if (instr->comments == NULL) {
         // Allocate and set the new comment if it doesn't exist
-        instr->comments = strdup(new_comment);
-        if (!instr->comments) {
-            fprintf(stderr, "Memory allocation failed for comments\n");
-            exit(1);
-        }
+        instr->comments = icgStrdup(new_comment);
     } else {
         // Calculate the total length needed for the new string
         size_t existing_length = strlen(instr->comments);
         size_t new_length = strlen(new_comment);
         size_t total_length = existing_length + new_length + 3; // +3 for ", " and '\0'
 
-        // Allocate a new block of memory
-        char* updated_comments = malloc(total_length);
-        if (!updated_comments) {
-            fprintf(stderr, "Memory allocation failed for appending comments\n");
-            exit(1);
-        }
+        // The old string stays in the ICG arena until freeICG()
+        char* updated_comments = icgAlloc(total_length);
 
         // Copy the existing comments and append the new comment
         strcpy(updated_comments, instr->comments);
         strcat(updated_comments, ", ");
         strcat(updated_comments, new_comment);
 
-        // Free the old comments and assign the new string
-        free(instr->comments);
         instr->comments = updated_comments;
     }
     if (isDebug) printf("[DEBUG] appending comments: DONE\n");
@@ -245,11 +304,7 @@ const char* getOperatorString(TACOp op) {
 // Create a new list with a single TAC node
 List* makeList(TAC* tac) {
     if(isDebug) printf("[DEBUG] Creating a new true/false list for TAC node %d\n", tac->tac_id);
-    List* newList = (List*)malloc(sizeof(List));
-    if (!newList) {
-        fprintf(stderr, "Memory allocation failed for makeList\n");
-        exit(1);
-    }
+    List* newList = icgAlloc(sizeof(List));
     newList->tac = tac;   // Set the TAC pointer to the given TAC instruction
     newList->next = NULL;
     return newList;
@@ -293,6 +348,15 @@ char* generateScopeSuffixedName(const char* name, int scope_id) {
     return suffixed_name;
 }
 
+const char* getSymbolTACName(symbol* sym) {
+    if (!sym->tac_name) {
+        char* name = generateScopeSuffixedName(sym->name, sym->scope->table_id);
+        sym->tac_name = intern(name);
+        free(name);
+    }
+    return sym->tac_name;
+}
+
 Operand* makeOperand(ValueType type, const void* val){
     if(isDebug) printf("Making operand\n");
 
@@ -301,11 +365,7 @@ Operand* makeOperand(ValueType type, const void* val){
         return NULL;
     }
 
-    Operand* opr = (Operand*)malloc(sizeof(Operand));
-    if (!opr) {
-        fprintf(stderr, "Memory allocation failed for makeOperand\n");
-        exit(1);
-    }
+    Operand* opr = icgAlloc(sizeof(Operand));
     
     opr->type = type;
     switch (type) {
@@ -326,21 +386,11 @@ Operand* makeOperand(ValueType type, const void* val){
             if (isDebug) printf("[DEBUG] Created CHAR operand with value: %c\n", opr->char_val);
             break;
         case STR_VAL:
-            opr->str_val = strdup((char*)val);
-            if (!opr->str_val) {
-                fprintf(stderr, "Memory allocation for string failed\n");
-                free(opr);
-                exit(1);
-            }
+            opr->str_val = intern((const char*)val);
             if (isDebug) printf("[DEBUG] Created STR operand with value: %s\n", opr->str_val);
             break;
         case ID_REF:
-            opr->id_ref.name = strdup((char*)val);
-            if (!opr->id_ref.name) {
-                fprintf(stderr, "Memory allocation for string failed\n");
-                free(opr);
-                exit(1);
-            }
+            opr->id_ref.name = intern((const char*)val);
             if (isDebug) printf("[DEBUG] Created ID_REF operand with name: %s\n", opr->id_ref.name);
             break;
         case POP_ARG:
@@ -349,7 +399,6 @@ Operand* makeOperand(ValueType type, const void* val){
             break;
         default:
             fprintf(stderr, "Unknown operand type\n");
-            free(opr);
             exit(1);
     }
 
@@ -391,12 +440,18 @@ char* getFormattedValueFromOperand(Operand* opr) {
 
 
 TACList* createTACList(){
-    TACList* list = (TACList*)malloc(sizeof(TACList));
+    TACList* list = icgAlloc(sizeof(TACList));
     list->head = NULL;
     list->tail = NULL;
     return list;
 }
 
+int countTAC(const TACList* code) {
+    int count = 0;
+    for (TAC* tac = code ? code->head : NULL; tac; tac = tac->next) count++;
+    return count;
+}
+
 FuncQ* createFuncQ(){
     FuncQ* funcQ = (FuncQ*)malloc(sizeof(FuncQ));
     funcQ->head = NULL;
@@ -444,7 +499,7 @@ void appendFuncDecl(FuncQ* funcQ, ASTNode* func_decl) {
     node->id = functionCount++;
     if (isDebug) 
         printf("[DEBUG] Appended new func decl node %s with id %d\n", 
-            func_decl->func_decl_data.id->id_data.sym->name,
+            astNode(func_decl->func_decl_data.id)->id_data.sym->name,
             node->id);
 }
 
@@ -455,18 +510,9 @@ void appendFuncCallTAC(TAC* tac, int global_func_id) {
         exit(1);
     }
 
-    TACList* list = funcCalls[global_func_id-1];
-    if (list == NULL) {
-        list = createTACList();
-        funcCalls[global_func_id-1] = list;
-    } 
-    
-    if (!list->head) {
-        list->head = tac;
-    } else {
-        list->tail->next = tac;
-    }
-    list->tail = tac;
+    // Call sites are chained through List nodes (like true/false lists) so the
+    // TAC->next links of codeList are never touched.
+    funcCalls[global_func_id-1] = merge(funcCalls[global_func_id-1], makeList(tac));
     if (isDebug) printf("[DEBUG] Appended! func call to %d index\n", global_func_id-1);
 }
 
@@ -477,7 +523,7 @@ void attachValueOfExprTerm(ASTNode* node, Operand** opr){
         exit(1); 
     };
     
-    ASTNode* valNode = node->expr_data.left;
+    ASTNode* valNode = astNode(node->expr_data.left);
         if(valNode->type == NODE_INT_LITERAL){
             int temp = valNode->literal_data.value.int_value; 
             *opr = makeOperand(INT_VAL, &temp);
@@ -491,7 +537,7 @@ void attachValueOfExprTerm(ASTNode* node, Operand** opr){
             if (isDebug) printf("[DEBUG] Attached STR_LITERAL value: %s\n", valNode->literal_data.value.str_value);
         }else if(valNode->type == NODE_ID_REF){
     
-            char* suffixed_name = generateScopeSuffixedName(valNode->id_ref_data.name, valNode->id_ref_data.ref->scope->table_id);
+            const char* suffixed_name = getSymbolTACName(valNode->id_ref_data.ref);
         
             *opr = makeOperand(ID_REF, suffixed_name);
             (*opr)->id_ref.sym = valNode->id_ref_data.ref;
@@ -505,18 +551,32 @@ void attachValueOfExprTerm(ASTNode* node, Operand** opr){
 
 
 
+// TAC instruction for each arithmetic and comparison operator
+static const TACOp binaryTACOps[OPERATOR_COUNT] = {
+    [OP_ADD] = TAC_ADD,
+    [OP_SUB] = TAC_SUB,
+    [OP_MUL] = TAC_MUL,
+    [OP_DIV] = TAC_DIV,
+    [OP_LT]  = TAC_LT,
+    [OP_GT]  = TAC_GT,
+    [OP_LEQ] = TAC_LEQ,
+    [OP_GEQ] = TAC_GEQ,
+    [OP_EQ]  = TAC_EQ,
+    [OP_NEQ] = TAC_NEQ,
+};
+
 // Generate code for a binary expression
 TAC* generateCodeForBinaryExpr(ASTNode* node, BoolExprInfo* bool_info) {
     if(isDebug) printf("[DEBUG] GenCode for BIN EXPR\n"); 
     
     if (node->type != NODE_EXPR_BINARY) return NULL;
 
-    if(!(node->expr_data.op)){
+    if(node->expr_data.op == OP_NONE){
         fprintf(stderr, "Operator is NULL\n");
         exit(1); 
     }
 
-    const char* op = node->expr_data.op;
+    Operator op = node->expr_data.op;
 
     switch (getOpType(op)) {
         case OP_COMP:
@@ -526,10 +586,10 @@ TAC* generateCodeForBinaryExpr(ASTNode* node, BoolExprInfo* bool_info) {
             Operand* l_opr1 = NULL; 
             BoolExprInfo l_info = {NULL, NULL, NULL, NULL, NULL};
             TAC* leftSubCode = NULL;
-            if(node->expr_data.left->type == NODE_EXPR_TERM){
-                attachValueOfExprTerm(node->expr_data.left, &l_opr1);
+            if(astNode(node->expr_data.left)->type == NODE_EXPR_TERM){
+                attachValueOfExprTerm(astNode(node->expr_data.left), &l_opr1);
             }else{
-                leftSubCode = generateCode(node->expr_data.left, &l_info);
+                leftSubCode = generateCode(astNode(node->expr_data.left), &l_info);
                 const char* l_result = l_info.bool_resut != NULL ? l_info.bool_resut : leftSubCode->result;
                 l_opr1 = makeOperand(ID_REF, l_result); 
                 if(isDebug) printf("[DEBUG] Left sub expr result %s\n", l_result);
@@ -538,31 +598,16 @@ TAC* generateCodeForBinaryExpr(ASTNode* node, BoolExprInfo* bool_info) {
             Operand* r_opr1 = NULL;
             BoolExprInfo r_info = {NULL, NULL};
             TAC* rightSubCode = NULL;
-            if(node->expr_data.right->type == NODE_EXPR_TERM){
-                attachValueOfExprTerm(node->expr_data.right, &r_opr1);
+            if(astNode(node->expr_data.right)->type == NODE_EXPR_TERM){
+                attachValueOfExprTerm(astNode(node->expr_data.right), &r_opr1);
             }else{
-                rightSubCode = generateCode(node->expr_data.right, &r_info);
+                rightSubCode = generateCode(astNode(node->expr_data.right), &r_info);
                 const char* r_result = r_info.bool_resut != NULL ? r_info.bool_resut : rightSubCode->result;
                 r_opr1 = makeOperand(ID_REF, r_result);
                 if(isDebug) printf("[DEBUG] Right sub expr result %s\n", r_result); 
             }
 
-            TACOp tac_op;
-
-            if(strcmp(op, "+") == 0)            tac_op = TAC_ADD;
-            else if(strcmp(op, "-") == 0)       tac_op = TAC_SUB;
-            else if(strcmp(op, "*") == 0)       tac_op = TAC_MUL;
-            else if(strcmp(op, "/") == 0)       tac_op = TAC_DIV;
-            else if(strcmp(op, "<") == 0)       tac_op = TAC_LT;
-            else if(strcmp(op, ">") == 0)       tac_op = TAC_GT;
-            else if(strcmp(op, "<=") == 0)      tac_op = TAC_LEQ;
-            else if(strcmp(op, ">=") == 0)      tac_op = TAC_GEQ;
-            else if(strcmp(op, "==") == 0)      tac_op = TAC_EQ;
-            else if(strcmp(op, "!=") == 0)      tac_op = TAC_NEQ;
-            else {
-                fprintf(stderr, "Unsupported operator");
-                exit(1);
-            }
+            TACOp tac_op = binaryTACOps[op];  // Every arithmetic and comparison operator has an entry
             
             TAC* newTac = createTAC(tac_op, newTempVar(), l_opr1, r_opr1);
             appendTAC(codeList, newTac); 
@@ -570,16 +615,16 @@ TAC* generateCodeForBinaryExpr(ASTNode* node, BoolExprInfo* bool_info) {
             return newTac;
         }
         case OP_LOGICAL:{
-            if (strcmp(op, "&&") == 0){
+            if (op == OP_AND){
                 if(isDebug) printf("[DEBUG] Handling logical (&&) expression\n");
                 //Process left child
                 Operand* l_opr1 = NULL; 
                 BoolExprInfo l_info = {NULL, NULL, NULL, NULL, NULL};
                 TAC* leftSubCode = NULL;
-                if(node->expr_data.left->type == NODE_EXPR_TERM){
-                    attachValueOfExprTerm(node->expr_data.left, &l_opr1);
+                if(astNode(node->expr_data.left)->type == NODE_EXPR_TERM){
+                    attachValueOfExprTerm(astNode(node->expr_data.left), &l_opr1);
                 }else{
-                    leftSubCode = generateCode(node->expr_data.left, &l_info);
+                    leftSubCode = generateCode(astNode(node->expr_data.left), &l_info);
                     const char* l_result = l_info.bool_resut != NULL ? l_info.bool_resut : leftSubCode->result;
                     l_opr1 = makeOperand(ID_REF, l_result); 
                     if(isDebug) printf("[DEBUG] Left sub expr result %s\n", l_result);
@@ -622,10 +667,10 @@ TAC* generateCodeForBinaryExpr(ASTNode* node, BoolExprInfo* bool_info) {
                 Operand* r_opr1 = NULL;
                 BoolExprInfo r_info = {NULL, NULL};
                 TAC* rightSubCode = NULL;
-                if(node->expr_data.right->type == NODE_EXPR_TERM){
-                    attachValueOfExprTerm(node->expr_data.right, &r_opr1);
+                if(astNode(node->expr_data.right)->type == NODE_EXPR_TERM){
+                    attachValueOfExprTerm(astNode(node->expr_data.right), &r_opr1);
                 }else{
-                    rightSubCode = generateCode(node->expr_data.right, &r_info);
+                    rightSubCode = generateCode(astNode(node->expr_data.right), &r_info);
                     const char* r_result = r_info.bool_resut != NULL ? r_info.bool_resut : rightSubCode->result;
                     r_opr1 = makeOperand(ID_REF, r_result);
                     if(isDebug) printf("[DEBUG] Right sub expr result %s\n", r_result); 
@@ -689,7 +734,7 @@ TAC* generateCodeForBinaryExpr(ASTNode* node, BoolExprInfo* bool_info) {
 
                  
                 if(isDebug) printf("[DEBUG] Generating Code for bool result\n");
-                char* result = newTempVar();
+                const char* result = newTempVar();
                 bool_info->bool_resut = result;
                 leftIfFalseCode->result = result;
 
@@ -710,16 +755,16 @@ TAC* generateCodeForBinaryExpr(ASTNode* node, BoolExprInfo* bool_info) {
                 return leftSubCode != NULL ? leftSubCode : leftIfFalseCode ; 
 
             }      
-            else if (strcmp(op, "||") == 0){
+            else if (op == OP_OR){
                 if(isDebug) printf("[DEBUG] Handling logical (||) expression\n");
                 //Process left child
                 Operand* l_opr1 = NULL; 
                 BoolExprInfo l_info = {NULL, NULL, NULL, NULL, NULL};
                 TAC* leftSubCode = NULL;
-                if(node->expr_data.left->type == NODE_EXPR_TERM){
-                    attachValueOfExprTerm(node->expr_data.left, &l_opr1);
+                if(astNode(node->expr_data.left)->type == NODE_EXPR_TERM){
+                    attachValueOfExprTerm(astNode(node->expr_data.left), &l_opr1);
                 }else{
-                    leftSubCode = generateCode(node->expr_data.left, &l_info);
+                    leftSubCode = generateCode(astNode(node->expr_data.left), &l_info);
                     const char* l_result = l_info.bool_resut != NULL ? l_info.bool_resut : leftSubCode->result;
                     l_opr1 = makeOperand(ID_REF, l_result); 
                     if(isDebug) printf("[DEBUG] Left sub expr result %s\n", l_result);
@@ -760,10 +805,10 @@ TAC* generateCodeForBinaryExpr(ASTNode* node, BoolExprInfo* bool_info) {
                 Operand* r_opr1 = NULL;
                 BoolExprInfo r_info = {NULL, NULL};
                 TAC* rightSubCode = NULL;
-                if(node->expr_data.right->type == NODE_EXPR_TERM){
-                    attachValueOfExprTerm(node->expr_data.right, &r_opr1);
+                if(astNode(node->expr_data.right)->type == NODE_EXPR_TERM){
+                    attachValueOfExprTerm(astNode(node->expr_data.right), &r_opr1);
                 }else{
-                    rightSubCode = generateCode(node->expr_data.right, &r_info);
+                    rightSubCode = generateCode(astNode(node->expr_data.right), &r_info);
                     const char* r_result = r_info.bool_resut != NULL ? r_info.bool_resut : rightSubCode->result;
                     r_opr1 = makeOperand(ID_REF, r_result);
                     if(isDebug) printf("[DEBUG] Right sub expr result %s\n", r_result); 
@@ -827,7 +872,7 @@ TAC* generateCodeForBinaryExpr(ASTNode* node, BoolExprInfo* bool_info) {
                  
                 if(isDebug) printf("[DEBUG] Generating Code for bool result\n");
                 // Generate TAC to store the boolean result in a temporary variable
-                char* result = newTempVar();
+                const char* result = newTempVar();
                 bool_info->bool_resut = result;
                 leftIfCode->result = result; // To give access to other parent bool
 
@@ -866,7 +911,7 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
     if(isDebug) printf("[DEBUG] GenCode for EXPR_UNARY\n");
     if(node->type != NODE_EXPR_UNARY) return NULL;
 
-    if(!(node->expr_data.op)){
+    if(node->expr_data.op == OP_NONE){
         fprintf(stderr, "Operator is NULL\n");
         exit(1); 
     }
@@ -877,10 +922,10 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
     BoolExprInfo b_info = {NULL, NULL, NULL, NULL, NULL};
  
 
-    const char* node_op = node->expr_data.op;
+    Operator node_op = node->expr_data.op;
     TACOp op;
-    if(strcmp(node_op, "-") == 0)                op = TAC_NEG;
-    else if(strcmp(node_op, "!") == 0){
+    if(node_op == OP_SUB)                op = TAC_NEG;
+    else if(node_op == OP_NOT){
 
         if(isDebug) printf("[DEBUG] Handling logical (!) expression\n");
         
@@ -889,10 +934,10 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
         BoolExprInfo l_info = {NULL, NULL, NULL, NULL, NULL};
         TAC* leftSubCode = NULL;
 
-        if(node->expr_data.left->type == NODE_EXPR_TERM){
-            attachValueOfExprTerm(node->expr_data.left, &l_opr1);
+        if(astNode(node->expr_data.left)->type == NODE_EXPR_TERM){
+            attachValueOfExprTerm(astNode(node->expr_data.left), &l_opr1);
         }else{
-            leftSubCode = generateCode(node->expr_data.left, &l_info);
+            leftSubCode = generateCode(astNode(node->expr_data.left), &l_info);
             if(l_info.begin_tac != NULL) leftSubCode = l_info.begin_tac;
 
             const char* l_result = l_info.bool_resut != NULL ? l_info.bool_resut : leftSubCode->result;
@@ -901,7 +946,7 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
         }
 
         // Generate TAC to store the boolean result in a temporary variable
-        char* result = newTempVar();
+        const char* result = newTempVar();
         bool_info->bool_resut = result;
         // Generate code for left. If true, then result must be false
         TAC* leftIfCode = createTAC(TAC_IF_GOTO, result, l_opr1, NULL); 
@@ -968,12 +1013,12 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
         return bool_info->begin_tac;
 
     } 
-    else if(strcmp(node_op, "POST_INC") == 0){
+    else if(node_op == OP_POST_INC){
         // Assign the original value
         op = TAC_ASSIGN;
-        char* result = newTempVar();
-        if(node->expr_data.left->type == NODE_EXPR_TERM){
-            attachValueOfExprTerm(node->expr_data.left, &opr1);
+        const char* result = newTempVar();
+        if(astNode(node->expr_data.left)->type == NODE_EXPR_TERM){
+            attachValueOfExprTerm(astNode(node->expr_data.left), &opr1);
         }else{
             fprintf(stderr, "Error: Unsupported node for POST_INC\n");
             exit(0);
@@ -990,16 +1035,16 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
         appendTAC(codeList, postInc);
         return newTac;
     }   
-    else if(strcmp(node_op, "POST_DEC") == 0){
+    else if(node_op == OP_POST_DEC){
         // Assign the original value
-        if(node->expr_data.left->type == NODE_EXPR_TERM){
-            attachValueOfExprTerm(node->expr_data.left, &opr1);
+        if(astNode(node->expr_data.left)->type == NODE_EXPR_TERM){
+            attachValueOfExprTerm(astNode(node->expr_data.left), &opr1);
         }else{
             fprintf(stderr, "Error: Unsupported node for POST_DEC\n");
             exit(0);
         }
         op = TAC_ASSIGN;
-        char* result = newTempVar();
+        const char* result = newTempVar();
         TAC* newTac = createTAC(op, result, opr1, NULL);
         appendTAC(codeList, newTac);  
 
@@ -1011,9 +1056,9 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
         appendTAC(codeList, postDec);
         return newTac;
     }    
-    else if(strcmp(node_op, "PRE_INC") == 0){
-        if(node->expr_data.left->type == NODE_EXPR_TERM){
-            attachValueOfExprTerm(node->expr_data.left, &opr1);
+    else if(node_op == OP_PRE_INC){
+        if(astNode(node->expr_data.left)->type == NODE_EXPR_TERM){
+            attachValueOfExprTerm(astNode(node->expr_data.left), &opr1);
         }else{
             fprintf(stderr, "Error: Unsupported node for PRE_INC\n");
             exit(0);
@@ -1027,15 +1072,15 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
 
         // Assign the incremented value
         op = TAC_ASSIGN;
-        char* result = newTempVar();
+        const char* result = newTempVar();
         TAC* newTac = createTAC(op, result, opr1, NULL);
         appendTAC(codeList, newTac);  
         
         return newTac;        
     }
-    else if(strcmp(node_op, "PRE_DEC") == 0){
-        if(node->expr_data.left->type == NODE_EXPR_TERM){
-            attachValueOfExprTerm(node->expr_data.left, &opr1);
+    else if(node_op == OP_PRE_DEC){
+        if(astNode(node->expr_data.left)->type == NODE_EXPR_TERM){
+            attachValueOfExprTerm(astNode(node->expr_data.left), &opr1);
         }else{
             fprintf(stderr, "Error: Unsupported node for PRE_DEC\n");
             exit(0);
@@ -1049,7 +1094,7 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
 
         // Assign the decremented value
         op = TAC_ASSIGN;
-        char* result = newTempVar();
+        const char* result = newTempVar();
         TAC* newTac = createTAC(op, result, opr1, NULL);
         appendTAC(codeList, newTac);  
         
@@ -1061,14 +1106,14 @@ TAC* genCodeForUnaryExpr(ASTNode* node, BoolExprInfo* bool_info){
     }    
 
        
-    if(node->expr_data.left->type == NODE_EXPR_TERM){
-        attachValueOfExprTerm(node->expr_data.left, &opr1);
+    if(astNode(node->expr_data.left)->type == NODE_EXPR_TERM){
+        attachValueOfExprTerm(astNode(node->expr_data.left), &opr1);
     }else{
-        rhsCode = generateCode(node->expr_data.left, &b_info);
+        rhsCode = generateCode(astNode(node->expr_data.left), &b_info);
         opr1 = makeOperand(ID_REF,rhsCode->result);
     }  
 
-    char* result = newTempVar();
+    const char* result = newTempVar();
     TAC* newTac = createTAC(op, result, opr1, NULL);
 
     appendTAC(codeList, newTac);
@@ -1082,7 +1127,7 @@ TAC* genCodeForIfElse(ASTNode* node, BoolExprInfo* bool_info){
     
     BoolExprInfo cond_info = {NULL, NULL, NULL, NULL, NULL};
  
-    ASTNode* cond = node->if_else_data.condition->if_cond_data.cond;
+    ASTNode* cond = astNode(astNode(node->if_else_data.condition)->if_cond_data.cond);
     Operand* cond_opr = NULL;
     TAC* cond_code = NULL;
 
@@ -1123,19 +1168,19 @@ TAC* genCodeForIfElse(ASTNode* node, BoolExprInfo* bool_info){
     bool_info->falseList = makeList(ifFalseCode);
 
     BoolExprInfo b_info = {NULL, NULL}; // Dummy
-    TAC* if_branch_code = generateCode(node->if_else_data.if_branch->if_else_branch.branch, &b_info);
+    TAC* if_branch_code = generateCode(astNode(astNode(node->if_else_data.if_branch)->if_else_branch.branch), &b_info);
     appendComments(if_branch_code, "IF BODY"); 
     TAC* skipCode = NULL;
     TAC* else_branch_code = NULL;
     // Generate SKIP code if Else part exists
-    if(node->if_else_data.else_branch->if_else_branch.branch){
+    if(astNode(astNode(node->if_else_data.else_branch)->if_else_branch.branch)){
         skipCode = createTAC(TAC_GOTO, NULL, NULL, NULL); 
         appendComments(skipCode, "IF BODY END");
         appendTAC(codeList, skipCode);
         backpatch(bool_info->falseList, getNextInstruction());
 
         BoolExprInfo b_info = {NULL, NULL}; // Dummy
-        else_branch_code = generateCode(node->if_else_data.else_branch->if_else_branch.branch, &b_info);
+        else_branch_code = generateCode(astNode(astNode(node->if_else_data.else_branch)->if_else_branch.branch), &b_info);
         appendComments(else_branch_code, "ELSE BODY");
         skipCode->target_jump = getNextInstruction(); // Patch the Skip Code with correct jump
     }else{
@@ -1155,7 +1200,7 @@ TAC* genCodeForBrkContStmts(ASTNode* node){
     if(node->type == NODE_BREAK_STMT){
         LoopInfo* curLoopInfo = getCurrentLoopInfo();
 
-        if(curLoopInfo->loop_node == node->break_continue_stmt_data.associated_loop_node){
+        if(curLoopInfo->loop_node == astNode(node->break_continue_stmt_data.associated_loop_node)){
 
             code = createTAC(TAC_GOTO, NULL, NULL, NULL);
             appendComments(code, "BREAK");
@@ -1170,7 +1215,7 @@ TAC* genCodeForBrkContStmts(ASTNode* node){
     }else if(node->type == NODE_CONTINUE_STMT){
         LoopInfo* curLoopInfo = getCurrentLoopInfo();
 
-        if(curLoopInfo->loop_node == node->break_continue_stmt_data.associated_loop_node){
+        if(curLoopInfo->loop_node == astNode(node->break_continue_stmt_data.associated_loop_node)){
 
             code = createTAC(TAC_GOTO, NULL, NULL, NULL);
             appendComments(code, "CONTINUE");
@@ -1194,7 +1239,7 @@ TAC* genCodeForFORLoop(ASTNode* node, BoolExprInfo* bool_info){
     // For initialization
     if(isDebug) printf("[DEBUG] GenCode for FOR INIT\n");
     BoolExprInfo init_info = {NULL, NULL, NULL, NULL, NULL};
-    TAC* init_code = generateCode(node->for_data.init->for_init_data.init, &init_info);
+    TAC* init_code = generateCode(astNode(astNode(node->for_data.init)->for_init_data.init), &init_info);
     // If the init_code is expr comma list
     if(init_info.begin_tac != NULL){
         init_code = init_info.begin_tac;
@@ -1203,7 +1248,7 @@ TAC* genCodeForFORLoop(ASTNode* node, BoolExprInfo* bool_info){
 
     // For condition
     BoolExprInfo cond_info = {NULL, NULL, NULL, NULL, NULL};
-    ASTNode* cond = node->for_data.condition->for_cond_data.cond; 
+    ASTNode* cond = astNode(astNode(node->for_data.condition)->for_cond_data.cond); 
     Operand* cond_opr = NULL;
     TAC* cond_code = NULL;
 
@@ -1269,14 +1314,14 @@ TAC* genCodeForFORLoop(ASTNode* node, BoolExprInfo* bool_info){
     TAC* for_body_code = NULL;
     BoolExprInfo b_info = {NULL, NULL, NULL, NULL, NULL};
     if(node->for_data.body){
-        for_body_code = generateCode(node->for_data.body->for_body_data.body, &b_info);
+        for_body_code = generateCode(astNode(astNode(node->for_data.body)->for_body_data.body), &b_info);
     }
 
     
     // For updation
     if(isDebug) printf("[DEBUG] Generating code for FOR UPDATION\n");
     BoolExprInfo updation_info = {NULL, NULL, NULL, NULL, NULL};
-    TAC* for_updation_code = generateCode(node->for_data.updation->for_updation_data.updation, &updation_info);
+    TAC* for_updation_code = generateCode(astNode(astNode(node->for_data.updation)->for_updation_data.updation), &updation_info);
     // If updation is a expr comma list
     if(updation_info.begin_tac != NULL){
         for_updation_code = updation_info.begin_tac;
@@ -1289,7 +1334,8 @@ TAC* genCodeForFORLoop(ASTNode* node, BoolExprInfo* bool_info){
     goBackCode->target_jump = cond_code != NULL ? cond_code->tac_id : ifFalseCode->tac_id;
 
 
-    backpatch(loop_info->continueList, goBackCode->target_jump);
+    // continue must still run the updation before re-checking the condition
+    backpatch(loop_info->continueList, for_updation_code != NULL ? for_updation_code->tac_id : goBackCode->tac_id);
     
 
     bool_info->falseList = merge(bool_info->falseList, loop_info->breakList);
@@ -1320,7 +1366,7 @@ TAC* genCodeForWhileLoop(ASTNode* node, BoolExprInfo* bool_info){
     
     BoolExprInfo cond_info = {NULL, NULL, NULL, NULL, NULL};
  
-    ASTNode* cond = node->while_data.condition->while_cond_data.cond;
+    ASTNode* cond = astNode(astNode(node->while_data.condition)->while_cond_data.cond);
     Operand* cond_opr = NULL;
     TAC* cond_code = NULL;
 
@@ -1369,7 +1415,7 @@ TAC* genCodeForWhileLoop(ASTNode* node, BoolExprInfo* bool_info){
 
     TAC* while_body_code = NULL;
     if(node->while_data.while_body){
-        while_body_code = generateCode(node->while_data.while_body->while_body_data.body, &b_info);
+        while_body_code = generateCode(astNode(astNode(node->while_data.while_body)->while_body_data.body), &b_info);
     }
     
     
@@ -1401,7 +1447,7 @@ TAC* genCodeForTermExpr(ASTNode* node){
     if (node->type != NODE_EXPR_TERM) return NULL;
 
     Operand* opr1 = NULL;
-    char* result = newTempVar();
+    const char* result = newTempVar();
 
     attachValueOfExprTerm(node, &opr1);
 
@@ -1418,12 +1464,12 @@ TAC* generateCodeForAssignment(ASTNode* node) {
     if (node->type != NODE_ASSGN) return NULL;
     BoolExprInfo b_info = {NULL, NULL};
     Operand* opr1;
-    char* result = strdup(generateScopeSuffixedName(node->assgn_data.left->id_ref_data.name, node->assgn_data.left->id_ref_data.ref->scope->table_id)); 
+    const char* result = getSymbolTACName(astNode(node->assgn_data.left)->id_ref_data.ref);
 
-    if(node->assgn_data.right->type == NODE_EXPR_TERM){
-       attachValueOfExprTerm(node->assgn_data.right, &opr1); 
+    if(astNode(node->assgn_data.right)->type == NODE_EXPR_TERM){
+       attachValueOfExprTerm(astNode(node->assgn_data.right), &opr1); 
     }else{
-       TAC* rhsCode = generateCode(node->assgn_data.right, &b_info);
+       TAC* rhsCode = generateCode(astNode(node->assgn_data.right), &b_info);
        opr1 = makeOperand(ID_REF, rhsCode->result); 
     }
 
@@ -1441,15 +1487,15 @@ TAC* genCodeForVar(ASTNode* node){
 
     Operand* opr1;
     BoolExprInfo b_info = {NULL, NULL};
-    char* result = strdup(generateScopeSuffixedName(node->var_data.id->id_data.sym->name, node->var_data.id->id_data.sym->scope->table_id));
+    const char* result = getSymbolTACName(astNode(node->var_data.id)->id_data.sym);
 
-    if(node->var_data.value == NULL){
+    if(!node->var_data.value){
         opr1 = NULL;
     }else{
-        if(node->var_data.value->type == NODE_EXPR_TERM){
-            attachValueOfExprTerm(node->var_data.value, &opr1);
+        if(astNode(node->var_data.value)->type == NODE_EXPR_TERM){
+            attachValueOfExprTerm(astNode(node->var_data.value), &opr1);
         }else{
-            TAC* rhsCode = generateCode(node->var_data.value, &b_info);
+            TAC* rhsCode = generateCode(astNode(node->var_data.value), &b_info);
             if(isDebug) printf("[DEBUG] Rhs result: %s\n", rhsCode->result);
             opr1 = makeOperand(ID_REF, rhsCode->result);
         }    
@@ -1471,7 +1517,7 @@ TAC* genCodeForReturn(ASTNode* node){
     TAC* ret_val = NULL;
     Operand* opr1;
     if(node->return_data.return_value) {
-        ret_val = generateCode(node->return_data.return_value, &b_info);
+        ret_val = generateCode(astNode(node->return_data.return_value), &b_info);
         opr1 = makeOperand(ID_REF, ret_val->result);
     }else{
         opr1 = makeOperand(VOID_VAL, NULL); 
@@ -1490,12 +1536,7 @@ TAC* genCodeForParam(ASTNode* node, int argNo){
     if(isDebug) printf("[DEBUG] GenCode for PARAM\n");
     if(node->type != NODE_PARAM) return NULL; 
 
-    char* result = strdup(
-        generateScopeSuffixedName(
-            node->param_data.id->id_data.sym->name, 
-            node->param_data.id->id_data.sym->scope->table_id
-        )
-    );
+    const char* result = getSymbolTACName(astNode(node->param_data.id)->id_data.sym);
 
     int val = argNo;
     Operand* pop_arg =  makeOperand(POP_ARG, &val); 
@@ -1513,7 +1554,7 @@ TAC* genCodeForArg(ASTNode* node, int argNo){
         exit(1);
     }
     BoolExprInfo b_info = {NULL, NULL};
-    TAC* code_arg = generateCode(node->arg_data.arg, &b_info);
+    TAC* code_arg = generateCode(astNode(node->arg_data.arg), &b_info);
     Operand* opr1 = makeOperand(ID_REF, code_arg->result);
     TAC* code_push = createTAC(TAC_PUSH_ARG, NULL, opr1, NULL); 
     appendTAC(codeList, code_push);
@@ -1525,8 +1566,10 @@ TAC* genCodeForVarList(ASTNode* node){
     if(isDebug) printf("[DEBUG] GenCode for VAR_LIST\n");
     if(node->type != NODE_VAR_LIST) return NULL;
 
-    TAC* code_var_list = genCodeForVarList(node->var_list_data.var_list);
-    TAC* code_var = genCodeForVar(node->var_list_data.var);
+    TAC* code_var = NULL;
+    for (int i = 0; i < node->list_data.count; i++) {
+        code_var = genCodeForVar(astNode(node->list_data.items[i]));
+    }
     return code_var;
 }
 
@@ -1535,8 +1578,12 @@ TAC* genCodeForParamList(ASTNode* node, int argNum){
     if(isDebug) printf("[DEBUG] GenCode for PARAM_LIST\n"); 
     if(node->type != NODE_PARAM_LIST) return NULL; 
 
-    TAC* code_param = genCodeForParam(node->param_data.id, argNum);
-    TAC* code_param_list = genCodeForParamList(node->param_list_data.param_list, argNum - 1);
+    // Pops run last parameter first, argNum counts down to 1
+    TAC* code_param = NULL;
+    for (int i = node->list_data.count - 1; i >= 0; i--, argNum--) {
+        TAC* code = genCodeForParam(astNode(node->list_data.items[i]), argNum);
+        if (!code_param) code_param = code;
+    }
     return code_param;
 }
 
@@ -1548,9 +1595,11 @@ TAC* genCodeForArgList(ASTNode* node, int argNum){
         exit(1);
     } 
 
-    TAC* code_arg_list = genCodeForArgList(node->arg_list_data.arg_list, argNum - 1);
-    TAC* code_arg = genCodeForArg(node->arg_list_data.arg, argNum);
-    return code_arg_list;
+    for (int i = 0; i < node->list_data.count; i++) {
+        genCodeForArg(astNode(node->list_data.items[i]), argNum - node->list_data.count + i + 1);
+    }
+    // The pushes are not the value of the call, genCodeForFuncCall returns its own TAC
+    return NULL;
 }
 
 
@@ -1558,7 +1607,7 @@ TAC* generateCodeForDecl(ASTNode* node){
     if(isDebug) printf("[DEBUG] GenCode for DECL\n");
     if(node->type != NODE_DECL) return NULL;
 
-    TAC* code_var_list = genCodeForVarList(node->decl_data.var_list);
+    TAC* code_var_list = genCodeForVarList(astNode(node->decl_data.var_list));
     return code_var_list;
 }
 
@@ -1572,21 +1621,17 @@ TAC* genCodeForFuncDecl(ASTNode* node, BoolExprInfo* bool_info){
     TAC* tail_before = codeList->tail;
 
     // Generate parameter TACs
-    ASTNode* paramList = node->func_decl_data.params;
+    ASTNode* paramList = astNode(node->func_decl_data.params);
     int paramCnt = node->func_decl_data.param_count;
 
     TAC* code_param_list = genCodeForParamList(paramList, paramCnt);
 
     // Generate body TACs
-    TAC* code_body = generateCode(node->func_decl_data.body, bool_info);
+    TAC* code_body = generateCode(astNode(node->func_decl_data.body), bool_info);
 
-    // Determine function entry point
-    TAC* func_entry = NULL;
-
-    if(code_param_list != NULL)
-        func_entry = code_param_list;
-    else if(code_body != NULL)
-        func_entry = code_body;
+    // The function starts at the first TAC emitted for it, code_body is the
+    // TAC of the body's last statement
+    TAC* func_entry = tail_before ? tail_before->next : codeList->head;
 
     // Function generated absolutely no code (e.g. void foo() {})
     if(func_entry == NULL){
@@ -1646,15 +1691,14 @@ TAC* genCodeForFuncDecl(ASTNode* node, BoolExprInfo* bool_info){
     }
 
     // Backpatch calls
-    TACList* list = funcCalls[node->func_decl_data.global_id - 1];
-    TAC* funCallNode = (list == NULL) ? NULL : list->head;
+    List* callList = funcCalls[node->func_decl_data.global_id - 1];
 
     if(isDebug){
         printf(
             "[DEBUG] Backpatching fun calls for Func: %s, id: %d. Func Call List Null? = %d\n",
-            node->func_decl_data.id->id_data.sym->name,
+            astNode(node->func_decl_data.id)->id_data.sym->name,
             node->func_decl_data.global_id,
-            list == NULL
+            callList == NULL
         );
 
         printf("[DEBUG] code_param_list=%p\n", (void*)code_param_list);
@@ -1662,28 +1706,25 @@ TAC* genCodeForFuncDecl(ASTNode* node, BoolExprInfo* bool_info){
         printf("[DEBUG] func_entry=%p\n", (void*)func_entry);
     }
 
-    while(funCallNode != NULL && funCallNode->op == TAC_CALL){
-        funCallNode->target_jump = func_entry->tac_id;
-        funCallNode = funCallNode->next;
-    }
+    backpatch(callList, func_entry->tac_id);
 
     appendComments(func_entry, "FUNC START");
     appendComments(
         func_entry,
-        node->func_decl_data.id->id_data.sym->name
+        astNode(node->func_decl_data.id)->id_data.sym->name
     );
     func_entry->function_node = node;
-    func_entry->enter_function = node->func_decl_data.id->id_data.sym->name;
+    func_entry->enter_function = astNode(node->func_decl_data.id)->id_data.sym->name;
 
     if(codeList->tail != NULL){
         appendComments(codeList->tail, "FUNC END");
         appendComments(
             codeList->tail,
-            node->func_decl_data.id->id_data.sym->name
+            astNode(node->func_decl_data.id)->id_data.sym->name
         );
         codeList->tail->function_node = node;
         codeList->tail->exit_function =
-            node->func_decl_data.id->id_data.sym->name;
+            astNode(node->func_decl_data.id)->id_data.sym->name;
     }
 
     return func_entry;
@@ -1696,18 +1737,18 @@ TAC* genCodeForFuncCall(ASTNode* node){
         exit(1);
     } 
 
-    ASTNode* argList = node->func_call_data.arg_list;
+    ASTNode* argList = astNode(node->func_call_data.arg_list);
     int argCnt = node->func_call_data.arg_count;
 
     TAC* code_arg_list = genCodeForArgList(argList, argCnt);
     appendComments(code_arg_list, "PUSH ARGS");
 
-    Operand* opr1 = makeOperand(ID_REF, node->func_call_data.id->id_ref_data.name);
-    char* temp_var = newTempVar();
+    Operand* opr1 = makeOperand(ID_REF, astNode(node->func_call_data.id)->id_ref_data.name);
+    const char* temp_var = newTempVar();
     TAC* code_func_call = createTAC(TAC_CALL, temp_var, opr1, NULL);
     appendTAC(codeList, code_func_call);
     appendComments(code_func_call, "FUNC CALL BEGIN");
-    appendFuncCallTAC(code_func_call, node->func_call_data.id->id_ref_data.ref->func_node->func_decl_data.global_id);
+    appendFuncCallTAC(code_func_call, astNode(node->func_call_data.id)->id_ref_data.ref->func_node->func_decl_data.global_id);
     
     Operand* ret_val = makeOperand(ID_REF, ret_val_var);
     TAC* code_ret_val = createTAC(TAC_ASSIGN, temp_var, ret_val, NULL);
@@ -1729,21 +1770,22 @@ TAC* generateCode(ASTNode* node, BoolExprInfo* bool_info) {
 
     switch (node->type) {
         case NODE_PROGRAM:{
-            result = generateCode(node->program_data.stmt_list, bool_info);
+            result = generateCode(astNode(node->program_data.stmt_list), bool_info);
             break;
         }
         case NODE_STMT_LIST:{
-            generateCode(node->stmt_list_data.stmt_list, bool_info);
-            result = generateCode(node->stmt_list_data.stmt, bool_info);
+            for (int i = 0; i < node->list_data.count; i++) {
+                result = generateCode(astNode(node->list_data.items[i]), bool_info);
+            }
             break;
         }
         case NODE_STMT:{
-            result = generateCode(node->stmt_data.stmt, bool_info);
+            result = generateCode(astNode(node->stmt_data.stmt), bool_info);
             break;
         }
         case NODE_EXPR_COMMA_LIST:{
-            generateCode(node->expr_comma_list_data.expr_comma_list, bool_info);
-            TAC* code = generateCode(node->expr_comma_list_data.expr_comma_list_item, bool_info);
+            generateCode(astNode(node->expr_comma_list_data.expr_comma_list), bool_info);
+            TAC* code = generateCode(astNode(node->expr_comma_list_data.expr_comma_list_item), bool_info);
             if(bool_info->begin_tac == NULL) bool_info->begin_tac = code;
             bool_info->end_tac = code;
             result = code;
@@ -1768,7 +1810,7 @@ TAC* generateCode(ASTNode* node, BoolExprInfo* bool_info) {
             break;
 
         case NODE_BLOCK_STMT:
-            result = generateCode(node->block_stmt_data.stmt_list, bool_info);
+            result = generateCode(astNode(node->block_stmt_data.stmt_list), bool_info);
             break;
         case NODE_IF_ELSE:
             result = genCodeForIfElse(node, bool_info);
@@ -1796,7 +1838,7 @@ TAC* generateCode(ASTNode* node, BoolExprInfo* bool_info) {
             break;
         }
         case NODE_FUNC_BODY:
-            result = generateCode(node->block_stmt_data.stmt_list, bool_info);
+            result = generateCode(astNode(node->block_stmt_data.stmt_list), bool_info);
             break;
         case NODE_FUNC_CALL:
             result = genCodeForFuncCall(node);
@@ -1954,8 +1996,8 @@ static ASTNode* traceOrigin(TAC* tac) {
 static void setVisitOrigin(ICGNodeVisit* event, ASTNode* node) {
     event->ast_node_id = node ? node->node_id : -1;
     event->node_type = node ? getNodeName(node->type) : "UNKNOWN";
-    event->line_no = node ? node->line_no : 0;
-    event->char_no = node ? node->char_no : 0;
+    event->line_no = node ? nodeSpan(node)->start_line : 0;
+    event->char_no = node ? nodeSpan(node)->start_col : 0;
 }
 
 static int findOrCreateTraceLabel(
@@ -1985,8 +2027,8 @@ static void logTracePatch(
     step.type = ICG_PATCH_LABEL;
     step.ICGPatchLabel.ast_node_id = origin ? origin->node_id : -1;
     step.ICGPatchLabel.node_type = origin ? getNodeName(origin->type) : "UNKNOWN";
-    step.ICGPatchLabel.line_no = origin ? origin->line_no : 0;
-    step.ICGPatchLabel.char_no = origin ? origin->char_no : 0;
+    step.ICGPatchLabel.line_no = origin ? nodeSpan(origin)->start_line : 0;
+    step.ICGPatchLabel.char_no = origin ? nodeSpan(origin)->start_col : 0;
     step.ICGPatchLabel.instruction_no = patch->instruction_no;
     step.ICGPatchLabel.label_name = label->name;
     step.ICGPatchLabel.text = text;
@@ -1994,7 +2036,7 @@ static void logTracePatch(
 }
 
 void logICGPlaybackTrace() {
-    if (!codeList) return;
+    if (!codeList || !isTraceOn()) return;
 
     int capacity = instructionCounter + 8;
     ICGTraceLabel* labels = calloc((size_t)capacity, sizeof(ICGTraceLabel));
@@ -2023,8 +2065,8 @@ void logICGPlaybackTrace() {
             createLabel.type = ICG_CREATE_LABEL;
             createLabel.ICGCreateLabel.ast_node_id = origin ? origin->node_id : -1;
             createLabel.ICGCreateLabel.node_type = origin ? getNodeName(origin->type) : "UNKNOWN";
-            createLabel.ICGCreateLabel.line_no = origin ? origin->line_no : 0;
-            createLabel.ICGCreateLabel.char_no = origin ? origin->char_no : 0;
+            createLabel.ICGCreateLabel.line_no = origin ? nodeSpan(origin)->start_line : 0;
+            createLabel.ICGCreateLabel.char_no = origin ? nodeSpan(origin)->start_col : 0;
             createLabel.ICGCreateLabel.label_name = label->name;
             createLabel.ICGCreateLabel.target_tac_id = label->target_tac_id;
             log_step(createLabel);
@@ -2035,8 +2077,8 @@ void logICGPlaybackTrace() {
             emitLabel.type = ICG_EMIT;
             emitLabel.ICGEmit.ast_node_id = origin ? origin->node_id : -1;
             emitLabel.ICGEmit.node_type = origin ? getNodeName(origin->type) : "UNKNOWN";
-            emitLabel.ICGEmit.line_no = origin ? origin->line_no : 0;
-            emitLabel.ICGEmit.char_no = origin ? origin->char_no : 0;
+            emitLabel.ICGEmit.line_no = origin ? nodeSpan(origin)->start_line : 0;
+            emitLabel.ICGEmit.char_no = origin ? nodeSpan(origin)->start_col : 0;
             emitLabel.ICGEmit.instruction_no = display_instruction_no++;
             emitLabel.ICGEmit.source_tac_id = 0;
             emitLabel.ICGEmit.opcode = "LABEL";
@@ -2058,8 +2100,8 @@ void logICGPlaybackTrace() {
             enter.type = ICG_ENTER_FUNCTION;
             enter.ICGFunctionEvent.ast_node_id = functionNode ? functionNode->node_id : -1;
             enter.ICGFunctionEvent.node_type = functionNode ? getNodeName(functionNode->type) : "UNKNOWN";
-            enter.ICGFunctionEvent.line_no = functionNode ? functionNode->line_no : 0;
-            enter.ICGFunctionEvent.char_no = functionNode ? functionNode->char_no : 0;
+            enter.ICGFunctionEvent.line_no = functionNode ? nodeSpan(functionNode)->start_line : 0;
+            enter.ICGFunctionEvent.char_no = functionNode ? nodeSpan(functionNode)->start_col : 0;
             enter.ICGFunctionEvent.function_name = tac->enter_function;
             log_step(enter);
         }
@@ -2070,7 +2112,7 @@ void logICGPlaybackTrace() {
         visit.ICGNodeVisit.action = "Lower AST node";
         visit.ICGNodeVisit.operator_name =
             origin && (origin->type == NODE_EXPR_BINARY || origin->type == NODE_EXPR_UNARY)
-                ? origin->expr_data.op
+                ? getOperatorName(origin->expr_data.op)
                 : NULL;
         log_step(visit);
 
@@ -2088,8 +2130,8 @@ void logICGPlaybackTrace() {
                 createTemp.type = ICG_CREATE_TEMP;
                 createTemp.ICGCreateTemp.ast_node_id = origin ? origin->node_id : -1;
                 createTemp.ICGCreateTemp.node_type = origin ? getNodeName(origin->type) : "UNKNOWN";
-                createTemp.ICGCreateTemp.line_no = origin ? origin->line_no : 0;
-                createTemp.ICGCreateTemp.char_no = origin ? origin->char_no : 0;
+                createTemp.ICGCreateTemp.line_no = origin ? nodeSpan(origin)->start_line : 0;
+                createTemp.ICGCreateTemp.char_no = origin ? nodeSpan(origin)->start_col : 0;
                 createTemp.ICGCreateTemp.temp_name = tac->result;
                 log_step(createTemp);
             }
@@ -2109,8 +2151,8 @@ void logICGPlaybackTrace() {
         emit.type = ICG_EMIT;
         emit.ICGEmit.ast_node_id = origin ? origin->node_id : -1;
         emit.ICGEmit.node_type = origin ? getNodeName(origin->type) : "UNKNOWN";
-        emit.ICGEmit.line_no = origin ? origin->line_no : 0;
-        emit.ICGEmit.char_no = origin ? origin->char_no : 0;
+        emit.ICGEmit.line_no = origin ? nodeSpan(origin)->start_line : 0;
+        emit.ICGEmit.char_no = origin ? nodeSpan(origin)->start_col : 0;
         emit.ICGEmit.instruction_no = emitted_no;
         emit.ICGEmit.source_tac_id = tac->tac_id;
         emit.ICGEmit.opcode = getTACOpcodeName(tac->op);
@@ -2138,8 +2180,8 @@ void logICGPlaybackTrace() {
             exitStep.type = ICG_EXIT_FUNCTION;
             exitStep.ICGFunctionEvent.ast_node_id = functionNode ? functionNode->node_id : -1;
             exitStep.ICGFunctionEvent.node_type = functionNode ? getNodeName(functionNode->type) : "UNKNOWN";
-            exitStep.ICGFunctionEvent.line_no = functionNode ? functionNode->line_no : 0;
-            exitStep.ICGFunctionEvent.char_no = functionNode ? functionNode->char_no : 0;
+            exitStep.ICGFunctionEvent.line_no = functionNode ? nodeSpan(functionNode)->start_line : 0;
+            exitStep.ICGFunctionEvent.char_no = functionNode ? nodeSpan(functionNode)->start_col : 0;
             exitStep.ICGFunctionEvent.function_name = tac->exit_function;
             log_step(exitStep);
         }
@@ -2154,8 +2196,8 @@ void logICGPlaybackTrace() {
         createLabel.type = ICG_CREATE_LABEL;
         createLabel.ICGCreateLabel.ast_node_id = origin ? origin->node_id : -1;
         createLabel.ICGCreateLabel.node_type = origin ? getNodeName(origin->type) : "UNKNOWN";
-        createLabel.ICGCreateLabel.line_no = origin ? origin->line_no : 0;
-        createLabel.ICGCreateLabel.char_no = origin ? origin->char_no : 0;
+        createLabel.ICGCreateLabel.line_no = origin ? nodeSpan(origin)->start_line : 0;
+        createLabel.ICGCreateLabel.char_no = origin ? nodeSpan(origin)->start_col : 0;
         createLabel.ICGCreateLabel.label_name = label->name;
         createLabel.ICGCreateLabel.target_tac_id = label->target_tac_id;
         log_step(createLabel);
@@ -2166,8 +2208,8 @@ void logICGPlaybackTrace() {
         emitLabel.type = ICG_EMIT;
         emitLabel.ICGEmit.ast_node_id = origin ? origin->node_id : -1;
         emitLabel.ICGEmit.node_type = origin ? getNodeName(origin->type) : "UNKNOWN";
-        emitLabel.ICGEmit.line_no = origin ? origin->line_no : 0;
-        emitLabel.ICGEmit.char_no = origin ? origin->char_no : 0;
+        emitLabel.ICGEmit.line_no = origin ? nodeSpan(origin)->start_line : 0;
+        emitLabel.ICGEmit.char_no = origin ? nodeSpan(origin)->start_col : 0;
         emitLabel.ICGEmit.instruction_no = display_instruction_no++;
         emitLabel.ICGEmit.source_tac_id = 0;
         emitLabel.ICGEmit.opcode = "LABEL";
@@ -64,12 +64,12 @@ typedef struct Operand{
     union{
         int int_val;
         char char_val;
-        char* str_val;
+        const char* str_val;
         struct{
             char* val;
         }void_val;
         struct{
-            char* name;
+            const char* name;   // Interned
             symbol* sym;
         }id_ref;
 
@@ -101,6 +101,8 @@ typedef struct TAC {
     const char* enter_function;
     const char* exit_function;
 
+    bool is_removed;   // Marked by an optimization pass, dropped by compactTAC()
+
     struct TAC* next;  // Linked list of instructions
 } TAC;
 
@@ -143,18 +145,30 @@ typedef struct LoopInfo {
   List* continueList;
 } LoopInfo;
 
+extern TACList* codeList;
+
 void setICGDebugger();
 void startICG(ASTNode* root);
 void startICGforFunctions(FuncQ* funcQ);
+// Releases codeList and every TAC, Operand, List and Label it references
+void freeICG();
+// Allocations made by the ICG arena since the last freeICG()
+void getICGArenaUsage(size_t* allocations, size_t* bytes);
+int countTAC(const TACList* code);
 
 TACList* createTACList(); 
 FuncQ* createFuncQ();
 // Function to create a new temporary variable
-char* newTempVar();
+const char* newTempVar();
 
 // Function to create a new label
 char* newLabel();
 
+// Name used for a variable in TAC, e.g. "x_3" for x declared in scope 3
+char* generateScopeSuffixedName(const char* name, int scope_id);
+// Interned TAC name of a symbol, built on first use and cached on the symbol
+const char* getSymbolTACName(symbol* sym);
+
 // Functions to generate TAC code for expressions, assignments, etc.
 const char* getOperatorString(TACOp op);
 TAC* generateCode(ASTNode* node, BoolExprInfo* bool_info);
@@ -167,7 +181,8 @@ void appendComments(TAC* instr, const char* new_comment);
 
 
 // Function to create a TAC instruction
-TAC* createTAC(TACOp op, char* result, Operand* operand1, Operand* operand2);
+TAC* createTAC(TACOp op, const char* result, Operand* operand1, Operand* operand2);
+Operand* makeOperand(ValueType type, const void* val);
 
 void appendTAC(TACList* list, TAC* newTAC);
 void appendFuncDecl(FuncQ* funcQ, ASTNode* func_decl);
@@ -175,6 +190,7 @@ ASTNode* dequeue(FuncQ* funcQ);
 
 // Function to print the generated TAC
 void printTAC();
+void printTACInstruction(TAC* instr);
 void logICGPlaybackTrace();
 
 
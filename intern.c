@@ -0,0 +1,144 @@
+#include "intern.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define INTERN_BLOCK_SIZE (32 * 1024)
+#define INTERN_INITIAL_CAPACITY 1024
+
+static bool isInternDebugOn = false;
+void setInternDebugger(){
+    isInternDebugOn = true;
+}
+
+// Characters of every interned string, never moved once stored
+typedef struct InternBlock {
+    struct InternBlock* next;
+    size_t used;
+    size_t capacity;
+    char data[];
+} InternBlock;
+
+typedef struct InternEntry {
+    unsigned int hash;
+    const char* str;     // NULL for an empty slot
+} InternEntry;
+
+typedef struct InternTable {
+    InternEntry* entries;
+    int count;
+    int capacity;        // Power of two
+    InternBlock* blocks;
+} InternTable;
+
+static InternTable table;
+
+unsigned int hashBytes(const void* data, size_t len) {
+    const unsigned char* bytes = data;
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+unsigned int hashInterned(const char* str) {
+    // Fibonacci hashing, the low bits of an address are mostly alignment
+    unsigned long long key = (unsigned long long)(size_t)str;
+    return (unsigned int)((key * 11400714819323198485ull) >> 32);
+}
+
+static char* storeString(const char* str, size_t len) {
+    if (!table.blocks || table.blocks->used + len + 1 > table.blocks->capacity) {
+        size_t capacity = len + 1 > INTERN_BLOCK_SIZE ? len + 1 : INTERN_BLOCK_SIZE;
+        InternBlock* block = malloc(sizeof(InternBlock) + capacity);
+        if (!block) {
+            fprintf(stderr, "Memory allocation failed for intern table\n");
+            exit(1);
+        }
+        block->next = table.blocks;
+        block->used = 0;
+        block->capacity = capacity;
+        table.blocks = block;
+    }
+    char* copy = table.blocks->data + table.blocks->used;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    table.blocks->used += len + 1;
+    return copy;
+}
+
+static void growTable(void) {
+    int capacity = table.capacity ? table.capacity * 2 : INTERN_INITIAL_CAPACITY;
+    InternEntry* entries = calloc(capacity, sizeof(InternEntry));
+    if (!entries) {
+        fprintf(stderr, "Memory allocation failed for intern table\n");
+        exit(1);
+    }
+    unsigned int mask = capacity - 1;
+    for (int i = 0; i < table.capacity; i++) {
+        if (!table.entries[i].str) continue;
+        unsigned int pos = table.entries[i].hash & mask;
+        while (entries[pos].str) pos = (pos + 1) & mask;
+        entries[pos] = table.entries[i];
+    }
+    free(table.entries);
+    table.entries = entries;
+    table.capacity = capacity;
+}
+
+const char* internN(const char* str, size_t len) {
+    if (!str) return NULL;
+    if (!table.entries) initInternTable();
+
+    unsigned int hash = hashBytes(str, len);
+    unsigned int mask = table.capacity - 1;
+    unsigned int pos = hash & mask;
+    while (table.entries[pos].str) {
+        const InternEntry* entry = &table.entries[pos];
+        if (entry->hash == hash && strncmp(entry->str, str, len) == 0 && entry->str[len] == '\0') {
+            return entry->str;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    // Keep the load factor under one half
+    if ((table.count + 1) * 2 > table.capacity) {
+        growTable();
+        mask = table.capacity - 1;
+        pos = hash & mask;
+        while (table.entries[pos].str) pos = (pos + 1) & mask;
+    }
+    table.entries[pos].hash = hash;
+    table.entries[pos].str = storeString(str, len);
+    table.count++;
+    return table.entries[pos].str;
+}
+
+int getInternCount(void) {
+    return table.count;
+}
+
+const char* intern(const char* str) {
+    return str ? internN(str, strlen(str)) : NULL;
+}
+
+void initInternTable(void) {
+    if (table.entries) return;
+    growTable();
+}
+
+void freeInternTable(void) {
+    size_t bytes = 0;
+    while (table.blocks) {
+        InternBlock* next = table.blocks->next;
+        bytes += table.blocks->used;
+        free(table.blocks);
+        table.blocks = next;
+    }
+    if (isInternDebugOn) printf("[INTERN] %d strings, %zu bytes\n", table.count, bytes);
+    free(table.entries);
+    memset(&table, 0, sizeof(table));
+}
@@ -0,0 +1,25 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+
+void setInternDebugger();
+
+void initInternTable(void);
+void freeInternTable(void);
+
+// Returns the single stored copy of str. Equal strings give the same pointer,
+// so interned strings are compared with == instead of strcmp.
+const char* intern(const char* str);
+const char* internN(const char* str, size_t len);
+
+// Number of distinct strings stored so far
+int getInternCount(void);
+
+// 32-bit FNV-1a of len bytes, the hash behind the intern table
+unsigned int hashBytes(const void* data, size_t len);
+
+// Hash of an interned string's address, for tables keyed by interned pointers
+unsigned int hashInterned(const char* str);
+
+#endif
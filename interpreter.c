@@ -0,0 +1,369 @@
+#include "interpreter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define MAX_CALL_DEPTH 10000
+
+static bool isInterpreterDebugOn = false;
+void setInterpreterDebugger(){
+    isInterpreterDebugOn = true;
+}
+
+typedef struct CallFrame {
+    int return_pc;
+    int function;
+    int frame_base;
+    int arg_base;
+} CallFrame;
+
+// Program lowered by runTAC() and the globals of the last run
+static BytecodeProgram* loadedProgram = NULL;
+static const BytecodeProgram* lastProgram = NULL;
+static RuntimeValue* globals = NULL;
+
+static int isTruthy(RuntimeValue value) {
+    switch (value.type) {
+        case STR_VAL:  return value.str_val != NULL;
+        case VOID_VAL: return 0;
+        default:       return value.int_val != 0;
+    }
+}
+
+static RuntimeValue makeInt(int value) {
+    RuntimeValue v;
+    v.type = INT_VAL;
+    v.int_val = value;
+    return v;
+}
+
+static void runtimeError(const BytecodeProgram* program, int pc, const char* message) {
+    fprintf(stderr, "Runtime error at TAC %d (%s): %s\n",
+        program->tac_ids[pc], getBCOpString(program->code[pc].op), message);
+}
+
+static double elapsedMs(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static void nowTimespec(struct timespec* ts) {
+#ifdef _WIN32
+    timespec_get(ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, ts);
+#endif
+}
+
+InterpreterStatus runTAC(TACList* code, InterpreterStats* stats) {
+    InterpreterStats local_stats = {0};
+    if (!stats) stats = &local_stats;
+    memset(stats, 0, sizeof(*stats));
+
+    freeInterpreter();
+
+    struct timespec start, end;
+    nowTimespec(&start);
+    loadedProgram = lowerTACToBytecode(code);
+    nowTimespec(&end);
+    if (!loadedProgram) return INTERP_RUNTIME_ERROR;
+
+    if (isInterpreterDebugOn) {
+        printf("\nBytecode---------------------------------\n\n");
+        printBytecode(loadedProgram);
+        printf("\n");
+    }
+
+    InterpreterStatus status = runBytecode(loadedProgram, stats);
+    stats->lower_time_ms = elapsedMs(start, end);
+    return status;
+}
+
+InterpreterStatus runBytecode(const BytecodeProgram* program, InterpreterStats* stats) {
+    InterpreterStats local_stats = {0};
+    if (!stats) stats = &local_stats;
+    memset(stats, 0, sizeof(*stats));
+    if (!program) return INTERP_RUNTIME_ERROR;
+
+    stats->instruction_count = program->code_count;
+    stats->slot_count = program->slot_count;
+
+    free(globals);
+    lastProgram = program;
+    globals = malloc(sizeof(RuntimeValue) * (program->global_count + 1));
+    int frameCapacity = 1024;
+    RuntimeValue* frameStack = malloc(sizeof(RuntimeValue) * frameCapacity);
+    int argCapacity = 256;
+    RuntimeValue* argStack = malloc(sizeof(RuntimeValue) * argCapacity);
+    CallFrame* callStack = malloc(sizeof(CallFrame) * (MAX_CALL_DEPTH + 1));
+    if (!globals || !frameStack || !argStack || !callStack) {
+        fprintf(stderr, "Memory allocation failed for interpreter state\n");
+        exit(1);
+    }
+    for (int i = 0; i < program->global_count; i++) globals[i] = makeInt(0);
+
+    const BCInstr* code = program->code;
+    const BCFunction* functions = program->functions;
+    int depth = 0;
+    int frameBase = 0;
+    int frameTop = 0;
+    int argTop = 0;
+    callStack[0].return_pc = -1;
+    callStack[0].function = 0;
+    callStack[0].frame_base = 0;
+    callStack[0].arg_base = 0;
+
+    InterpreterStatus status = INTERP_SUCCESS;
+    long long executed = 0;
+    struct timespec start, end;
+    nowTimespec(&start);
+
+    int pc = 0;
+    RuntimeValue operands[2];
+    while (pc < program->code_count) {
+        const BCInstr* ins = &code[pc];
+        executed++;
+        if (isInterpreterDebugOn) {
+            printf("[INTERP] depth %d | ", depth);
+            printBytecodeInstr(program, pc);
+        }
+
+        // Fetch a and b
+        for (int k = 0; k < 2; k++) {
+            uint8_t mode = k == 0 ? ins->a_mode : ins->b_mode;
+            int32_t value = k == 0 ? ins->a : ins->b;
+            RuntimeValue* v = &operands[k];
+            switch (mode) {
+                case BC_MODE_INT:    v->type = INT_VAL; v->int_val = value; break;
+                case BC_MODE_CHAR:   v->type = CHAR_VAL; v->int_val = value; break;
+                case BC_MODE_STR:    v->type = STR_VAL; v->str_val = program->strings[value]; break;
+                case BC_MODE_GLOBAL: *v = globals[value]; break;
+                case BC_MODE_LOCAL:  *v = frameStack[frameBase + value]; break;
+                case BC_MODE_ARG:    *v = argStack[callStack[depth].arg_base + value]; break;
+                default:             v->type = VOID_VAL; v->int_val = 0; break;
+            }
+        }
+        RuntimeValue l = operands[0];
+        RuntimeValue r = operands[1];
+        RuntimeValue result;
+        int writes = 1;
+
+        switch (ins->op) {
+            case BC_MOV:
+                result = l;
+                break;
+            case BC_ADD:
+            case BC_SUB:
+            case BC_MUL:
+            case BC_DIV:
+            case BC_LT:
+            case BC_GT:
+            case BC_LEQ:
+            case BC_GEQ:
+                if (l.type == STR_VAL || r.type == STR_VAL || l.type == VOID_VAL || r.type == VOID_VAL) {
+                    runtimeError(program, pc, "operands must be int or char");
+                    status = INTERP_RUNTIME_ERROR;
+                    goto done;
+                }
+                result.type = (l.type == CHAR_VAL && r.type == CHAR_VAL) ? CHAR_VAL : INT_VAL;
+                // Arithmetic wraps like the machine code the other backends emit
+                switch (ins->op) {
+                    case BC_ADD: result.int_val = (int)((unsigned int)l.int_val + (unsigned int)r.int_val); break;
+                    case BC_SUB: result.int_val = (int)((unsigned int)l.int_val - (unsigned int)r.int_val); break;
+                    case BC_MUL: result.int_val = (int)((unsigned int)l.int_val * (unsigned int)r.int_val); break;
+                    case BC_DIV:
+                        if (r.int_val == 0) {
+                            runtimeError(program, pc, "division by zero");
+                            status = INTERP_RUNTIME_ERROR;
+                            goto done;
+                        }
+                        // INT_MIN / -1 overflows, dividing by -1 is a wrapping negation
+                        if (r.int_val == -1) result.int_val = (int)(0u - (unsigned int)l.int_val);
+                        else result.int_val = l.int_val / r.int_val;
+                        break;
+                    case BC_LT:  result = makeInt(l.int_val <  r.int_val); break;
+                    case BC_GT:  result = makeInt(l.int_val >  r.int_val); break;
+                    case BC_LEQ: result = makeInt(l.int_val <= r.int_val); break;
+                    default:     result = makeInt(l.int_val >= r.int_val); break;
+                }
+                break;
+            case BC_EQ:
+            case BC_NEQ: {
+                int equal;
+                if (l.type == STR_VAL && r.type == STR_VAL) {
+                    equal = strcmp(l.str_val, r.str_val) == 0;
+                } else if (l.type == STR_VAL || r.type == STR_VAL) {
+                    equal = 0;
+                } else {
+                    equal = l.int_val == r.int_val;
+                }
+                result = makeInt(ins->op == BC_EQ ? equal : !equal);
+                break;
+            }
+            case BC_AND:
+                result = makeInt(isTruthy(l) && isTruthy(r));
+                break;
+            case BC_OR:
+                result = makeInt(isTruthy(l) || isTruthy(r));
+                break;
+            case BC_NOT:
+                result = makeInt(!isTruthy(l));
+                break;
+            case BC_NEG:
+                if (l.type == STR_VAL || l.type == VOID_VAL) {
+                    runtimeError(program, pc, "operand must be int or char");
+                    status = INTERP_RUNTIME_ERROR;
+                    goto done;
+                }
+                result = makeInt((int)(0u - (unsigned int)l.int_val));
+                break;
+            case BC_PRE_INC:
+            case BC_PRE_DEC:
+            case BC_POST_INC:
+            case BC_POST_DEC: {
+                int delta = (ins->op == BC_PRE_INC || ins->op == BC_POST_INC) ? 1 : -1;
+                RuntimeValue updated = makeInt((int)((unsigned int)l.int_val + (unsigned int)delta));
+                if (ins->a_mode == BC_MODE_GLOBAL) globals[ins->a] = updated;
+                else if (ins->a_mode == BC_MODE_LOCAL) frameStack[frameBase + ins->a] = updated;
+                result = (ins->op == BC_PRE_INC || ins->op == BC_PRE_DEC) ? updated : l;
+                break;
+            }
+            case BC_JMP:
+            case BC_JMP_IF:
+            case BC_JMP_IF_NOT: {
+                if ((ins->op == BC_JMP_IF && !isTruthy(l)) || (ins->op == BC_JMP_IF_NOT && isTruthy(l))) {
+                    pc++;
+                    continue;
+                }
+                pc = ins->dst;
+                // A jump out of the current function returns from it
+                const BCFunction* fn = &functions[callStack[depth].function];
+                if (depth > 0 && (pc < fn->entry || pc >= fn->end)) goto returnFromCall;
+                continue;
+            }
+            case BC_PUSH_ARG:
+                if (argTop == argCapacity) {
+                    argCapacity *= 2;
+                    argStack = realloc(argStack, sizeof(RuntimeValue) * argCapacity);
+                    if (!argStack) {
+                        fprintf(stderr, "Memory allocation failed for interpreter arg stack\n");
+                        exit(1);
+                    }
+                }
+                argStack[argTop++] = l;
+                writes = 0;
+                break;
+            case BC_CALL: {
+                const BCFunction* callee = &functions[ins->a];
+                if (depth + 1 >= MAX_CALL_DEPTH) {
+                    runtimeError(program, pc, "call stack overflow");
+                    status = INTERP_RUNTIME_ERROR;
+                    goto done;
+                }
+                if (argTop < callee->param_count) {
+                    runtimeError(program, pc, "not enough arguments pushed");
+                    status = INTERP_RUNTIME_ERROR;
+                    goto done;
+                }
+                if (frameTop + callee->frame_size > frameCapacity) {
+                    while (frameTop + callee->frame_size > frameCapacity) frameCapacity *= 2;
+                    frameStack = realloc(frameStack, sizeof(RuntimeValue) * frameCapacity);
+                    if (!frameStack) {
+                        fprintf(stderr, "Memory allocation failed for interpreter frames\n");
+                        exit(1);
+                    }
+                }
+                depth++;
+                callStack[depth].return_pc = pc + 1;
+                callStack[depth].function = ins->a;
+                callStack[depth].frame_base = frameTop;
+                callStack[depth].arg_base = argTop - callee->param_count;
+                frameBase = frameTop;
+                for (int i = 0; i < callee->frame_size; i++) frameStack[frameTop + i] = makeInt(0);
+                frameTop += callee->frame_size;
+
+                stats->calls++;
+                if (depth > stats->max_call_depth) stats->max_call_depth = depth;
+                pc = callee->entry;
+                continue;
+            }
+            case BC_RET: {
+                if (depth == 0) {
+                    // return at the top level ends the program
+                    pc = program->code_count;
+                    continue;
+                }
+            returnFromCall: ;
+                CallFrame* frame = &callStack[depth];
+                pc = frame->return_pc;
+                argTop = frame->arg_base;
+                frameTop = frame->frame_base;
+                depth--;
+                frameBase = callStack[depth].frame_base;
+                continue;
+            }
+            case BC_END:
+                pc = program->code_count;
+                continue;
+            default:
+                runtimeError(program, pc, "unsupported instruction");
+                status = INTERP_RUNTIME_ERROR;
+                goto done;
+        }
+
+        if (writes) {
+            if (ins->dst_mode == BC_MODE_GLOBAL) globals[ins->dst] = result;
+            else if (ins->dst_mode == BC_MODE_LOCAL) frameStack[frameBase + ins->dst] = result;
+        }
+        pc++;
+    }
+
+done:
+    nowTimespec(&end);
+    stats->instructions_executed = executed;
+    stats->wall_time_ms = elapsedMs(start, end);
+
+    free(frameStack);
+    free(argStack);
+    free(callStack);
+    return status;
+}
+
+void printInterpreterStats(const InterpreterStats* stats) {
+    if (!stats) return;
+    printf("\nExecutionStats---------------------------\n\n");
+    printf("Instructions loaded    : %d\n", stats->instruction_count);
+    printf("Slots (vars + temps)   : %d\n", stats->slot_count);
+    printf("Instructions executed  : %lld\n", stats->instructions_executed);
+    printf("Function calls         : %lld\n", stats->calls);
+    printf("Max call depth         : %d\n", stats->max_call_depth);
+    printf("Lowering time          : %.3f ms\n", stats->lower_time_ms);
+    printf("Wall time              : %.3f ms\n", stats->wall_time_ms);
+}
+
+// Print the final value of every top level variable
+void printInterpreterGlobals() {
+    if (!globals || !lastProgram) return;
+    printf("\nProgramState-----------------------------\n\n");
+    for (int id = 0; id < lastProgram->slot_count; id++) {
+        const BCSlot* slot = &lastProgram->slots[id];
+        if (slot->is_local || slot->is_temp) continue;
+
+        RuntimeValue v = globals[slot->index];
+        switch (v.type) {
+            case CHAR_VAL: printf("%s = '%c'\n", slot->name, v.int_val); break;
+            case STR_VAL:  printf("%s = %s\n", slot->name, v.str_val); break;
+            case VOID_VAL: printf("%s = VOID\n", slot->name); break;
+            default:       printf("%s = %d\n", slot->name, v.int_val); break;
+        }
+    }
+}
+
+void freeInterpreter() {
+    freeBytecode(loadedProgram);
+    free(globals);
+    loadedProgram = NULL;
+    lastProgram = NULL;
+    globals = NULL;
+}
@@ -0,0 +1,41 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "ast.h"
+#include "icg.h"
+#include "bytecode.h"
+
+typedef enum {
+    INTERP_SUCCESS,
+    INTERP_RUNTIME_ERROR
+} InterpreterStatus;
+
+// Runtime value held in a variable/temporary slot
+typedef struct RuntimeValue {
+    ValueType type;         // INT_VAL, CHAR_VAL, STR_VAL or VOID_VAL
+    union {
+        int int_val;
+        const char* str_val;
+    };
+} RuntimeValue;
+
+typedef struct InterpreterStats {
+    long long instructions_executed;
+    long long calls;
+    int max_call_depth;
+    int instruction_count;  // Static bytecode instructions loaded
+    int slot_count;         // Distinct variables + temporaries
+    double lower_time_ms;   // TAC -> bytecode
+    double wall_time_ms;
+} InterpreterStats;
+
+void setInterpreterDebugger();
+
+// Lowers the TAC list produced by startICG() to bytecode and executes it
+InterpreterStatus runTAC(TACList* code, InterpreterStats* stats);
+InterpreterStatus runBytecode(const BytecodeProgram* program, InterpreterStats* stats);
+void printInterpreterStats(const InterpreterStats* stats);
+void printInterpreterGlobals();
+void freeInterpreter();
+
+#endif
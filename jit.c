@@ -0,0 +1,536 @@
+#include "jit.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#define JIT_MAX_CALL_DEPTH 10000
+
+// Registers as encoded in ModRM
+#define REG_RAX 0
+#define REG_RCX 1
+#define REG_RBX 3   // Base of the globals array
+#define REG_RBP 5
+
+static bool isJITDebugOn = false;
+void setJITDebugger(){
+    isJITDebugOn = true;
+}
+
+typedef enum {
+    FIX_PC,          // Bytecode instruction
+    FIX_FUNC,        // Function entry
+    FIX_END,         // Normal end of the program
+    FIX_FUNC_END,    // Trailing return of a function
+    FIX_DIV_ZERO,
+    FIX_OVERFLOW
+} FixupKind;
+
+typedef struct Fixup {
+    int pos;         // Offset of the rel32 to patch
+    FixupKind kind;
+    int index;
+} Fixup;
+
+typedef struct Emitter {
+    uint8_t* buf;
+    int size;
+    int capacity;
+
+    Fixup* fixups;
+    int fixup_count;
+    int fixup_capacity;
+
+    const BytecodeProgram* program;
+    int function;    // Function being encoded
+    int* pcOffset;
+    int* funcOffset;
+    int* funcEndOffset;
+    int endOffset;
+    int divZeroOffset;
+    int overflowOffset;
+} Emitter;
+
+static void emit8(Emitter* e, uint8_t byte) {
+    if (e->size == e->capacity) {
+        e->capacity = e->capacity ? e->capacity * 2 : 4096;
+        e->buf = realloc(e->buf, e->capacity);
+        if (!e->buf) {
+            fprintf(stderr, "Memory allocation failed for JIT code buffer\n");
+            exit(1);
+        }
+    }
+    e->buf[e->size++] = byte;
+}
+
+static void emitBytes(Emitter* e, const uint8_t* bytes, int count) {
+    for (int i = 0; i < count; i++) emit8(e, bytes[i]);
+}
+
+static void emit32(Emitter* e, int32_t value) {
+    uint32_t v = (uint32_t)value;
+    for (int i = 0; i < 4; i++) emit8(e, (v >> (8 * i)) & 0xFF);
+}
+
+static void emit64(Emitter* e, uint64_t value) {
+    for (int i = 0; i < 8; i++) emit8(e, (value >> (8 * i)) & 0xFF);
+}
+
+#define EMIT(e, ...) do { \
+    const uint8_t bytes_[] = { __VA_ARGS__ }; \
+    emitBytes((e), bytes_, sizeof(bytes_)); \
+} while (0)
+
+// Emits a rel32 that is patched once every target offset is known
+static void emitFixup(Emitter* e, FixupKind kind, int index) {
+    if (e->fixup_count == e->fixup_capacity) {
+        e->fixup_capacity = e->fixup_capacity ? e->fixup_capacity * 2 : 64;
+        e->fixups = realloc(e->fixups, sizeof(Fixup) * e->fixup_capacity);
+        if (!e->fixups) {
+            fprintf(stderr, "Memory allocation failed for JIT fixups\n");
+            exit(1);
+        }
+    }
+    e->fixups[e->fixup_count].pos = e->size;
+    e->fixups[e->fixup_count].kind = kind;
+    e->fixups[e->fixup_count].index = index;
+    e->fixup_count++;
+    emit32(e, 0);
+}
+
+// REX.W <opcode> [base + disp32] with reg in ModRM.reg
+static void emitMemOp(Emitter* e, uint8_t opcode, int reg, int base, int32_t disp) {
+    EMIT(e, 0x48, opcode, (uint8_t)(0x80 | (reg << 3) | base));
+    emit32(e, disp);
+}
+
+static int32_t argDisp(Emitter* e, int32_t arg) {
+    // Arguments are pushed in order, so the last one sits right above the return address
+    return 16 + 8 * (e->program->functions[e->function].param_count - 1 - arg);
+}
+
+static void emitLoad(Emitter* e, uint8_t mode, int32_t value, int reg) {
+    switch (mode) {
+        case BC_MODE_INT:
+        case BC_MODE_CHAR:
+            EMIT(e, 0x48, 0xC7, (uint8_t)(0xC0 | reg));        // mov r64, imm32
+            emit32(e, value);
+            break;
+        case BC_MODE_STR:
+            EMIT(e, 0x48, (uint8_t)(0xB8 | reg));              // movabs r64, imm64
+            emit64(e, (uint64_t)(uintptr_t)e->program->strings[value]);
+            break;
+        case BC_MODE_GLOBAL:
+            emitMemOp(e, 0x8B, reg, REG_RBX, value * 8);
+            break;
+        case BC_MODE_LOCAL:
+            emitMemOp(e, 0x8B, reg, REG_RBP, -8 * (value + 1));
+            break;
+        case BC_MODE_ARG:
+            emitMemOp(e, 0x8B, reg, REG_RBP, argDisp(e, value));
+            break;
+        default:
+            EMIT(e, 0x48, 0xC7, (uint8_t)(0xC0 | reg));
+            emit32(e, 0);
+            break;
+    }
+}
+
+static void emitStore(Emitter* e, uint8_t mode, int32_t value, int reg) {
+    if (mode == BC_MODE_GLOBAL) emitMemOp(e, 0x89, reg, REG_RBX, value * 8);
+    else if (mode == BC_MODE_LOCAL) emitMemOp(e, 0x89, reg, REG_RBP, -8 * (value + 1));
+}
+
+// jmp/jcc to a bytecode target, jumps past the top level code end the program
+// and jumps past the end of a function return from it
+static void emitJumpTo(Emitter* e, uint8_t cc, int target) {
+    if (cc) EMIT(e, 0x0F, cc);
+    else EMIT(e, 0xE9);
+
+    const BCFunction* fn = &e->program->functions[e->function];
+    if (e->function == 0 && target >= fn->end) emitFixup(e, FIX_END, 0);
+    else if (target >= fn->end) emitFixup(e, FIX_FUNC_END, e->function);
+    else emitFixup(e, FIX_PC, target);
+}
+
+static uint8_t setccFor(BCOp op) {
+    switch (op) {
+        case BC_EQ:  return 0x94;
+        case BC_NEQ: return 0x95;
+        case BC_LT:  return 0x9C;
+        case BC_GT:  return 0x9F;
+        case BC_LEQ: return 0x9E;
+        default:     return 0x9D;
+    }
+}
+
+static void emitFunctionReturn(Emitter* e) {
+    EMIT(e, 0x49, 0xFF, 0xCD);                                  // dec r13
+    EMIT(e, 0xC9, 0xC3);                                        // leave; ret
+}
+
+// Same instruction selection as asmGen.c
+static JITStatus encodeInstr(Emitter* e, int pc) {
+    const BCInstr* ins = &e->program->code[pc];
+    e->pcOffset[pc] = e->size;
+
+    switch (ins->op) {
+        case BC_MOV:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            emitStore(e, ins->dst_mode, ins->dst, REG_RAX);
+            break;
+        case BC_ADD:
+        case BC_SUB:
+        case BC_MUL:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            emitLoad(e, ins->b_mode, ins->b, REG_RCX);
+            if (ins->op == BC_ADD) EMIT(e, 0x01, 0xC8);         // add eax, ecx
+            else if (ins->op == BC_SUB) EMIT(e, 0x29, 0xC8);    // sub eax, ecx
+            else EMIT(e, 0x0F, 0xAF, 0xC1);                     // imul eax, ecx
+            EMIT(e, 0x48, 0x98);                                // cltq
+            emitStore(e, ins->dst_mode, ins->dst, REG_RAX);
+            break;
+        case BC_DIV:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            emitLoad(e, ins->b_mode, ins->b, REG_RCX);
+            EMIT(e, 0x85, 0xC9);                                // test ecx, ecx
+            EMIT(e, 0x0F, 0x84);                                // je div_zero
+            emitFixup(e, FIX_DIV_ZERO, 0);
+            // idiv traps on INT_MIN / -1, divide by -1 as a wrapping negation
+            EMIT(e, 0x83, 0xF9, 0xFF);                          // cmp ecx, -1
+            EMIT(e, 0x75, 0x04);                                // jne do_div
+            EMIT(e, 0xF7, 0xD8);                                // neg eax
+            EMIT(e, 0xEB, 0x03);                                // jmp div_done
+            EMIT(e, 0x99);                                      // do_div: cltd
+            EMIT(e, 0xF7, 0xF9);                                // idiv ecx
+            EMIT(e, 0x48, 0x98);                                // cltq
+            emitStore(e, ins->dst_mode, ins->dst, REG_RAX);
+            break;
+        case BC_LT:
+        case BC_GT:
+        case BC_LEQ:
+        case BC_GEQ:
+        case BC_EQ:
+        case BC_NEQ:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            emitLoad(e, ins->b_mode, ins->b, REG_RCX);
+            if (ins->op == BC_EQ || ins->op == BC_NEQ) EMIT(e, 0x48, 0x39, 0xC8);  // cmp rax, rcx
+            else EMIT(e, 0x39, 0xC8);                                              // cmp eax, ecx
+            EMIT(e, 0x0F, setccFor(ins->op), 0xC0);             // setcc al
+            EMIT(e, 0x0F, 0xB6, 0xC0);                          // movzx eax, al
+            emitStore(e, ins->dst_mode, ins->dst, REG_RAX);
+            break;
+        case BC_AND:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            emitLoad(e, ins->b_mode, ins->b, REG_RCX);
+            EMIT(e, 0x48, 0x85, 0xC0);                          // test rax, rax
+            EMIT(e, 0x0F, 0x95, 0xC0);                          // setne al
+            EMIT(e, 0x48, 0x85, 0xC9);                          // test rcx, rcx
+            EMIT(e, 0x0F, 0x95, 0xC1);                          // setne cl
+            EMIT(e, 0x20, 0xC8);                                // and al, cl
+            EMIT(e, 0x0F, 0xB6, 0xC0);                          // movzx eax, al
+            emitStore(e, ins->dst_mode, ins->dst, REG_RAX);
+            break;
+        case BC_OR:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            emitLoad(e, ins->b_mode, ins->b, REG_RCX);
+            EMIT(e, 0x48, 0x09, 0xC8);                          // or rax, rcx
+            EMIT(e, 0x0F, 0x95, 0xC0);                          // setne al
+            EMIT(e, 0x0F, 0xB6, 0xC0);                          // movzx eax, al
+            emitStore(e, ins->dst_mode, ins->dst, REG_RAX);
+            break;
+        case BC_NOT:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            EMIT(e, 0x48, 0x85, 0xC0);                          // test rax, rax
+            EMIT(e, 0x0F, 0x94, 0xC0);                          // sete al
+            EMIT(e, 0x0F, 0xB6, 0xC0);                          // movzx eax, al
+            emitStore(e, ins->dst_mode, ins->dst, REG_RAX);
+            break;
+        case BC_NEG:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            EMIT(e, 0xF7, 0xD8);                                // neg eax
+            EMIT(e, 0x48, 0x98);                                // cltq
+            emitStore(e, ins->dst_mode, ins->dst, REG_RAX);
+            break;
+        case BC_PRE_INC:
+        case BC_PRE_DEC:
+        case BC_POST_INC:
+        case BC_POST_DEC: {
+            int delta = (ins->op == BC_PRE_INC || ins->op == BC_POST_INC) ? 1 : -1;
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            EMIT(e, 0x8D, 0x48, (uint8_t)delta);                // lea ecx, [rax + delta]
+            EMIT(e, 0x48, 0x63, 0xC9);                          // movsxd rcx, ecx
+            emitStore(e, ins->a_mode, ins->a, REG_RCX);
+            emitStore(e, ins->dst_mode, ins->dst,
+                (ins->op == BC_PRE_INC || ins->op == BC_PRE_DEC) ? REG_RCX : REG_RAX);
+            break;
+        }
+        case BC_JMP:
+            emitJumpTo(e, 0, ins->dst);
+            break;
+        case BC_JMP_IF:
+        case BC_JMP_IF_NOT:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            EMIT(e, 0x48, 0x85, 0xC0);                          // test rax, rax
+            emitJumpTo(e, ins->op == BC_JMP_IF ? 0x85 : 0x84, ins->dst);
+            break;
+        case BC_PUSH_ARG:
+            emitLoad(e, ins->a_mode, ins->a, REG_RAX);
+            EMIT(e, 0x50);                                      // push rax
+            break;
+        case BC_CALL: {
+            const BCFunction* callee = &e->program->functions[ins->a];
+            EMIT(e, 0xE8);                                      // call rel32
+            emitFixup(e, FIX_FUNC, ins->a);
+            if (callee->param_count > 0) {
+                EMIT(e, 0x48, 0x81, 0xC4);                      // add rsp, imm32
+                emit32(e, 8 * callee->param_count);
+            }
+            break;
+        }
+        case BC_RET:
+            if (e->function == 0) {
+                EMIT(e, 0xE9);
+                emitFixup(e, FIX_END, 0);
+            } else {
+                emitFunctionReturn(e);
+            }
+            break;
+        case BC_END:
+            EMIT(e, 0xE9);
+            emitFixup(e, FIX_END, 0);
+            break;
+        default:
+            fprintf(stderr, "JIT error: unsupported instruction %s at TAC %d\n",
+                getBCOpString(ins->op), e->program->tac_ids[pc]);
+            return JIT_COMPILE_ERROR;
+    }
+    return JIT_SUCCESS;
+}
+
+// int entry(int64_t* globals): returns 0, or 1 on division by zero, 2 on call stack overflow
+static JITStatus encodeProgram(Emitter* e) {
+    const BytecodeProgram* program = e->program;
+
+    // Entry: save callee saved registers, rbx = globals, r12 = stack to unwind to, r13 = call depth
+    EMIT(e, 0x55);                                              // push rbp
+    EMIT(e, 0x48, 0x89, 0xE5);                                  // mov rbp, rsp
+    EMIT(e, 0x53);                                              // push rbx
+    EMIT(e, 0x41, 0x54);                                        // push r12
+    EMIT(e, 0x41, 0x55);                                        // push r13
+    EMIT(e, 0x41, 0x56);                                        // push r14
+    EMIT(e, 0x48, 0x89, 0xFB);                                  // mov rbx, rdi
+    EMIT(e, 0x49, 0x89, 0xE4);                                  // mov r12, rsp
+    EMIT(e, 0x45, 0x31, 0xED);                                  // xor r13d, r13d
+
+    e->function = 0;
+    for (int pc = program->functions[0].entry; pc < program->functions[0].end; pc++) {
+        if (encodeInstr(e, pc) != JIT_SUCCESS) return JIT_COMPILE_ERROR;
+    }
+
+    e->endOffset = e->size;
+    EMIT(e, 0x31, 0xC0);                                        // xor eax, eax
+    int epilogue = e->size;
+    EMIT(e, 0x4C, 0x89, 0xE4);                                  // mov rsp, r12
+    EMIT(e, 0x41, 0x5E);                                        // pop r14
+    EMIT(e, 0x41, 0x5D);                                        // pop r13
+    EMIT(e, 0x41, 0x5C);                                        // pop r12
+    EMIT(e, 0x5B);                                              // pop rbx
+    EMIT(e, 0x5D);                                              // pop rbp
+    EMIT(e, 0xC3);                                              // ret
+
+    e->divZeroOffset = e->size;
+    EMIT(e, 0xB8);                                              // mov eax, 1
+    emit32(e, 1);
+    EMIT(e, 0xE9);
+    emit32(e, epilogue - (e->size + 4));
+
+    e->overflowOffset = e->size;
+    EMIT(e, 0xB8);                                              // mov eax, 2
+    emit32(e, 2);
+    EMIT(e, 0xE9);
+    emit32(e, epilogue - (e->size + 4));
+
+    for (int f = 1; f < program->function_count; f++) {
+        const BCFunction* fn = &program->functions[f];
+        e->function = f;
+        e->funcOffset[f] = e->size;
+
+        int frameBytes = ((fn->frame_size * 8) + 15) & ~15;
+        EMIT(e, 0x55);                                          // push rbp
+        EMIT(e, 0x48, 0x89, 0xE5);                              // mov rbp, rsp
+        if (frameBytes > 0) {
+            EMIT(e, 0x48, 0x81, 0xEC);                          // sub rsp, imm32
+            emit32(e, frameBytes);
+        }
+        for (int i = 0; i < fn->frame_size; i++) {
+            EMIT(e, 0x48, 0xC7, 0x85);                          // mov qword [rbp + disp32], 0
+            emit32(e, -8 * (i + 1));
+            emit32(e, 0);
+        }
+        EMIT(e, 0x49, 0xFF, 0xC5);                              // inc r13
+        EMIT(e, 0x49, 0x81, 0xFD);                              // cmp r13, imm32
+        emit32(e, JIT_MAX_CALL_DEPTH);
+        EMIT(e, 0x0F, 0x83);                                    // jae overflow
+        emitFixup(e, FIX_OVERFLOW, 0);
+
+        if (isJITDebugOn) printf("[JIT] %s at offset %d\n", fn->name, e->size);
+        for (int pc = fn->entry; pc < fn->end; pc++) {
+            if (encodeInstr(e, pc) != JIT_SUCCESS) return JIT_COMPILE_ERROR;
+        }
+        // Falling off the end of a function returns
+        e->funcEndOffset[f] = e->size;
+        emitFunctionReturn(e);
+    }
+
+    for (int i = 0; i < e->fixup_count; i++) {
+        Fixup* fix = &e->fixups[i];
+        int target;
+        switch (fix->kind) {
+            case FIX_PC:       target = e->pcOffset[fix->index]; break;
+            case FIX_FUNC:     target = e->funcOffset[fix->index]; break;
+            case FIX_END:      target = e->endOffset; break;
+            case FIX_FUNC_END: target = e->funcEndOffset[fix->index]; break;
+            case FIX_DIV_ZERO: target = e->divZeroOffset; break;
+            default:           target = e->overflowOffset; break;
+        }
+        if (target < 0) {
+            fprintf(stderr, "JIT error: unresolved jump target %d\n", fix->index);
+            return JIT_COMPILE_ERROR;
+        }
+        int32_t rel = target - (fix->pos + 4);
+        memcpy(e->buf + fix->pos, &rel, sizeof(rel));
+    }
+    return JIT_SUCCESS;
+}
+
+static double elapsedMs(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static void nowTimespec(struct timespec* ts) {
+#ifdef _WIN32
+    timespec_get(ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, ts);
+#endif
+}
+
+static void printJITGlobals(const BytecodeProgram* program, const int64_t* globals) {
+    printf("\nProgramState (JIT)-----------------------\n\n");
+    for (int id = 0; id < program->slot_count; id++) {
+        const BCSlot* slot = &program->slots[id];
+        if (slot->is_local || slot->is_temp) continue;
+
+        int64_t v = globals[slot->index];
+        if (slot->type == TYPE_CHAR) {
+            printf("%s = '%c'\n", slot->name, (int)v);
+        } else if (slot->type == TYPE_STRING) {
+            printf("%s = %s\n", slot->name, v ? (const char*)(uintptr_t)v : "(null)");
+        } else {
+            printf("%s = %d\n", slot->name, (int)v);
+        }
+    }
+}
+
+JITStatus runJIT(TACList* code, JITStats* stats) {
+    JITStats local_stats = {0};
+    if (!stats) stats = &local_stats;
+    memset(stats, 0, sizeof(*stats));
+
+#ifdef _WIN32
+    (void)code;
+    fprintf(stderr, "JIT error: --jit is only supported on POSIX systems\n");
+    return JIT_COMPILE_ERROR;
+#else
+    struct timespec start, end;
+    nowTimespec(&start);
+    BytecodeProgram* program = lowerTACToBytecode(code);
+    nowTimespec(&end);
+    if (!program) return JIT_COMPILE_ERROR;
+    stats->lower_time_ms = elapsedMs(start, end);
+
+    nowTimespec(&start);
+    Emitter e;
+    memset(&e, 0, sizeof(e));
+    e.program = program;
+    e.pcOffset = malloc(sizeof(int) * (program->code_count + 1));
+    e.funcOffset = malloc(sizeof(int) * (program->function_count + 1));
+    e.funcEndOffset = malloc(sizeof(int) * (program->function_count + 1));
+    if (!e.pcOffset || !e.funcOffset || !e.funcEndOffset) {
+        fprintf(stderr, "Memory allocation failed for JIT offsets\n");
+        exit(1);
+    }
+    for (int i = 0; i <= program->code_count; i++) e.pcOffset[i] = -1;
+    for (int i = 0; i <= program->function_count; i++) e.funcOffset[i] = e.funcEndOffset[i] = -1;
+
+    JITStatus status = encodeProgram(&e);
+    void* mem = MAP_FAILED;
+    if (status == JIT_SUCCESS) {
+        // Write the code, then flip the mapping to read + execute
+        mem = mmap(NULL, e.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            perror("JIT error: mmap");
+            status = JIT_COMPILE_ERROR;
+        } else {
+            memcpy(mem, e.buf, e.size);
+            if (mprotect(mem, e.size, PROT_READ | PROT_EXEC) != 0) {
+                perror("JIT error: mprotect");
+                status = JIT_COMPILE_ERROR;
+            }
+        }
+    }
+    nowTimespec(&end);
+    stats->compile_time_ms = elapsedMs(start, end);
+    stats->code_bytes = e.size;
+
+    if (status == JIT_SUCCESS) {
+        int64_t* globals = calloc(program->global_count + 1, sizeof(int64_t));
+        if (!globals) {
+            fprintf(stderr, "Memory allocation failed for JIT globals\n");
+            exit(1);
+        }
+
+        int (*entry)(int64_t*);
+        *(void**)(&entry) = mem;
+
+        nowTimespec(&start);
+        int result = entry(globals);
+        nowTimespec(&end);
+        stats->run_time_ms = elapsedMs(start, end);
+
+        if (result == 1) {
+            fprintf(stderr, "Runtime error: division by zero\n");
+            status = JIT_RUNTIME_ERROR;
+        } else if (result == 2) {
+            fprintf(stderr, "Runtime error: call stack overflow\n");
+            status = JIT_RUNTIME_ERROR;
+        }
+        printJITGlobals(program, globals);
+        free(globals);
+    }
+
+    if (mem != MAP_FAILED) munmap(mem, e.size);
+    free(e.buf);
+    free(e.fixups);
+    free(e.pcOffset);
+    free(e.funcEndOffset);
+    free(e.funcOffset);
+    freeBytecode(program);
+    return status;
+#endif
+}
+
+void printJITStats(const JITStats* stats) {
+    if (!stats) return;
+    printf("\nJITStats---------------------------------\n\n");
+    printf("Machine code           : %d bytes\n", stats->code_bytes);
+    printf("Lowering time          : %.3f ms\n", stats->lower_time_ms);
+    printf("Compile time           : %.3f ms\n", stats->compile_time_ms);
+    printf("Run time               : %.3f ms\n", stats->run_time_ms);
+}
@@ -0,0 +1,26 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "bytecode.h"
+
+typedef enum {
+    JIT_SUCCESS,
+    JIT_COMPILE_ERROR,
+    JIT_RUNTIME_ERROR
+} JITStatus;
+
+typedef struct JITStats {
+    int code_bytes;          // Size of the generated machine code
+    double lower_time_ms;    // TAC -> bytecode
+    double compile_time_ms;  // Bytecode -> machine code, including mapping it executable
+    double run_time_ms;
+} JITStats;
+
+void setJITDebugger();
+
+// Lowers the TAC list, encodes it as x86-64 machine code in an mmap'd buffer,
+// runs it in process and prints the final values of the user declared globals.
+JITStatus runJIT(TACList* code, JITStats* stats);
+void printJITStats(const JITStats* stats);
+
+#endif
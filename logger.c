@@ -1,8 +1,13 @@
 #include "logger.h"
+#include "trace.h"
+#include "intern.h"
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #ifdef _WIN32
 #include <direct.h>
 #define mkdir _mkdir
@@ -12,49 +17,184 @@
 
 static FILE* log_file = NULL;
 static PhaseType current_phase;
-static int current_phase_step_count = 0;
-static int written_phase_count = 0;
 const char* folderPath = "Logs";
-const char* filename = "./Logs/compiler_logs.json";
-
-static void write_json_string(FILE* file, const char* value) {
-    const unsigned char* cursor = (const unsigned char*)(value ? value : "");
-    fputc('"', file);
-
-    while (*cursor) {
-        switch (*cursor) {
-            case '\\':
-                fputs("\\\\", file);
-                break;
-            case '"':
-                fputs("\\\"", file);
-                break;
-            case '\n':
-                fputs("\\n", file);
-                break;
-            case '\r':
-                fputs("\\r", file);
-                break;
-            case '\t':
-                fputs("\\t", file);
-                break;
-            default:
-                if (*cursor < 0x20) {
-                    fprintf(file, "\\u%04x", *cursor);
-                } else {
-                    fputc(*cursor, file);
-                }
-                break;
+const char* filename = "./Logs/compiler_trace.bin";
+
+#ifndef NO_TRACE
+bool traceEnabled = true;
+#endif
+
+void setTraceEnabled(bool enabled) {
+#ifdef NO_TRACE
+    (void)enabled;
+#else
+    traceEnabled = enabled;
+#endif
+}
+
+// Records go through a single producer ring that a writer thread drains to
+// the file, so the compiler thread never waits on disk I/O while tracing
+#define TRACE_RING_RECORDS 16384   // Power of two
+#define TRACE_WRITE_CHUNK 2048     // Records published before the writer is woken
+#define TRACE_STRING_INITIAL_CAPACITY 1024
+
+static TraceRecord ring[TRACE_RING_RECORDS];
+static _Atomic uint32_t ringHead = 0;   // Records published, only written by the compiler thread
+static _Atomic uint32_t ringTail = 0;   // Records written out, only written by the writer thread
+static atomic_bool writerStopping = false;
+static pthread_t writerThread;
+static pthread_mutex_t writerLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writerWake = PTHREAD_COND_INITIALIZER;
+
+// String table, deduplicated by content. Ids start at 1.
+typedef struct TraceString {
+    uint32_t hash;
+    uint32_t offset;
+    uint32_t length;
+} TraceString;
+
+static TraceString* strings = NULL;
+static int stringCount = 0;
+static int stringCapacity = 0;
+static int* stringIndex = NULL;      // Open addressing over ids, 0 for an empty slot
+static int stringIndexCapacity = 0;  // Power of two
+static char* stringBytes = NULL;
+static size_t stringBytesUsed = 0;
+static size_t stringBytesCapacity = 0;
+
+#ifndef NO_TRACE
+static void* checkedRealloc(void* ptr, size_t size) {
+    void* grown = realloc(ptr, size);
+    if (!grown) {
+        fprintf(stderr, "Memory allocation failed for trace\n");
+        exit(1);
+    }
+    return grown;
+}
+
+static void growStringIndex() {
+    int capacity = stringIndexCapacity ? stringIndexCapacity * 2 : TRACE_STRING_INITIAL_CAPACITY;
+    int* index = calloc(capacity, sizeof(int));
+    if (!index) {
+        fprintf(stderr, "Memory allocation failed for trace\n");
+        exit(1);
+    }
+    for (int id = 1; id <= stringCount; id++) {
+        uint32_t pos = strings[id - 1].hash & (capacity - 1);
+        while (index[pos]) pos = (pos + 1) & (capacity - 1);
+        index[pos] = id;
+    }
+    free(stringIndex);
+    stringIndex = index;
+    stringIndexCapacity = capacity;
+}
+
+static int32_t traceBytes(const void* data, size_t length) {
+    uint32_t hash = hashBytes(data, length);
+    if ((stringCount + 1) * 2 > stringIndexCapacity) growStringIndex();
+
+    uint32_t mask = stringIndexCapacity - 1;
+    uint32_t pos = hash & mask;
+    while (stringIndex[pos]) {
+        const TraceString* entry = &strings[stringIndex[pos] - 1];
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(stringBytes + entry->offset, data, length) == 0) {
+            return stringIndex[pos];
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    if (stringCount == stringCapacity) {
+        stringCapacity = stringCapacity ? stringCapacity * 2 : TRACE_STRING_INITIAL_CAPACITY;
+        strings = checkedRealloc(strings, sizeof(TraceString) * stringCapacity);
+    }
+    if (stringBytesUsed + length > stringBytesCapacity) {
+        while (stringBytesUsed + length > stringBytesCapacity) {
+            stringBytesCapacity = stringBytesCapacity ? stringBytesCapacity * 2 : 64 * 1024;
+        }
+        stringBytes = checkedRealloc(stringBytes, stringBytesCapacity);
+    }
+    if (length) memcpy(stringBytes + stringBytesUsed, data, length);
+    strings[stringCount].hash = hash;
+    strings[stringCount].offset = (uint32_t)stringBytesUsed;
+    strings[stringCount].length = (uint32_t)length;
+    stringBytesUsed += length;
+    stringIndex[pos] = ++stringCount;
+    return stringCount;
+}
+
+static int32_t traceString(const char* value) {
+    return value ? traceBytes(value, strlen(value)) : 0;
+}
+#endif
+
+static void wakeWriter() {
+    pthread_mutex_lock(&writerLock);
+    pthread_cond_signal(&writerWake);
+    pthread_mutex_unlock(&writerLock);
+}
+
+static void* writerMain(void* arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&writerLock);
+        while (atomic_load(&ringHead) - atomic_load(&ringTail) < TRACE_WRITE_CHUNK &&
+               !atomic_load(&writerStopping)) {
+            pthread_cond_wait(&writerWake, &writerLock);
         }
-        cursor++;
+        pthread_mutex_unlock(&writerLock);
+
+        // Read the stop flag before the head so the last records are not missed
+        bool stopping = atomic_load(&writerStopping);
+        uint32_t head = atomic_load_explicit(&ringHead, memory_order_acquire);
+        uint32_t tail = atomic_load_explicit(&ringTail, memory_order_relaxed);
+        while (tail != head) {
+            uint32_t start = tail & (TRACE_RING_RECORDS - 1);
+            uint32_t count = head - tail;
+            if (count > TRACE_RING_RECORDS - start) count = TRACE_RING_RECORDS - start;
+            fwrite(&ring[start], sizeof(TraceRecord), count, log_file);
+            tail += count;
+            atomic_store_explicit(&ringTail, tail, memory_order_release);
+        }
+        if (stopping) return NULL;
     }
+}
+
+// Slot for the next record, waiting for the writer if the ring is full
+static TraceRecord* nextRecord(uint32_t kind) {
+    uint32_t head = atomic_load_explicit(&ringHead, memory_order_relaxed);
+    while (head - atomic_load_explicit(&ringTail, memory_order_acquire) == TRACE_RING_RECORDS) {
+        sched_yield();
+    }
+    TraceRecord* record = &ring[head & (TRACE_RING_RECORDS - 1)];
+    memset(record, 0, sizeof(*record));
+    record->kind = kind;
+    return record;
+}
 
-    fputc('"', file);
+// Hands the record filled in after nextRecord() to the writer
+static void publishRecord() {
+    uint32_t head = atomic_load_explicit(&ringHead, memory_order_relaxed) + 1;
+    atomic_store_explicit(&ringHead, head, memory_order_release);
+    if (head % TRACE_WRITE_CHUNK == 0) wakeWriter();
+}
+
+static void writeHeader() {
+    TraceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_count = atomic_load(&ringHead);
+    header.string_count = (uint32_t)stringCount;
+    header.string_table_offset = sizeof(TraceHeader) + (uint64_t)header.record_count * sizeof(TraceRecord);
+    fwrite(&header, sizeof(header), 1, log_file);
 }
 
 void init_logger() {
-    current_phase_step_count = 0;
-    written_phase_count = 0;
+    atomic_store(&ringHead, 0);
+    atomic_store(&ringTail, 0);
+    atomic_store(&writerStopping, false);
+    if (!isTraceOn()) return;  // No log file at all
     #ifdef _WIN32
     if (_mkdir(folderPath) == -1) {
     #else
@@ -66,316 +206,256 @@ void init_logger() {
             exit(1);
         }
     }
-    log_file = fopen(filename, "w");
+    log_file = fopen(filename, "wb");
     if (!log_file) {
         perror("Could not open log file");
         exit(1);
     }
-    fprintf(log_file, "{ \"phases\": [\n"); // JSON start
+    writeHeader();  // Rewritten with the final counts by close_logger()
+
+    if (pthread_create(&writerThread, NULL, writerMain, NULL) != 0) {
+        fprintf(stderr, "Could not start the trace writer thread\n");
+        exit(1);
+    }
 }
 
 void start_phase(PhaseType phase) {
     current_phase = phase;
-    current_phase_step_count = 0;
-    const char* phase_name =
-        (phase == PHASE_LEX_PARSE) ? "PHASE_LEX_PARSE" :
-        (phase == PHASE_SEMANTIC) ? "PHASE_SEMANTIC" :
-        "PHASE_ICG";
-
-    fprintf(log_file, "  { \"phase\": \"%s\", \"steps\": [\n", phase_name);
+    if (!log_file) return;
+    nextRecord(TRACE_PHASE_BEGIN)->fields[0] = phase;
+    publishRecord();
 }
 
+#ifndef NO_TRACE
+// Each case stores the Step's fields in declaration order, which is also the
+// order Scripts/trace_to_json.py reads them back in
 void log_step(Step step) {
     if (!log_file) return;
 
+    int32_t* f = nextRecord(step.type)->fields;
     switch (step.type) {
         case LEX_READ_TOKEN:
-            fprintf(log_file, "    { \"type\": \"LEX_READ_TOKEN\", \"data\": {\"token\": ");
-            write_json_string(log_file, step.readToken.tokenName);
-            fprintf(log_file, ", \"value\": ");
-            write_json_string(log_file, step.readToken.value);
-            fprintf(log_file, ", \"location\": \"%d:%d\" }},\n", step.readToken.line_no, step.readToken.char_no);
+            f[0] = traceString(step.readToken.tokenName);
+            f[1] = traceString(step.readToken.value);
+            f[2] = step.readToken.line_no;
+            f[3] = step.readToken.char_no;
             break;
 
         case PARSE_REDUCE_RULE:
-            fprintf(log_file, "    { \"type\": \"PARSE_REDUCE_RULE\", \"data\": {\"ruleNo\": \"%d\", \"rule\": ", step.reduceRule.ruleNo);
-            write_json_string(log_file, step.reduceRule.rule);
-            fprintf(log_file, " }},\n");
+            f[0] = step.reduceRule.ruleNo;
+            f[1] = traceString(step.reduceRule.rule);
             break;
 
         case PARSE_REDUCE_RULE_COMPLETE:
-            fprintf(log_file, "    { \"type\": \"PARSE_REDUCE_RULE_COMPLETE\", \"data\": {\"ruleNo\": \"%d\", \"lhs\": ", step.ReduceRuleComplete.ruleNo);
-            write_json_string(log_file, step.ReduceRuleComplete.lhs);
-            fprintf(log_file, ", \"rhsLength\": \"%d\" }},\n", step.ReduceRuleComplete.rhsLength);
-            break; 
+            f[0] = step.ReduceRuleComplete.ruleNo;
+            f[1] = traceString(step.ReduceRuleComplete.lhs);
+            f[2] = step.ReduceRuleComplete.rhsLength;
+            break;
 
         case PARSE_SEMANTIC_STEP:
-            fprintf(log_file, "    { \"type\": \"PARSE_SEMANTIC_STEP\", \"data\": {\"ruleNo\": \"%d\", \"stepNo\": \"%d\", \"instr\": ", step.SemanticStep.ruleNo, step.SemanticStep.stepNo);
-            write_json_string(log_file, step.SemanticStep.instr);
-            fprintf(log_file, " }},\n");
+            f[0] = step.SemanticStep.ruleNo;
+            f[1] = step.SemanticStep.stepNo;
+            f[2] = traceString(step.SemanticStep.instr);
             break;
 
         case PARSE_CREATE_SCOPE:
-            fprintf(log_file, "    { \"type\": \"PARSE_CREATE_SCOPE\", \"data\": {\"table_id\": \"%d\", \"name\": ", step.CreateScope.table_id);
-            write_json_string(log_file, step.CreateScope.scopeName);
-            fprintf(log_file, ", \"parent_id\": \"%d\" }},\n", step.CreateScope.parent_id);
+            f[0] = step.CreateScope.table_id;
+            f[1] = traceString(step.CreateScope.scopeName);
+            f[2] = step.CreateScope.parent_id;
             break;
 
         case PARSE_ENTER_SCOPE:
-            fprintf(log_file, "    { \"type\": \"PARSE_ENTER_SCOPE\", \"data\": {\"table_id\": \"%d\", \"name\": ", step.EnterScope.table_id);
-            write_json_string(log_file, step.EnterScope.scopeName);
-            fprintf(log_file, " }},\n");
+            f[0] = step.EnterScope.table_id;
+            f[1] = traceString(step.EnterScope.scopeName);
             break;
-        
+
         case PARSE_EXIT_SCOPE:
-            fprintf(log_file, "    { \"type\": \"PARSE_EXIT_SCOPE\", \"data\": {\"table_id\": \"%d\", \"name\": ", step.EnterScope.table_id);
-            write_json_string(log_file, step.EnterScope.scopeName);
-            fprintf(log_file, " }},\n");
-            break; 
+            f[0] = step.ExitScope.table_id;
+            f[1] = traceString(step.ExitScope.scopeName);
+            break;
 
         case PARSE_ADD_SYM:
-            fprintf(log_file, "    { \"type\": \"PARSE_ADD_SYM\", \"data\": {\"name\": ");
-            write_json_string(log_file, step.AddSymbol.name);
-            fprintf(log_file, ", \"sym_type\": ");
-            write_json_string(log_file, step.AddSymbol.type);
-            fprintf(log_file, ", \"scope_id\": \"%d\", \"is_function\": \"%d\", \"line_no\": \"%d\", \"char_no\": \"%d\", \"is_duplicate\": \"%d\" }},\n",
-                step.AddSymbol.scope_id,
-                step.AddSymbol.is_function,
-                step.AddSymbol.line_no,
-                step.AddSymbol.char_no,
-                step.AddSymbol.is_duplicate);
+            f[0] = traceString(step.AddSymbol.name);
+            f[1] = traceString(step.AddSymbol.type);
+            f[2] = step.AddSymbol.scope_id;
+            f[3] = step.AddSymbol.is_function;
+            f[4] = step.AddSymbol.line_no;
+            f[5] = step.AddSymbol.char_no;
+            f[6] = step.AddSymbol.is_duplicate;
             break;
+
         case PARSE_ASSGN_SYM_TYPE:
-            fprintf(log_file, "    { \"type\": \"PARSE_ASSGN_SYM_TYPE\", \"data\": {\"name\": ");
-            write_json_string(log_file, step.AssignSymType.name);
-            fprintf(log_file, ", \"sym_type\": ");
-            write_json_string(log_file, step.AssignSymType.type);
-            fprintf(log_file, ", \"scope_id\": \"%d\"}},\n", step.AssignSymType.scope_id);
+            f[0] = traceString(step.AssignSymType.name);
+            f[1] = traceString(step.AssignSymType.type);
+            f[2] = step.AssignSymType.scope_id;
             break;
+
         case PARSE_CREATE_AST_NODE:
-            fprintf(
-                log_file,
-                "    { \"type\": \"PARSE_CREATE_AST_NODE\", \"data\": {\"node_id\": \"%d\"}},\n",
-                step.CreateASTNode.node_id
-            ); 
+            f[0] = step.CreateASTNode.node_id;
             break;
-        case PARSE_ENTERING_STATE: 
-            fprintf(
-                log_file,
-                "    { \"type\": \"PARSE_ENTERING_STATE\", \"data\": {\"state\": \"%d\"}},\n",
-                step.ParseEnteringState.state
-            );
+
+        case PARSE_ENTERING_STATE:
+            f[0] = step.ParseEnteringState.state;
             break;
-        case PARSE_STACK_SNAPSHOT: {
-            fprintf(
-                log_file,
-                "    { \"type\": \"PARSE_STACK_SNAPSHOT\", \"data\": { \"states\": ["
-            );
-
-            for (int i = 0; i < step.ParseStackSnapshot.size; i++) {
-                fprintf(
-                    log_file,
-                    "%d%s",
-                    step.ParseStackSnapshot.states[i],
-                    (i + 1 < step.ParseStackSnapshot.size) ? ", " : ""
-                );
-            }
-
-            fprintf(
-                log_file,
-                "], \"size\": \"%d\" }},\n",
-                step.ParseStackSnapshot.size
-            );
-            
+
+        case PARSE_STACK_SNAPSHOT:
+            // The states go to the string table as a block of int32 values
+            f[0] = traceBytes(step.ParseStackSnapshot.states, sizeof(int) * step.ParseStackSnapshot.size);
+            f[1] = step.ParseStackSnapshot.size;
             break;
-        }
 
         case PARSE_ERROR:
-            fprintf(log_file, "    { \"type\": \"PARSE_ERROR\", \"data\": {\"message\": ");
-            write_json_string(log_file, step.ParseError.message);
-            fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\" }},\n",
-                step.ParseError.line_no,
-                step.ParseError.char_no);
+            f[0] = traceString(step.ParseError.message);
+            f[1] = step.ParseError.line_no;
+            f[2] = step.ParseError.char_no;
             break;
 
         case SEMANTIC_PASS_STATUS:
-            fprintf(log_file, "    { \"type\": \"SEMANTIC_PASS_STATUS\", \"data\": {\"pass\": ");
-            write_json_string(log_file, step.SemanticPassStatus.pass);
-            fprintf(log_file, ", \"status\": ");
-            write_json_string(log_file, step.SemanticPassStatus.status);
-            fprintf(log_file, ", \"message\": ");
-            write_json_string(log_file, step.SemanticPassStatus.message);
-            fprintf(log_file, " }},\n");
+            f[0] = traceString(step.SemanticPassStatus.pass);
+            f[1] = traceString(step.SemanticPassStatus.status);
+            f[2] = traceString(step.SemanticPassStatus.message);
             break;
 
         case SEMANTIC_SYMBOL_HIGHLIGHT:
-            fprintf(log_file, "    { \"type\": \"SEMANTIC_SYMBOL_HIGHLIGHT\", \"data\": {\"scope_id\": \"%d\", \"symbol_name\": ", step.SemanticSymbolHighlight.scope_id);
-            write_json_string(log_file, step.SemanticSymbolHighlight.symbol_name);
-            fprintf(log_file, ", \"reason\": ");
-            write_json_string(log_file, step.SemanticSymbolHighlight.reason);
-            if (step.SemanticSymbolHighlight.old_type) {
-                fprintf(log_file, ", \"old_type\": ");
-                write_json_string(log_file, step.SemanticSymbolHighlight.old_type);
-            }
-            if (step.SemanticSymbolHighlight.new_type) {
-                fprintf(log_file, ", \"new_type\": ");
-                write_json_string(log_file, step.SemanticSymbolHighlight.new_type);
-            }
-            if (step.SemanticSymbolHighlight.has_location) {
-                fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\"", step.SemanticSymbolHighlight.line_no, step.SemanticSymbolHighlight.char_no);
-            }
-            fprintf(log_file, " }},\n");
+            f[0] = step.SemanticSymbolHighlight.scope_id;
+            f[1] = traceString(step.SemanticSymbolHighlight.symbol_name);
+            f[2] = traceString(step.SemanticSymbolHighlight.reason);
+            f[3] = traceString(step.SemanticSymbolHighlight.old_type);
+            f[4] = traceString(step.SemanticSymbolHighlight.new_type);
+            f[5] = step.SemanticSymbolHighlight.line_no;
+            f[6] = step.SemanticSymbolHighlight.char_no;
+            f[7] = step.SemanticSymbolHighlight.has_location;
             break;
 
         case SEMANTIC_NODE_HIGHLIGHT:
-            fprintf(log_file, "    { \"type\": \"SEMANTIC_NODE_HIGHLIGHT\", \"data\": {\"pass\": ");
-            write_json_string(log_file, step.SemanticNodeHighlight.pass);
-            fprintf(log_file, ", \"node_id\": \"%d\", \"node_type\": ", step.SemanticNodeHighlight.node_id);
-            write_json_string(log_file, step.SemanticNodeHighlight.node_type);
-            fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\", \"action\": ", step.SemanticNodeHighlight.line_no, step.SemanticNodeHighlight.char_no);
-            write_json_string(log_file, step.SemanticNodeHighlight.action);
-            if (step.SemanticNodeHighlight.message) {
-                fprintf(log_file, ", \"message\": ");
-                write_json_string(log_file, step.SemanticNodeHighlight.message);
-            }
-            fprintf(log_file, " }},\n");
+            f[0] = traceString(step.SemanticNodeHighlight.pass);
+            f[1] = step.SemanticNodeHighlight.node_id;
+            f[2] = traceString(step.SemanticNodeHighlight.node_type);
+            f[3] = step.SemanticNodeHighlight.line_no;
+            f[4] = step.SemanticNodeHighlight.char_no;
+            f[5] = traceString(step.SemanticNodeHighlight.action);
+            f[6] = traceString(step.SemanticNodeHighlight.message);
             break;
 
         case SEMANTIC_ERROR_LOG:
-            fprintf(log_file, "    { \"type\": \"SEMANTIC_ERROR\", \"data\": {\"pass\": ");
-            write_json_string(log_file, step.SemanticErrorLog.pass);
-            fprintf(log_file, ", \"message\": ");
-            write_json_string(log_file, step.SemanticErrorLog.message);
-            fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\"", step.SemanticErrorLog.line_no, step.SemanticErrorLog.char_no);
-            if (step.SemanticErrorLog.node_id) {
-                fprintf(log_file, ", \"node_id\": ");
-                write_json_string(log_file, step.SemanticErrorLog.node_id);
-            }
-            if (step.SemanticErrorLog.scope_id) {
-                fprintf(log_file, ", \"scope_id\": ");
-                write_json_string(log_file, step.SemanticErrorLog.scope_id);
-            }
-            if (step.SemanticErrorLog.symbol_name) {
-                fprintf(log_file, ", \"symbol_name\": ");
-                write_json_string(log_file, step.SemanticErrorLog.symbol_name);
-            }
-            fprintf(log_file, " }},\n");
+            f[0] = traceString(step.SemanticErrorLog.pass);
+            f[1] = traceString(step.SemanticErrorLog.message);
+            f[2] = step.SemanticErrorLog.line_no;
+            f[3] = step.SemanticErrorLog.char_no;
+            f[4] = traceString(step.SemanticErrorLog.node_id);
+            f[5] = traceString(step.SemanticErrorLog.scope_id);
+            f[6] = traceString(step.SemanticErrorLog.symbol_name);
             break;
 
         case SEMANTIC_ANALYSIS_COMPLETE:
-            fprintf(log_file, "    { \"type\": \"SEMANTIC_ANALYSIS_COMPLETE\", \"data\": {\"status\": ");
-            write_json_string(log_file, step.SemanticAnalysisComplete.status);
-            fprintf(log_file, ", \"total_errors\": \"%d\" }},\n", step.SemanticAnalysisComplete.total_errors);
+            f[0] = traceString(step.SemanticAnalysisComplete.status);
+            f[1] = step.SemanticAnalysisComplete.total_errors;
             break;
 
         case ICG_NODE_VISIT:
-            fprintf(log_file, "    { \"type\": \"ICG_NODE_VISIT\", \"data\": {\"ast_node_id\": \"%d\", \"node_type\": ",
-                step.ICGNodeVisit.ast_node_id);
-            write_json_string(log_file, step.ICGNodeVisit.node_type);
-            fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\", \"action\": ",
-                step.ICGNodeVisit.line_no, step.ICGNodeVisit.char_no);
-            write_json_string(log_file, step.ICGNodeVisit.action);
-            if (step.ICGNodeVisit.operator_name) {
-                fprintf(log_file, ", \"operator\": ");
-                write_json_string(log_file, step.ICGNodeVisit.operator_name);
-            }
-            fprintf(log_file, " }},\n");
+            f[0] = step.ICGNodeVisit.ast_node_id;
+            f[1] = traceString(step.ICGNodeVisit.node_type);
+            f[2] = step.ICGNodeVisit.line_no;
+            f[3] = step.ICGNodeVisit.char_no;
+            f[4] = traceString(step.ICGNodeVisit.action);
+            f[5] = traceString(step.ICGNodeVisit.operator_name);
             break;
 
         case ICG_CREATE_TEMP:
-            fprintf(log_file, "    { \"type\": \"ICG_CREATE_TEMP\", \"data\": {\"ast_node_id\": \"%d\", \"node_type\": ",
-                step.ICGCreateTemp.ast_node_id);
-            write_json_string(log_file, step.ICGCreateTemp.node_type);
-            fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\", \"temp_name\": ",
-                step.ICGCreateTemp.line_no, step.ICGCreateTemp.char_no);
-            write_json_string(log_file, step.ICGCreateTemp.temp_name);
-            fprintf(log_file, " }},\n");
+            f[0] = step.ICGCreateTemp.ast_node_id;
+            f[1] = traceString(step.ICGCreateTemp.node_type);
+            f[2] = step.ICGCreateTemp.line_no;
+            f[3] = step.ICGCreateTemp.char_no;
+            f[4] = traceString(step.ICGCreateTemp.temp_name);
             break;
 
         case ICG_CREATE_LABEL:
-            fprintf(log_file, "    { \"type\": \"ICG_CREATE_LABEL\", \"data\": {\"ast_node_id\": \"%d\", \"node_type\": ",
-                step.ICGCreateLabel.ast_node_id);
-            write_json_string(log_file, step.ICGCreateLabel.node_type);
-            fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\", \"label_name\": ",
-                step.ICGCreateLabel.line_no, step.ICGCreateLabel.char_no);
-            write_json_string(log_file, step.ICGCreateLabel.label_name);
-            fprintf(log_file, ", \"target_tac_id\": \"%d\" }},\n", step.ICGCreateLabel.target_tac_id);
+            f[0] = step.ICGCreateLabel.ast_node_id;
+            f[1] = traceString(step.ICGCreateLabel.node_type);
+            f[2] = step.ICGCreateLabel.line_no;
+            f[3] = step.ICGCreateLabel.char_no;
+            f[4] = traceString(step.ICGCreateLabel.label_name);
+            f[5] = step.ICGCreateLabel.target_tac_id;
             break;
 
         case ICG_EMIT:
-            fprintf(log_file, "    { \"type\": \"ICG_EMIT\", \"data\": {\"ast_node_id\": \"%d\", \"node_type\": ",
-                step.ICGEmit.ast_node_id);
-            write_json_string(log_file, step.ICGEmit.node_type);
-            fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\", \"instruction_no\": \"%d\", \"source_tac_id\": \"%d\", \"opcode\": ",
-                step.ICGEmit.line_no, step.ICGEmit.char_no, step.ICGEmit.instruction_no, step.ICGEmit.source_tac_id);
-            write_json_string(log_file, step.ICGEmit.opcode);
-            fprintf(log_file, ", \"result\": ");
-            write_json_string(log_file, step.ICGEmit.result);
-            fprintf(log_file, ", \"arg1\": ");
-            write_json_string(log_file, step.ICGEmit.arg1);
-            fprintf(log_file, ", \"arg2\": ");
-            write_json_string(log_file, step.ICGEmit.arg2);
-            fprintf(log_file, ", \"target_label\": ");
-            write_json_string(log_file, step.ICGEmit.target_label);
-            fprintf(log_file, ", \"text\": ");
-            write_json_string(log_file, step.ICGEmit.text);
-            fprintf(log_file, " }},\n");
+            f[0] = step.ICGEmit.ast_node_id;
+            f[1] = traceString(step.ICGEmit.node_type);
+            f[2] = step.ICGEmit.line_no;
+            f[3] = step.ICGEmit.char_no;
+            f[4] = step.ICGEmit.instruction_no;
+            f[5] = step.ICGEmit.source_tac_id;
+            f[6] = traceString(step.ICGEmit.opcode);
+            f[7] = traceString(step.ICGEmit.result);
+            f[8] = traceString(step.ICGEmit.arg1);
+            f[9] = traceString(step.ICGEmit.arg2);
+            f[10] = traceString(step.ICGEmit.target_label);
+            f[11] = traceString(step.ICGEmit.text);
             break;
 
         case ICG_PATCH_LABEL:
-            fprintf(log_file, "    { \"type\": \"ICG_PATCH_LABEL\", \"data\": {\"ast_node_id\": \"%d\", \"node_type\": ",
-                step.ICGPatchLabel.ast_node_id);
-            write_json_string(log_file, step.ICGPatchLabel.node_type);
-            fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\", \"instruction_no\": \"%d\", \"label_name\": ",
-                step.ICGPatchLabel.line_no, step.ICGPatchLabel.char_no, step.ICGPatchLabel.instruction_no);
-            write_json_string(log_file, step.ICGPatchLabel.label_name);
-            fprintf(log_file, ", \"text\": ");
-            write_json_string(log_file, step.ICGPatchLabel.text);
-            fprintf(log_file, " }},\n");
+            f[0] = step.ICGPatchLabel.ast_node_id;
+            f[1] = traceString(step.ICGPatchLabel.node_type);
+            f[2] = step.ICGPatchLabel.line_no;
+            f[3] = step.ICGPatchLabel.char_no;
+            f[4] = step.ICGPatchLabel.instruction_no;
+            f[5] = traceString(step.ICGPatchLabel.label_name);
+            f[6] = traceString(step.ICGPatchLabel.text);
             break;
 
         case ICG_ENTER_FUNCTION:
         case ICG_EXIT_FUNCTION:
-            fprintf(log_file, "    { \"type\": \"%s\", \"data\": {\"ast_node_id\": \"%d\", \"node_type\": ",
-                step.type == ICG_ENTER_FUNCTION ? "ICG_ENTER_FUNCTION" : "ICG_EXIT_FUNCTION",
-                step.ICGFunctionEvent.ast_node_id);
-            write_json_string(log_file, step.ICGFunctionEvent.node_type);
-            fprintf(log_file, ", \"line_no\": \"%d\", \"char_no\": \"%d\", \"function_name\": ",
-                step.ICGFunctionEvent.line_no, step.ICGFunctionEvent.char_no);
-            write_json_string(log_file, step.ICGFunctionEvent.function_name);
-            fprintf(log_file, " }},\n");
+            f[0] = step.ICGFunctionEvent.ast_node_id;
+            f[1] = traceString(step.ICGFunctionEvent.node_type);
+            f[2] = step.ICGFunctionEvent.line_no;
+            f[3] = step.ICGFunctionEvent.char_no;
+            f[4] = traceString(step.ICGFunctionEvent.function_name);
             break;
 
         case ICG_COMPLETE:
-            fprintf(log_file, "    { \"type\": \"ICG_COMPLETE\", \"data\": {\"status\": ");
-            write_json_string(log_file, step.ICGComplete.status);
-            fprintf(log_file, ", \"instruction_count\": \"%d\", \"temporary_count\": \"%d\", \"label_count\": \"%d\" }},\n",
-                step.ICGComplete.instruction_count,
-                step.ICGComplete.temporary_count,
-                step.ICGComplete.label_count);
+            f[0] = traceString(step.ICGComplete.status);
+            f[1] = step.ICGComplete.instruction_count;
+            f[2] = step.ICGComplete.temporary_count;
+            f[3] = step.ICGComplete.label_count;
             break;
 
         default:
-            fprintf(log_file, "    { \"type\": \"UNKNOWN\" },\n");
             break;
     }
-
-    current_phase_step_count++;
+    publishRecord();
 }
+#endif
 
 
 void end_phase() {
-    if (current_phase_step_count > 0) {
-        fseek(log_file, -2, SEEK_CUR); // remove last comma
-    }
-    fprintf(log_file, "\n  ]},\n");
-    written_phase_count++;
+    if (!log_file) return;
+    nextRecord(TRACE_PHASE_END);
+    publishRecord();
+    wakeWriter();  // Write the phase out while the next one runs
 }
 
 void close_logger() {
-    if (written_phase_count > 0) {
-        fseek(log_file, -2, SEEK_CUR); // remove last comma
+    if (!log_file) return;
+    atomic_store(&writerStopping, true);
+    wakeWriter();
+    pthread_join(writerThread, NULL);
+
+    for (int id = 1; id <= stringCount; id++) {
+        uint32_t length = strings[id - 1].length;
+        fwrite(&length, sizeof(length), 1, log_file);
+        fwrite(stringBytes + strings[id - 1].offset, 1, length, log_file);
     }
-    fprintf(log_file, "\n]}\n");   // JSON end
+    fseek(log_file, 0, SEEK_SET);
+    writeHeader();
     fclose(log_file);
+    log_file = NULL;
+
+    free(strings);
+    free(stringIndex);
+    free(stringBytes);
+    strings = NULL;
+    stringIndex = NULL;
+    stringBytes = NULL;
+    stringCount = stringCapacity = stringIndexCapacity = 0;
+    stringBytesUsed = stringBytesCapacity = 0;
 }
@@ -2,6 +2,7 @@
 #define LOGGER_H
 
 #include <stdio.h>
+#include <stdbool.h>
 
 // Enum for phases
 typedef enum {
@@ -113,7 +114,7 @@ typedef struct ExitScope {
 
 typedef struct AddSymbol {
     const char* name;
-    char* type;
+    const char* type;
     int scope_id;
     int is_function;
     int line_no;
@@ -127,7 +128,7 @@ typedef struct CreateASTNode {
 
 typedef struct AssignSymType {
     const char* name;
-    char* type;
+    const char* type;
     int scope_id;
 } AssignSymType;
 
@@ -276,10 +277,25 @@ typedef struct Step {
 } Step;
 
 
+// Step tracing for the visualizer. Building with -DNO_TRACE compiles it out,
+// otherwise --no-trace switches it off at run time.
+#ifdef NO_TRACE
+#define isTraceOn() false
+#else
+extern bool traceEnabled;
+#define isTraceOn() traceEnabled
+#endif
+
+void setTraceEnabled(bool enabled);
+
 // Functions
 void init_logger();
 void start_phase(PhaseType phase);
+#ifdef NO_TRACE
+static inline void log_step(Step step) { (void)step; }
+#else
 void log_step(Step);
+#endif
 void end_phase();
 void close_logger();
 
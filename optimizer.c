@@ -0,0 +1,1299 @@
+#include "optimizer.h"
+#include "intern.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define MAX_OPT_ROUNDS 8
+
+static bool isOptimizerDebugOn = false;
+void setOptimizerDebugger(){
+    isOptimizerDebugOn = true;
+}
+
+// ----------------------------------------------------------------------------
+// Name table: dense ids for every variable/temporary named in a CFG. TAC names
+// are interned, so the table is keyed by pointer.
+// ----------------------------------------------------------------------------
+
+typedef struct NameTable {
+    const char** names;
+    bool* temp;          // isTempName() of every id
+    int* tempIndex;      // Dense number among the temporaries, -1 for user variables
+    int count;
+    int tempCount;
+    int* index;          // Open addressing table of ids
+    int capacity;        // Power of two
+} NameTable;
+
+static int findName(const NameTable* table, const char* name) {
+    if (!name || !table->capacity) return -1;
+    unsigned int mask = table->capacity - 1;
+    unsigned int pos = hashInterned(name) & mask;
+    while (table->index[pos] != -1) {
+        if (table->names[table->index[pos]] == name) return table->index[pos];
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+// Temporaries from newTempVar() ("t12") are never touched by another function.
+// User variables are "name_scope" and ret_val is shared by every call.
+static bool isTempName(const char* name) {
+    return name && strchr(name, '_') == NULL;
+}
+
+static void addName(NameTable* table, const char* name) {
+    if (!name || findName(table, name) != -1) return;
+    unsigned int mask = table->capacity - 1;
+    unsigned int pos = hashInterned(name) & mask;
+    while (table->index[pos] != -1) pos = (pos + 1) & mask;
+    table->index[pos] = table->count;
+    table->temp[table->count] = isTempName(name);
+    table->tempIndex[table->count] = table->temp[table->count] ? table->tempCount++ : -1;
+    table->names[table->count++] = name;
+}
+
+// Names read as an operand. The operand of a call is the function name, not a variable.
+static const char* operandName(const TAC* tac, const Operand* opr) {
+    if (!opr || opr->type != ID_REF || tac->op == TAC_CALL) return NULL;
+    return opr->id_ref.name;
+}
+
+static void buildNameTable(NameTable* table, const CFG* cfg) {
+    int slots = 0;
+    for (int b = 0; b < cfg->block_count; b++) slots += 3 * cfg->blocks[b].instr_count;
+
+    table->count = 0;
+    table->tempCount = 0;
+    table->capacity = 16;
+    while (table->capacity < slots * 2) table->capacity *= 2;
+    table->names = malloc(sizeof(char*) * (slots + 1));
+    table->temp = malloc(sizeof(bool) * (slots + 1));
+    table->tempIndex = malloc(sizeof(int) * (slots + 1));
+    table->index = malloc(sizeof(int) * table->capacity);
+    if (!table->names || !table->temp || !table->tempIndex || !table->index) {
+        fprintf(stderr, "Memory allocation failed for optimizer names\n");
+        exit(1);
+    }
+    for (int i = 0; i < table->capacity; i++) table->index[i] = -1;
+
+    for (int b = 0; b < cfg->block_count; b++) {
+        for (TAC* tac = cfg->blocks[b].first; ; tac = tac->next) {
+            addName(table, tac->result);
+            addName(table, operandName(tac, tac->operand1));
+            addName(table, operandName(tac, tac->operand2));
+            if (tac == cfg->blocks[b].last) break;
+        }
+    }
+}
+
+static void freeNameTable(NameTable* table) {
+    free(table->names);
+    free(table->temp);
+    free(table->tempIndex);
+    free(table->index);
+}
+
+typedef unsigned long long BitWord;
+#define BITS_PER_WORD 64
+
+static void setBit(BitWord* set, int i)          { set[i / BITS_PER_WORD] |= 1ULL << (i % BITS_PER_WORD); }
+static void clearBit(BitWord* set, int i)        { set[i / BITS_PER_WORD] &= ~(1ULL << (i % BITS_PER_WORD)); }
+static bool testBit(const BitWord* set, int i)   { return (set[i / BITS_PER_WORD] >> (i % BITS_PER_WORD)) & 1ULL; }
+
+// ----------------------------------------------------------------------------
+// Constant propagation
+// ----------------------------------------------------------------------------
+
+typedef enum {
+    CONST_KNOWN,
+    CONST_UNKNOWN        // Not a constant
+} ConstState;
+
+typedef struct ConstVal {
+    ConstState state;
+    ValueType type;      // INT_VAL or CHAR_VAL
+    int value;
+} ConstVal;
+
+static const ConstVal unknownVal = {CONST_UNKNOWN, INT_VAL, 0};
+
+static ConstVal knownVal(ValueType type, int value) {
+    ConstVal v = {CONST_KNOWN, type, value};
+    return v;
+}
+
+static bool sameVal(ConstVal a, ConstVal b) {
+    return a.state == b.state && a.type == b.type && a.value == b.value;
+}
+
+// Constants while walking one block. Every name missing from touchedIds is
+// unknown, so entering and leaving a block only costs the names it involves.
+typedef struct ConstFrame {
+    ConstVal* values;    // Per name id
+    bool* touched;
+    int* touchedIds;
+    int touchedCount;
+} ConstFrame;
+
+static void setConst(ConstFrame* frame, int id, ConstVal v) {
+    if (id == -1) return;
+    if (!frame->touched[id]) {
+        if (v.state != CONST_KNOWN) return;
+        frame->touched[id] = true;
+        frame->touchedIds[frame->touchedCount++] = id;
+    }
+    frame->values[id] = v;
+}
+
+static void clearFrame(ConstFrame* frame) {
+    for (int i = 0; i < frame->touchedCount; i++) {
+        int id = frame->touchedIds[i];
+        frame->values[id] = unknownVal;
+        frame->touched[id] = false;
+    }
+    frame->touchedCount = 0;
+}
+
+static ConstVal operandVal(const NameTable* names, const ConstFrame* frame, const TAC* tac, const Operand* opr) {
+    if (!opr) return unknownVal;
+    switch (opr->type) {
+        case INT_VAL:  return knownVal(INT_VAL, opr->int_val);
+        case CHAR_VAL: return knownVal(CHAR_VAL, opr->char_val);
+        case ID_REF: {
+            int id = findName(names, operandName(tac, opr));
+            return id == -1 ? unknownVal : frame->values[id];
+        }
+        default:       return unknownVal;
+    }
+}
+
+static bool isFoldableBinary(TACOp op) {
+    switch (op) {
+        case TAC_ADD: case TAC_SUB: case TAC_MUL: case TAC_DIV:
+        case TAC_EQ: case TAC_NEQ: case TAC_LT: case TAC_GT: case TAC_LEQ: case TAC_GEQ:
+        case TAC_AND: case TAC_OR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Evaluates op the same way the interpreter does. Returns false when the result
+// must be left to run time (division by zero, char arithmetic, overflow traps).
+static bool evaluate(TACOp op, ConstVal a, ConstVal b, ConstVal* out) {
+    if (a.state != CONST_KNOWN) return false;
+    if (isFoldableBinary(op) && b.state != CONST_KNOWN) return false;
+
+    unsigned int ua = (unsigned int)a.value;
+    unsigned int ub = (unsigned int)b.value;
+    switch (op) {
+        case TAC_ADD:
+        case TAC_SUB:
+        case TAC_MUL:
+            // char op char stays a char at run time, which an operand cannot hold untruncated
+            if (a.type == CHAR_VAL && b.type == CHAR_VAL) return false;
+            *out = knownVal(INT_VAL, (int)(op == TAC_ADD ? ua + ub : op == TAC_SUB ? ua - ub : ua * ub));
+            return true;
+        case TAC_DIV:
+            if (a.type == CHAR_VAL && b.type == CHAR_VAL) return false;
+            if (b.value == 0 || (a.value == INT_MIN && b.value == -1)) return false;
+            *out = knownVal(INT_VAL, a.value / b.value);
+            return true;
+        case TAC_EQ:  *out = knownVal(INT_VAL, a.value == b.value); return true;
+        case TAC_NEQ: *out = knownVal(INT_VAL, a.value != b.value); return true;
+        case TAC_LT:  *out = knownVal(INT_VAL, a.value <  b.value); return true;
+        case TAC_GT:  *out = knownVal(INT_VAL, a.value >  b.value); return true;
+        case TAC_LEQ: *out = knownVal(INT_VAL, a.value <= b.value); return true;
+        case TAC_GEQ: *out = knownVal(INT_VAL, a.value >= b.value); return true;
+        case TAC_AND: *out = knownVal(INT_VAL, a.value != 0 && b.value != 0); return true;
+        case TAC_OR:  *out = knownVal(INT_VAL, a.value != 0 || b.value != 0); return true;
+        case TAC_NOT: *out = knownVal(INT_VAL, a.value == 0); return true;
+        case TAC_NEG: *out = knownVal(INT_VAL, (int)(0u - ua)); return true;
+        case TAC_ASSIGN: *out = a; return true;
+        default:      return false;
+    }
+}
+
+// Effect of one instruction on the constant state
+static void transferConst(const NameTable* names, ConstFrame* frame, const TAC* tac) {
+    int result = findName(names, tac->result);
+    switch (tac->op) {
+        case TAC_CALL:
+            // The callee may write ret_val and any user variable, untouched names are unknown already
+            for (int i = 0; i < frame->touchedCount; i++) {
+                int id = frame->touchedIds[i];
+                if (!names->temp[id]) frame->values[id] = unknownVal;
+            }
+            setConst(frame, result, unknownVal);
+            break;
+        case TAC_PRE_INC:
+        case TAC_PRE_DEC:
+        case TAC_POST_INC:
+        case TAC_POST_DEC:
+            setConst(frame, findName(names, operandName(tac, tac->operand1)), unknownVal);
+            setConst(frame, result, unknownVal);
+            break;
+        default:
+            if (result != -1) {
+                ConstVal out = unknownVal;
+                if (tac->op == TAC_ASSIGN && !tac->operand1) {
+                    out = unknownVal;
+                } else if (!evaluate(tac->op, operandVal(names, frame, tac, tac->operand1),
+                                     operandVal(names, frame, tac, tac->operand2), &out)) {
+                    out = unknownVal;
+                }
+                setConst(frame, result, out);
+            }
+            break;
+    }
+}
+
+// Operands that are only read, so may be replaced by a constant
+static bool canSubstitute(TACOp op) {
+    switch (op) {
+        case TAC_CALL:
+        case TAC_POP_ARG:
+        case TAC_PRE_INC:
+        case TAC_PRE_DEC:
+        case TAC_POST_INC:
+        case TAC_POST_DEC:
+            return false;
+        default:
+            return true;
+    }
+}
+
+static Operand* constOperand(ConstVal v) {
+    if (v.type == CHAR_VAL) {
+        char c = (char)v.value;
+        return makeOperand(CHAR_VAL, &c);
+    }
+    return makeOperand(INT_VAL, &v.value);
+}
+
+static bool substituteOperand(const NameTable* names, const ConstFrame* frame, TAC* tac, Operand** opr) {
+    const char* name = operandName(tac, *opr);
+    int id = findName(names, name);
+    if (id == -1 || frame->values[id].state != CONST_KNOWN) return false;
+    *opr = constOperand(frame->values[id]);
+    return true;
+}
+
+typedef struct ConstEntry {
+    int id;              // Name id
+    ConstVal val;
+} ConstEntry;
+
+// Known constants leaving a block, sorted by name id. A name that is not
+// listed is unknown.
+typedef struct ConstList {
+    ConstEntry* entries;
+    int count;
+    bool reached;        // False until the block is first solved
+} ConstList;
+
+typedef struct ConstFlow {
+    const CFG* cfg;
+    const NameTable* names;
+    int* flowId;         // Name id -> bit in the liveness sets, -1 if the name never crosses a block boundary
+    int words;
+    BitWord* liveIn;     // Per block, flowing names read before being written
+    ConstList* out;      // Per block
+    ConstFrame frame;
+    ConstEntry* pending; // Scratch for building one out list
+} ConstFlow;
+
+// A name can carry a constant from one block into another only if it is
+// defined somewhere and referenced in more than one block. Any other name is
+// unknown at the start of every block.
+static int numberFlowingNames(const CFG* cfg, const NameTable* names, int* flowId) {
+    int* lastBlock = malloc(sizeof(int) * (names->count + 1));
+    bool* defined = calloc(names->count + 1, sizeof(bool));
+    bool* shared = calloc(names->count + 1, sizeof(bool));
+    if (!lastBlock || !defined || !shared) {
+        fprintf(stderr, "Memory allocation failed for constant propagation\n");
+        exit(1);
+    }
+    for (int i = 0; i < names->count; i++) lastBlock[i] = -1;
+
+    for (int b = 0; b < cfg->block_count; b++) {
+        for (TAC* tac = cfg->blocks[b].first; ; tac = tac->next) {
+            int ids[3] = {findName(names, tac->result),
+                          findName(names, operandName(tac, tac->operand1)),
+                          findName(names, operandName(tac, tac->operand2))};
+            for (int k = 0; k < 3; k++) {
+                if (ids[k] == -1) continue;
+                if (lastBlock[ids[k]] != -1 && lastBlock[ids[k]] != b) shared[ids[k]] = true;
+                lastBlock[ids[k]] = b;
+            }
+            if (ids[0] != -1) defined[ids[0]] = true;
+            if (ids[1] != -1 && (tac->op == TAC_PRE_INC || tac->op == TAC_PRE_DEC ||
+                                 tac->op == TAC_POST_INC || tac->op == TAC_POST_DEC)) {
+                defined[ids[1]] = true;
+            }
+            if (tac == cfg->blocks[b].last) break;
+        }
+    }
+
+    int count = 0;
+    for (int i = 0; i < names->count; i++) flowId[i] = defined[i] && shared[i] ? count++ : -1;
+    free(lastBlock);
+    free(defined);
+    free(shared);
+    return count;
+}
+
+// Backward liveness of the flowing names. A constant is only carried into a
+// block that may read it, which keeps the out lists short. Calls do not kill
+// anything here, keeping a name live longer than needed is harmless.
+static void solveConstLiveness(ConstFlow* flow) {
+    const CFG* cfg = flow->cfg;
+    int words = flow->words;
+    size_t cells = (size_t)words * cfg->block_count + 1;
+    BitWord* gen = calloc(cells, sizeof(BitWord));
+    BitWord* kill = calloc(cells, sizeof(BitWord));
+    flow->liveIn = calloc(cells, sizeof(BitWord));
+    if (!gen || !kill || !flow->liveIn) {
+        fprintf(stderr, "Memory allocation failed for liveness\n");
+        exit(1);
+    }
+
+    for (int b = 0; b < cfg->block_count; b++) {
+        BitWord* blockGen = &gen[(size_t)b * words];
+        BitWord* blockKill = &kill[(size_t)b * words];
+        for (TAC* tac = cfg->blocks[b].first; ; tac = tac->next) {
+            const char* used[2] = {operandName(tac, tac->operand1), operandName(tac, tac->operand2)};
+            for (int k = 0; k < 2; k++) {
+                int id = findName(flow->names, used[k]);
+                if (id != -1 && flow->flowId[id] != -1 && !testBit(blockKill, flow->flowId[id])) {
+                    setBit(blockGen, flow->flowId[id]);
+                }
+            }
+            int def = findName(flow->names, tac->result);
+            if (def != -1 && flow->flowId[def] != -1) setBit(blockKill, flow->flowId[def]);
+            if (tac == cfg->blocks[b].last) break;
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int r = cfg->rpo_count - 1; r >= 0; r--) {
+            int b = cfg->rpo[r];
+            const BasicBlock* block = &cfg->blocks[b];
+            BitWord* in = &flow->liveIn[(size_t)b * words];
+            for (int w = 0; w < words; w++) {
+                BitWord out = 0;
+                for (int s = 0; s < block->succ_count; s++) out |= flow->liveIn[(size_t)block->succs[s] * words + w];
+                BitWord live = gen[(size_t)b * words + w] | (out & ~kill[(size_t)b * words + w]);
+                if (live != in[w]) {
+                    in[w] = live;
+                    changed = true;
+                }
+            }
+        }
+    }
+    free(gen);
+    free(kill);
+}
+
+static const ConstEntry* findConst(const ConstList* list, int id) {
+    int lo = 0;
+    int hi = list->count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (list->entries[mid].id == id) return &list->entries[mid];
+        if (list->entries[mid].id < id) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return NULL;
+}
+
+static bool isSolvedPred(const ConstFlow* flow, int pred) {
+    return flow->cfg->blocks[pred].rpo_index != -1 && flow->out[pred].reached;
+}
+
+// Loads the constants every solved predecessor agrees on and b may read.
+// Predecessors not solved yet are optimistically ignored.
+static void enterBlock(ConstFlow* flow, int b) {
+    // Parameters, globals and anything set before entry are unknown
+    if (b == 0) return;
+    const BasicBlock* block = &flow->cfg->blocks[b];
+    const ConstList* first = NULL;
+    for (int p = 0; p < block->pred_count && !first; p++) {
+        if (isSolvedPred(flow, block->preds[p])) first = &flow->out[block->preds[p]];
+    }
+    if (!first) return;
+
+    const BitWord* live = &flow->liveIn[(size_t)b * flow->words];
+    for (int i = 0; i < first->count; i++) {
+        const ConstEntry* entry = &first->entries[i];
+        if (!testBit(live, flow->flowId[entry->id])) continue;
+        bool agreed = true;
+        for (int p = 0; p < block->pred_count && agreed; p++) {
+            int pred = block->preds[p];
+            if (!isSolvedPred(flow, pred) || &flow->out[pred] == first) continue;
+            const ConstEntry* other = findConst(&flow->out[pred], entry->id);
+            agreed = other && sameVal(other->val, entry->val);
+        }
+        if (agreed) setConst(&flow->frame, entry->id, entry->val);
+    }
+}
+
+static int compareConstEntries(const void* a, const void* b) {
+    return ((const ConstEntry*)a)->id - ((const ConstEntry*)b)->id;
+}
+
+// Stores the known constants a successor of b may read, returns whether they changed
+static bool leaveBlock(ConstFlow* flow, int b) {
+    const BasicBlock* block = &flow->cfg->blocks[b];
+    int count = 0;
+    for (int i = 0; i < flow->frame.touchedCount; i++) {
+        int id = flow->frame.touchedIds[i];
+        if (flow->frame.values[id].state != CONST_KNOWN || flow->flowId[id] == -1) continue;
+        bool live = false;
+        for (int s = 0; s < block->succ_count && !live; s++) {
+            live = testBit(&flow->liveIn[(size_t)block->succs[s] * flow->words], flow->flowId[id]);
+        }
+        if (!live) continue;
+        flow->pending[count].id = id;
+        flow->pending[count].val = flow->frame.values[id];
+        count++;
+    }
+    qsort(flow->pending, count, sizeof(ConstEntry), compareConstEntries);
+
+    ConstList* out = &flow->out[b];
+    bool changed = !out->reached || out->count != count;
+    for (int i = 0; i < count && !changed; i++) {
+        changed = out->entries[i].id != flow->pending[i].id || !sameVal(out->entries[i].val, flow->pending[i].val);
+    }
+    if (changed) {
+        out->entries = realloc(out->entries, sizeof(ConstEntry) * (count + 1));
+        if (!out->entries) {
+            fprintf(stderr, "Memory allocation failed for constant propagation\n");
+            exit(1);
+        }
+        memcpy(out->entries, flow->pending, sizeof(ConstEntry) * count);
+        out->count = count;
+        out->reached = true;
+    }
+    return changed;
+}
+
+// Worklist over the blocks in reverse post order, a block is solved again
+// only when the constants leaving one of its predecessors changed
+static void solveConstants(ConstFlow* flow) {
+    const CFG* cfg = flow->cfg;
+    bool* dirty = malloc(sizeof(bool) * (cfg->block_count + 1));
+    if (!dirty) {
+        fprintf(stderr, "Memory allocation failed for constant propagation\n");
+        exit(1);
+    }
+    for (int b = 0; b < cfg->block_count; b++) dirty[b] = cfg->blocks[b].rpo_index != -1;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int r = 0; r < cfg->rpo_count; r++) {
+            int b = cfg->rpo[r];
+            if (!dirty[b]) continue;
+            dirty[b] = false;
+
+            const BasicBlock* block = &cfg->blocks[b];
+            enterBlock(flow, b);
+            for (TAC* tac = block->first; ; tac = tac->next) {
+                transferConst(flow->names, &flow->frame, tac);
+                if (tac == block->last) break;
+            }
+            if (leaveBlock(flow, b)) {
+                for (int s = 0; s < block->succ_count; s++) dirty[block->succs[s]] = true;
+                changed = true;
+            }
+            clearFrame(&flow->frame);
+        }
+    }
+    free(dirty);
+}
+
+static int rewriteWithConstants(ConstFlow* flow, OptimizerStats* stats) {
+    const CFG* cfg = flow->cfg;
+    const NameTable* names = flow->names;
+    ConstFrame* frame = &flow->frame;
+    int changes = 0;
+
+    for (int r = 0; r < cfg->rpo_count; r++) {
+        const BasicBlock* block = &cfg->blocks[cfg->rpo[r]];
+        enterBlock(flow, block->id);
+
+        for (TAC* tac = block->first; ; tac = tac->next) {
+            if (canSubstitute(tac->op)) {
+                if (substituteOperand(names, frame, tac, &tac->operand1)) { changes++; stats->constants_propagated++; }
+                if (substituteOperand(names, frame, tac, &tac->operand2)) { changes++; stats->constants_propagated++; }
+            }
+
+            ConstVal folded;
+            if ((isFoldableBinary(tac->op) || tac->op == TAC_NOT || tac->op == TAC_NEG) &&
+                evaluate(tac->op, operandVal(names, frame, tac, tac->operand1),
+                         operandVal(names, frame, tac, tac->operand2), &folded)) {
+                if (isOptimizerDebugOn) printf("[OPT] Folded TAC %d (%s)\n", tac->tac_id, getOperatorString(tac->op));
+                tac->op = TAC_ASSIGN;
+                tac->operand1 = constOperand(folded);
+                tac->operand2 = NULL;
+                changes++;
+                stats->expressions_folded++;
+            } else if (tac->op == TAC_IF_GOTO || tac->op == TAC_IF_FALSE_GOTO) {
+                ConstVal cond = operandVal(names, frame, tac, tac->operand1);
+                if (cond.state == CONST_KNOWN) {
+                    bool taken = (cond.value != 0) == (tac->op == TAC_IF_GOTO);
+                    if (isOptimizerDebugOn) printf("[OPT] Branch at TAC %d is %s\n", tac->tac_id, taken ? "always taken" : "never taken");
+                    if (taken) {
+                        tac->op = TAC_GOTO;
+                        tac->operand1 = NULL;
+                    } else {
+                        tac->is_removed = true;
+                    }
+                    changes++;
+                    stats->branches_folded++;
+                }
+            }
+
+            transferConst(names, frame, tac);
+            if (tac == block->last) break;
+        }
+        clearFrame(frame);
+    }
+    return changes;
+}
+
+int propagateConstants(TACList* code, OptimizerStats* stats) {
+    ProgramCFG* program = buildProgramCFG(code);
+    int changes = 0;
+
+    for (int c = 0; c < program->count; c++) {
+        const CFG* cfg = &program->cfgs[c];
+        NameTable names;
+        buildNameTable(&names, cfg);
+
+        int n = names.count + 1;
+        ConstFlow flow;
+        flow.cfg = cfg;
+        flow.names = &names;
+        flow.flowId = malloc(sizeof(int) * n);
+        flow.out = calloc(cfg->block_count + 1, sizeof(ConstList));
+        flow.pending = malloc(sizeof(ConstEntry) * n);
+        flow.frame.values = malloc(sizeof(ConstVal) * n);
+        flow.frame.touched = calloc(n, sizeof(bool));
+        flow.frame.touchedIds = malloc(sizeof(int) * n);
+        flow.frame.touchedCount = 0;
+        if (!flow.flowId || !flow.out || !flow.pending || !flow.frame.values ||
+            !flow.frame.touched || !flow.frame.touchedIds) {
+            fprintf(stderr, "Memory allocation failed for constant propagation\n");
+            exit(1);
+        }
+        for (int i = 0; i < n; i++) flow.frame.values[i] = unknownVal;
+        flow.words = numberFlowingNames(cfg, &names, flow.flowId) / BITS_PER_WORD + 1;
+
+        solveConstLiveness(&flow);
+        solveConstants(&flow);
+        changes += rewriteWithConstants(&flow, stats);
+
+        for (int b = 0; b < cfg->block_count; b++) free(flow.out[b].entries);
+        free(flow.out);
+        free(flow.liveIn);
+        free(flow.flowId);
+        free(flow.pending);
+        free(flow.frame.values);
+        free(flow.frame.touched);
+        free(flow.frame.touchedIds);
+        freeNameTable(&names);
+    }
+
+    freeProgramCFG(program);
+    return changes;
+}
+
+// ----------------------------------------------------------------------------
+// Dead code elimination
+// ----------------------------------------------------------------------------
+
+// Instructions whose only effect is writing their result
+static bool isPureDef(const TAC* tac) {
+    switch (tac->op) {
+        case TAC_ASSIGN:
+        case TAC_ADD: case TAC_SUB: case TAC_MUL:
+        case TAC_EQ: case TAC_NEQ: case TAC_LT: case TAC_GT: case TAC_LEQ: case TAC_GEQ:
+        case TAC_AND: case TAC_OR: case TAC_NOT: case TAC_NEG:
+        case TAC_POP_ARG:
+            return true;
+        case TAC_DIV:
+            // Keep divisions that may still raise a division by zero
+            return tac->operand2 && (tac->operand2->type == INT_VAL || tac->operand2->type == CHAR_VAL) &&
+                   (tac->operand2->type == INT_VAL ? tac->operand2->int_val : tac->operand2->char_val) != 0;
+        default:
+            return false;
+    }
+}
+
+// Instructions of a block as an array, for walking it backwards
+static TAC** blockInstructions(const BasicBlock* block) {
+    TAC** instrs = malloc(sizeof(TAC*) * (block->instr_count + 1));
+    if (!instrs) {
+        fprintf(stderr, "Memory allocation failed for block instructions\n");
+        exit(1);
+    }
+    int count = 0;
+    for (TAC* tac = block->first; ; tac = tac->next) {
+        instrs[count++] = tac;
+        if (tac == block->last) break;
+    }
+    return instrs;
+}
+
+// Bit of a temporary in the liveness sets, -1 for user variables and ret_val
+static int tempBit(const NameTable* names, const char* name) {
+    int id = findName(names, name);
+    return id == -1 ? -1 : names->tempIndex[id];
+}
+
+// Temporaries read by tac are added to live
+static void addUses(const NameTable* names, BitWord* live, const TAC* tac) {
+    int used[2] = {tempBit(names, operandName(tac, tac->operand1)), tempBit(names, operandName(tac, tac->operand2))};
+    for (int k = 0; k < 2; k++) {
+        if (used[k] != -1) setBit(live, used[k]);
+    }
+}
+
+// Backward liveness of temporaries, one bit per temporary. User variables and
+// ret_val are always kept, they are observable after the program ends or by the caller.
+static void solveLiveness(const CFG* cfg, const NameTable* names, BitWord* liveIn, BitWord* liveOut, int words) {
+    size_t cells = (size_t)words * cfg->block_count;
+    BitWord* gen = calloc(cells + 1, sizeof(BitWord));
+    BitWord* kill = calloc(cells + 1, sizeof(BitWord));
+    if (!gen || !kill) {
+        fprintf(stderr, "Memory allocation failed for liveness\n");
+        exit(1);
+    }
+    memset(liveIn, 0, sizeof(BitWord) * cells);
+    memset(liveOut, 0, sizeof(BitWord) * cells);
+
+    // Temporaries read before being written in the block, and those written
+    for (int b = 0; b < cfg->block_count; b++) {
+        BitWord* blockGen = &gen[(size_t)b * words];
+        BitWord* blockKill = &kill[(size_t)b * words];
+        for (TAC* tac = cfg->blocks[b].first; ; tac = tac->next) {
+            int used[2] = {tempBit(names, operandName(tac, tac->operand1)), tempBit(names, operandName(tac, tac->operand2))};
+            for (int k = 0; k < 2; k++) {
+                if (used[k] != -1 && !testBit(blockKill, used[k])) setBit(blockGen, used[k]);
+            }
+            int def = tempBit(names, tac->result);
+            if (def != -1) setBit(blockKill, def);
+            if (tac == cfg->blocks[b].last) break;
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int r = cfg->rpo_count - 1; r >= 0; r--) {
+            int b = cfg->rpo[r];
+            const BasicBlock* block = &cfg->blocks[b];
+            BitWord* out = &liveOut[(size_t)b * words];
+            BitWord* in = &liveIn[(size_t)b * words];
+            for (int w = 0; w < words; w++) {
+                for (int s = 0; s < block->succ_count; s++) out[w] |= liveIn[(size_t)block->succs[s] * words + w];
+                BitWord live = gen[(size_t)b * words + w] | (out[w] & ~kill[(size_t)b * words + w]);
+                if (in[w] != live) {
+                    in[w] = live;
+                    changed = true;
+                }
+            }
+        }
+    }
+    free(gen);
+    free(kill);
+}
+
+static int removeDeadDefs(const CFG* cfg, const NameTable* names, const BitWord* liveOut, int words, OptimizerStats* stats) {
+    int changes = 0;
+    BitWord* live = malloc(sizeof(BitWord) * (words + 1));
+    if (!live) {
+        fprintf(stderr, "Memory allocation failed for liveness\n");
+        exit(1);
+    }
+
+    for (int r = 0; r < cfg->rpo_count; r++) {
+        const BasicBlock* block = &cfg->blocks[cfg->rpo[r]];
+        memcpy(live, &liveOut[(size_t)block->id * words], sizeof(BitWord) * words);
+
+        TAC** instrs = blockInstructions(block);
+        for (int i = block->instr_count - 1; i >= 0; i--) {
+            TAC* tac = instrs[i];
+            int def = tempBit(names, tac->result);
+            if (def != -1 && !testBit(live, def) && isPureDef(tac)) {
+                if (isOptimizerDebugOn) printf("[OPT] Removed dead TAC %d (%s)\n", tac->tac_id, tac->result);
+                tac->is_removed = true;
+                changes++;
+                stats->dead_removed++;
+                continue;
+            }
+            if (def != -1) clearBit(live, def);
+            addUses(names, live, tac);
+        }
+        free(instrs);
+    }
+    free(live);
+    return changes;
+}
+
+static int removeUnreachable(const CFG* cfg, OptimizerStats* stats) {
+    int changes = 0;
+    for (int b = 0; b < cfg->block_count; b++) {
+        const BasicBlock* block = &cfg->blocks[b];
+        if (block->rpo_index != -1) continue;
+        for (TAC* tac = block->first; ; tac = tac->next) {
+            if (!tac->is_removed) {
+                if (isOptimizerDebugOn) printf("[OPT] Removed unreachable TAC %d\n", tac->tac_id);
+                tac->is_removed = true;
+                changes++;
+                stats->unreachable_removed++;
+            }
+            if (tac == block->last) break;
+        }
+    }
+    return changes;
+}
+
+// A goto whose target is the next surviving instruction
+static int removeJumpsToNext(TACList* code, OptimizerStats* stats) {
+    int changes = 0;
+    for (TAC* tac = code->head; tac; tac = tac->next) {
+        if (tac->is_removed || tac->op != TAC_GOTO) continue;
+        TAC* next = tac->next;
+        while (next && next->is_removed) next = next->next;
+        bool toNext = next ? tac->target_jump == next->tac_id : false;
+        // Removed instructions in between fall through to the same place
+        for (TAC* skipped = tac->next; !toNext && skipped && skipped != next; skipped = skipped->next) {
+            if (skipped->tac_id == tac->target_jump) toNext = true;
+        }
+        if (toNext && !tac->exit_function) {
+            tac->is_removed = true;
+            changes++;
+            stats->jumps_removed++;
+        }
+    }
+    return changes;
+}
+
+int eliminateDeadCode(TACList* code, OptimizerStats* stats) {
+    ProgramCFG* program = buildProgramCFG(code);
+    int changes = 0;
+
+    for (int c = 0; c < program->count; c++) {
+        const CFG* cfg = &program->cfgs[c];
+        changes += removeUnreachable(cfg, stats);
+
+        NameTable names;
+        buildNameTable(&names, cfg);
+        int words = names.tempCount / BITS_PER_WORD + 1;
+        BitWord* liveIn = malloc(sizeof(BitWord) * words * (cfg->block_count + 1));
+        BitWord* liveOut = malloc(sizeof(BitWord) * words * (cfg->block_count + 1));
+        if (!liveIn || !liveOut) {
+            fprintf(stderr, "Memory allocation failed for liveness\n");
+            exit(1);
+        }
+
+        solveLiveness(cfg, &names, liveIn, liveOut, words);
+        changes += removeDeadDefs(cfg, &names, liveOut, words, stats);
+
+        free(liveIn);
+        free(liveOut);
+        freeNameTable(&names);
+    }
+    freeProgramCFG(program);
+
+    changes += removeJumpsToNext(code, stats);
+    return changes;
+}
+
+// ----------------------------------------------------------------------------
+// Local value numbering
+// ----------------------------------------------------------------------------
+
+#define VN_INT_CONST  -1    // Pseudo ops keying constants in the value table
+#define VN_CHAR_CONST -2
+
+typedef struct ValueEntry {
+    int op;              // TACOp, or a VN_*_CONST pseudo op
+    int a;
+    int b;
+    int vn;
+    int holder;          // Name id last computing this value, -1 for constants
+} ValueEntry;
+
+typedef struct ValueTable {
+    ValueEntry* entries;
+    bool* used;
+    int* usedSlots;      // Entries filled in the current block
+    int usedCount;
+    int capacity;        // Power of two
+    int* curVN;          // Value number currently held by every name, -1 if not read yet
+    int* numbered;       // Names given a value number in the current block
+    int numberedCount;
+    int nextVN;
+} ValueTable;
+
+static bool isValueOp(TACOp op) {
+    return isFoldableBinary(op) || op == TAC_NOT || op == TAC_NEG;
+}
+
+static bool isCommutative(TACOp op) {
+    return op == TAC_ADD || op == TAC_MUL || op == TAC_EQ || op == TAC_NEQ || op == TAC_AND || op == TAC_OR;
+}
+
+static ValueEntry* lookupValue(ValueTable* table, int op, int a, int b) {
+    unsigned int mask = table->capacity - 1;
+    unsigned int pos = ((unsigned int)op * 31u + (unsigned int)a * 2654435761u + (unsigned int)b * 40503u) & mask;
+    while (table->used[pos]) {
+        ValueEntry* entry = &table->entries[pos];
+        if (entry->op == op && entry->a == a && entry->b == b) return entry;
+        pos = (pos + 1) & mask;
+    }
+    table->used[pos] = true;
+    table->usedSlots[table->usedCount++] = pos;
+    ValueEntry* entry = &table->entries[pos];
+    entry->op = op;
+    entry->a = a;
+    entry->b = b;
+    entry->vn = -1;
+    entry->holder = -1;
+    return entry;
+}
+
+static void setVN(ValueTable* table, int id, int vn) {
+    if (table->curVN[id] == -1) table->numbered[table->numberedCount++] = id;
+    table->curVN[id] = vn;
+}
+
+static int operandVN(const NameTable* names, ValueTable* table, const TAC* tac, const Operand* opr) {
+    if (!opr) return -1;
+    switch (opr->type) {
+        case INT_VAL:
+        case CHAR_VAL: {
+            ValueEntry* entry = lookupValue(table, opr->type == INT_VAL ? VN_INT_CONST : VN_CHAR_CONST,
+                                            opr->type == INT_VAL ? opr->int_val : opr->char_val, 0);
+            if (entry->vn == -1) entry->vn = table->nextVN++;
+            return entry->vn;
+        }
+        case ID_REF: {
+            int id = findName(names, operandName(tac, opr));
+            if (id == -1) return table->nextVN++;
+            if (table->curVN[id] == -1) setVN(table, id, table->nextVN++);
+            return table->curVN[id];
+        }
+        default:
+            return table->nextVN++;
+    }
+}
+
+static int numberBlock(const BasicBlock* block, const NameTable* names, ValueTable* table, OptimizerStats* stats) {
+    int changes = 0;
+
+    for (TAC* tac = block->first; ; tac = tac->next) {
+        int result = findName(names, tac->result);
+        if (isValueOp(tac->op) && result != -1) {
+            int a = operandVN(names, table, tac, tac->operand1);
+            int b = tac->operand2 ? operandVN(names, table, tac, tac->operand2) : -1;
+            if (isCommutative(tac->op) && a > b) {
+                int swap = a;
+                a = b;
+                b = swap;
+            }
+
+            ValueEntry* entry = lookupValue(table, tac->op, a, b);
+            if (entry->vn != -1 && entry->holder != -1 && table->curVN[entry->holder] == entry->vn) {
+                if (isOptimizerDebugOn) printf("[OPT] Reused %s for TAC %d (%s)\n", names->names[entry->holder], tac->tac_id, getOperatorString(tac->op));
+                if (entry->holder == result) {
+                    tac->is_removed = true;
+                } else {
+                    tac->op = TAC_ASSIGN;
+                    tac->operand1 = makeOperand(ID_REF, names->names[entry->holder]);
+                    tac->operand2 = NULL;
+                }
+                changes++;
+                stats->expressions_reused++;
+            } else {
+                if (entry->vn == -1) entry->vn = table->nextVN++;
+                entry->holder = result;
+            }
+            setVN(table, result, entry->vn);
+        } else if (tac->op == TAC_ASSIGN && tac->operand1 && result != -1) {
+            setVN(table, result, operandVN(names, table, tac, tac->operand1));
+        } else {
+            if (tac->op == TAC_CALL) {
+                // The callee may write ret_val and any user variable. A name not
+                // numbered in this block gets a fresh number when first read anyway.
+                for (int i = 0; i < table->numberedCount; i++) {
+                    int id = table->numbered[i];
+                    if (!names->temp[id]) table->curVN[id] = table->nextVN++;
+                }
+            } else if (tac->op == TAC_PRE_INC || tac->op == TAC_PRE_DEC ||
+                       tac->op == TAC_POST_INC || tac->op == TAC_POST_DEC) {
+                int target = findName(names, operandName(tac, tac->operand1));
+                if (target != -1) setVN(table, target, table->nextVN++);
+            }
+            if (result != -1) setVN(table, result, table->nextVN++);
+        }
+        if (tac == block->last) break;
+    }
+
+    // Forget only what this block numbered
+    for (int i = 0; i < table->numberedCount; i++) table->curVN[table->numbered[i]] = -1;
+    for (int i = 0; i < table->usedCount; i++) table->used[table->usedSlots[i]] = false;
+    table->numberedCount = 0;
+    table->usedCount = 0;
+    return changes;
+}
+
+int valueNumberBlocks(TACList* code, OptimizerStats* stats) {
+    ProgramCFG* program = buildProgramCFG(code);
+    int changes = 0;
+
+    for (int c = 0; c < program->count; c++) {
+        const CFG* cfg = &program->cfgs[c];
+        NameTable names;
+        buildNameTable(&names, cfg);
+
+        // At most one constant per operand and one expression per instruction
+        int largest = 0;
+        for (int b = 0; b < cfg->block_count; b++) {
+            if (cfg->blocks[b].instr_count > largest) largest = cfg->blocks[b].instr_count;
+        }
+        ValueTable table;
+        table.capacity = 16;
+        while (table.capacity < largest * 6) table.capacity *= 2;
+        table.entries = malloc(sizeof(ValueEntry) * table.capacity);
+        table.used = calloc(table.capacity, sizeof(bool));
+        table.usedSlots = malloc(sizeof(int) * table.capacity);
+        table.usedCount = 0;
+        table.curVN = malloc(sizeof(int) * (names.count + 1));
+        table.numbered = malloc(sizeof(int) * (names.count + 1));
+        table.numberedCount = 0;
+        table.nextVN = 0;
+        if (!table.entries || !table.used || !table.usedSlots || !table.curVN || !table.numbered) {
+            fprintf(stderr, "Memory allocation failed for value numbering\n");
+            exit(1);
+        }
+        for (int i = 0; i < names.count; i++) table.curVN[i] = -1;
+
+        for (int r = 0; r < cfg->rpo_count; r++) {
+            changes += numberBlock(&cfg->blocks[cfg->rpo[r]], &names, &table, stats);
+        }
+
+        free(table.entries);
+        free(table.used);
+        free(table.usedSlots);
+        free(table.curVN);
+        free(table.numbered);
+        freeNameTable(&names);
+    }
+
+    freeProgramCFG(program);
+    return changes;
+}
+
+// ----------------------------------------------------------------------------
+// Copy propagation
+// ----------------------------------------------------------------------------
+
+// Copies "t = src" into a temporary, valid until either side is redefined
+typedef struct CopyTable {
+    int* source;         // Name id copied into every temporary, -1 if none
+    int* sourceVersion;  // version[source] when the copy was made
+    int* version;        // Bumped on every definition of a name
+    bool* touched;       // Defined or copied from in the current block
+    int* touchedIds;
+    int touchedCount;
+} CopyTable;
+
+static void touchName(CopyTable* copies, int id) {
+    if (copies->touched[id]) return;
+    copies->touched[id] = true;
+    copies->touchedIds[copies->touchedCount++] = id;
+}
+
+static void defineName(CopyTable* copies, int id) {
+    if (id == -1) return;
+    touchName(copies, id);
+    copies->version[id]++;
+    copies->source[id] = -1;
+}
+
+static bool substituteCopy(const NameTable* names, const CopyTable* copies, TAC* tac, Operand** opr) {
+    int id = findName(names, operandName(tac, *opr));
+    if (id == -1 || copies->source[id] == -1) return false;
+    int src = copies->source[id];
+    if (copies->version[src] != copies->sourceVersion[id]) return false;
+    *opr = makeOperand(ID_REF, names->names[src]);
+    return true;
+}
+
+static int propagateBlockCopies(const BasicBlock* block, const NameTable* names, CopyTable* copies, OptimizerStats* stats) {
+    int changes = 0;
+    for (TAC* tac = block->first; ; tac = tac->next) {
+        if (canSubstitute(tac->op)) {
+            if (substituteCopy(names, copies, tac, &tac->operand1)) { changes++; stats->copies_propagated++; }
+            if (substituteCopy(names, copies, tac, &tac->operand2)) { changes++; stats->copies_propagated++; }
+        }
+
+        int result = findName(names, tac->result);
+        int src = findName(names, operandName(tac, tac->operand1));
+        if (tac->op == TAC_ASSIGN && result != -1 && src == result) {
+            // "x = x", left behind when "t = ret_val; ret_val = t" is propagated
+            if (isOptimizerDebugOn) printf("[OPT] Removed self copy of %s at TAC %d\n", tac->result, tac->tac_id);
+            tac->is_removed = true;
+            changes++;
+            stats->copies_coalesced++;
+        } else {
+            if (tac->op == TAC_CALL) {
+                // The callee may write ret_val and any user variable. Only names
+                // touched in this block can be the source of a live copy.
+                for (int i = 0; i < copies->touchedCount; i++) {
+                    int id = copies->touchedIds[i];
+                    if (!names->temp[id]) defineName(copies, id);
+                }
+            } else if (tac->op == TAC_PRE_INC || tac->op == TAC_PRE_DEC ||
+                       tac->op == TAC_POST_INC || tac->op == TAC_POST_DEC) {
+                defineName(copies, findName(names, operandName(tac, tac->operand1)));
+            }
+            defineName(copies, result);
+
+            // Only copies into temporaries are tracked, rewriting reads of a user
+            // variable would just stretch the life of the temporary it came from
+            if (tac->op == TAC_ASSIGN && result != -1 && src != -1 && names->temp[result]) {
+                touchName(copies, src);
+                copies->source[result] = src;
+                copies->sourceVersion[result] = copies->version[src];
+            }
+        }
+        if (tac == block->last) break;
+    }
+
+    // Forget only what this block touched
+    for (int i = 0; i < copies->touchedCount; i++) {
+        int id = copies->touchedIds[i];
+        copies->source[id] = -1;
+        copies->version[id] = 0;
+        copies->touched[id] = false;
+    }
+    copies->touchedCount = 0;
+    return changes;
+}
+
+// Instructions that compute their result in place, so "t = <op>; x = t" can become "x = <op>"
+static bool canRetarget(const TAC* tac) {
+    if (tac->is_removed || !tac->result) return false;
+    if (tac->op == TAC_ASSIGN) return tac->operand1 != NULL;
+    return isValueOp(tac->op) || tac->op == TAC_POP_ARG;
+}
+
+// Folds "t = <op>; x = t" into "x = <op>" when t is not read again
+static int coalesceBlockCopies(const BasicBlock* block, const NameTable* names, BitWord* live, OptimizerStats* stats) {
+    int changes = 0;
+    TAC** instrs = blockInstructions(block);
+    for (int i = block->instr_count - 1; i >= 0; i--) {
+        TAC* tac = instrs[i];
+        const char* temp = operandName(tac, tac->operand1);
+        int tempId = tempBit(names, temp);
+        if (i > 0 && tac->op == TAC_ASSIGN && tempId != -1 && !testBit(live, tempId) &&
+            temp != tac->result && canRetarget(instrs[i - 1]) && instrs[i - 1]->result == temp) {
+            if (isOptimizerDebugOn) printf("[OPT] Coalesced %s into %s at TAC %d\n", temp, tac->result, instrs[i - 1]->tac_id);
+            instrs[i - 1]->result = tac->result;
+            tac->is_removed = true;
+            changes++;
+            stats->copies_coalesced++;
+            continue;
+        }
+        int def = tempBit(names, tac->result);
+        if (def != -1) clearBit(live, def);
+        addUses(names, live, tac);
+    }
+    free(instrs);
+    return changes;
+}
+
+int propagateCopies(TACList* code, OptimizerStats* stats) {
+    ProgramCFG* program = buildProgramCFG(code);
+    int changes = 0;
+
+    for (int c = 0; c < program->count; c++) {
+        const CFG* cfg = &program->cfgs[c];
+        NameTable names;
+        buildNameTable(&names, cfg);
+
+        CopyTable copies;
+        copies.source = malloc(sizeof(int) * (names.count + 1));
+        copies.sourceVersion = malloc(sizeof(int) * (names.count + 1));
+        copies.version = calloc(names.count + 1, sizeof(int));
+        copies.touched = calloc(names.count + 1, sizeof(bool));
+        copies.touchedIds = malloc(sizeof(int) * (names.count + 1));
+        copies.touchedCount = 0;
+        if (!copies.source || !copies.sourceVersion || !copies.version || !copies.touched || !copies.touchedIds) {
+            fprintf(stderr, "Memory allocation failed for copy propagation\n");
+            exit(1);
+        }
+        for (int i = 0; i < names.count; i++) copies.source[i] = -1;
+        for (int r = 0; r < cfg->rpo_count; r++) {
+            changes += propagateBlockCopies(&cfg->blocks[cfg->rpo[r]], &names, &copies, stats);
+        }
+        free(copies.source);
+        free(copies.sourceVersion);
+        free(copies.version);
+        free(copies.touched);
+        free(copies.touchedIds);
+
+        // Liveness after propagation, the copies it bypassed no longer keep their temporaries alive
+        int words = names.tempCount / BITS_PER_WORD + 1;
+        BitWord* liveIn = malloc(sizeof(BitWord) * words * (cfg->block_count + 1));
+        BitWord* liveOut = malloc(sizeof(BitWord) * words * (cfg->block_count + 1));
+        if (!liveIn || !liveOut) {
+            fprintf(stderr, "Memory allocation failed for liveness\n");
+            exit(1);
+        }
+        solveLiveness(cfg, &names, liveIn, liveOut, words);
+        for (int r = 0; r < cfg->rpo_count; r++) {
+            int b = cfg->rpo[r];
+            changes += coalesceBlockCopies(&cfg->blocks[b], &names, &liveOut[(size_t)b * words], stats);
+        }
+
+        free(liveIn);
+        free(liveOut);
+        freeNameTable(&names);
+    }
+
+    freeProgramCFG(program);
+    return changes;
+}
+
+// ----------------------------------------------------------------------------
+// Driver
+// ----------------------------------------------------------------------------
+
+static bool isJumpOrCall(TACOp op) {
+    return op == TAC_GOTO || op == TAC_IF_GOTO || op == TAC_IF_FALSE_GOTO || op == TAC_CALL;
+}
+
+void compactTAC(TACList* code) {
+    if (!code || !code->head) return;
+
+    int maxId = 0;
+    for (TAC* tac = code->head; tac; tac = tac->next) {
+        if (tac->tac_id > maxId) maxId = tac->tac_id;
+    }
+
+    // Function boundaries move to the nearest surviving instruction
+    TAC* prevKept = NULL;
+    for (TAC* tac = code->head; tac; tac = tac->next) {
+        if (tac->is_removed) {
+            if (tac->enter_function) {
+                TAC* next = tac->next;
+                while (next && next->is_removed) next = next->next;
+                if (next) {
+                    next->enter_function = tac->enter_function;
+                    next->function_node = tac->function_node;
+                }
+            }
+            if (tac->exit_function && prevKept && !prevKept->exit_function) {
+                prevKept->exit_function = tac->exit_function;
+            }
+        } else {
+            prevKept = tac;
+        }
+    }
+
+    // New id of every old id. A removed instruction maps to the next survivor,
+    // and maxId + 1 (past the end) maps past the new end.
+    int* newId = malloc(sizeof(int) * (maxId + 2));
+    if (!newId) {
+        fprintf(stderr, "Memory allocation failed for TAC compaction\n");
+        exit(1);
+    }
+    int kept = 0;
+    for (TAC* tac = code->head; tac; tac = tac->next) {
+        if (!tac->is_removed) kept++;
+    }
+    int nextSurvivor = kept + 1;
+    for (int i = 0; i <= maxId + 1; i++) newId[i] = -1;
+    newId[maxId + 1] = nextSurvivor;
+
+    // Walk backwards through a temporary array of the list
+    TAC** order = malloc(sizeof(TAC*) * (countTAC(code) + 1));
+    int count = 0;
+    for (TAC* tac = code->head; tac; tac = tac->next) order[count++] = tac;
+    int id = kept;
+    for (int i = count - 1; i >= 0; i--) {
+        if (!order[i]->is_removed) nextSurvivor = id--;
+        newId[order[i]->tac_id] = nextSurvivor;
+    }
+
+    TAC* head = NULL;
+    TAC* tail = NULL;
+    for (int i = 0; i < count; i++) {
+        TAC* tac = order[i];
+        if (tac->is_removed) continue;
+        if (isJumpOrCall(tac->op) && tac->target_jump > 0 && tac->target_jump <= maxId + 1) {
+            tac->target_jump = newId[tac->target_jump];
+        }
+        tac->tac_id = newId[tac->tac_id];
+        tac->next = NULL;
+        if (tail) tail->next = tac;
+        else head = tac;
+        tail = tac;
+    }
+    code->head = head;
+    code->tail = tail;
+
+    free(order);
+    free(newId);
+}
+
+void optimizeTAC(TACList* code, int level, OptimizerStats* stats) {
+    OptimizerStats local_stats;
+    if (!stats) stats = &local_stats;
+    memset(stats, 0, sizeof(*stats));
+    stats->instructions_before = countTAC(code);
+
+    if (level >= 1) {
+        for (int round = 0; round < MAX_OPT_ROUNDS; round++) {
+            int changes = propagateConstants(code, stats);
+            compactTAC(code);
+            changes += valueNumberBlocks(code, stats);
+            compactTAC(code);
+            changes += propagateCopies(code, stats);
+            compactTAC(code);
+            changes += eliminateDeadCode(code, stats);
+            compactTAC(code);
+            if (isOptimizerDebugOn) printf("[OPT] Round %d: %d changes\n", round + 1, changes);
+            if (changes == 0) break;
+        }
+    }
+
+    stats->instructions_after = countTAC(code);
+}
+
+void printOptimizerStats(const OptimizerStats* stats) {
+    if (!stats) return;
+    printf("\nOptimizerStats---------------------------\n\n");
+    printf("Instructions           : %d -> %d\n", stats->instructions_before, stats->instructions_after);
+    printf("Constants propagated   : %d\n", stats->constants_propagated);
+    printf("Expressions folded     : %d\n", stats->expressions_folded);
+    printf("Branches folded        : %d\n", stats->branches_folded);
+    printf("Expressions reused     : %d\n", stats->expressions_reused);
+    printf("Copies propagated      : %d\n", stats->copies_propagated);
+    printf("Copies coalesced       : %d\n", stats->copies_coalesced);
+    printf("Dead code removed      : %d\n", stats->dead_removed);
+    printf("Unreachable removed    : %d\n", stats->unreachable_removed);
+    printf("Jumps removed          : %d\n", stats->jumps_removed);
+}
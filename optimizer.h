@@ -0,0 +1,36 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "icg.h"
+#include "cfg.h"
+
+typedef struct OptimizerStats {
+    int instructions_before;
+    int instructions_after;
+    int constants_propagated;   // Operands replaced by a known constant
+    int expressions_folded;     // Operations evaluated at compile time
+    int branches_folded;        // Conditional jumps with a constant condition
+    int expressions_reused;     // Recomputations replaced by a copy of an earlier result
+    int copies_propagated;      // Reads of a copied temporary replaced by its source
+    int copies_coalesced;       // "t = <op>; x = t" pairs merged into "x = <op>", and "x = x" dropped
+    int dead_removed;           // Assignments to temporaries that are never read
+    int unreachable_removed;    // Instructions no path from the entry reaches
+    int jumps_removed;          // Jumps to the very next instruction
+} OptimizerStats;
+
+void setOptimizerDebugger();
+
+// Runs the passes enabled at the given level (-O1 = 1) over codeList
+void optimizeTAC(TACList* code, int level, OptimizerStats* stats);
+void printOptimizerStats(const OptimizerStats* stats);
+
+// Individual passes, each returns the number of changes it made
+int propagateConstants(TACList* code, OptimizerStats* stats);
+int valueNumberBlocks(TACList* code, OptimizerStats* stats);
+int propagateCopies(TACList* code, OptimizerStats* stats);
+int eliminateDeadCode(TACList* code, OptimizerStats* stats);
+
+// Unlinks instructions marked is_removed, renumbers tac_ids and retargets jumps
+void compactTAC(TACList* code);
+
+#endif
@@ -9,8 +9,15 @@
 #include <errno.h>
 #include <stdbool.h>
 #include "semantic.h"
+#include "interpreter.h"
+#include "asmGen.h"
+#include "jit.h"
+#include "cfg.h"
+#include "optimizer.h"
 #include "icg.h"
 #include "logger.h"
+#include "intern.h"
+#include "stats.h"
 
 #define GLOBAL "global"
 #define FUNCTION "function"
@@ -41,11 +48,13 @@ BrkCntStmtsList* brkCntList = NULL;
 BrkCntStmtsList* brkCntListHEAD = NULL;
 
 const char *folderPathForAST_Vis = "AST_Vis";
+const char *folderPathForASM = "ASM";
 const char *folderPathForGrammar = "Grammar"; 
 int scopeDepth = 0;
 int func_id = 1;
 
 void log_rule(const char* rule, int ruleNo) {
+    if (!isTraceOn()) return;
     Step s;
     s.type = PARSE_REDUCE_RULE;
     s.reduceRule.ruleNo = ruleNo;
@@ -54,6 +63,7 @@ void log_rule(const char* rule, int ruleNo) {
 }
 
 void log_rule_complete(const char* lhs, int rhsLength, int ruleNo) {
+    if (!isTraceOn()) return;
     Step s;
     s.type = PARSE_REDUCE_RULE_COMPLETE;
     s.ReduceRuleComplete.ruleNo = ruleNo;
@@ -63,6 +73,7 @@ void log_rule_complete(const char* lhs, int rhsLength, int ruleNo) {
 }
 
 void log_semantic_step(const char* instr, int ruleNo, int stepNo) {
+    if (!isTraceOn()) return;
     Step s;
     s.type = PARSE_SEMANTIC_STEP;
     s.SemanticStep.instr = instr;
@@ -72,15 +83,17 @@ void log_semantic_step(const char* instr, int ruleNo, int stepNo) {
 }
 
 void log_assgn_sym_type(const char* sym_name, int scope_id, const char* type) {
+    if (!isTraceOn()) return;
     Step s;
     s.type = PARSE_ASSGN_SYM_TYPE;
     s.AssignSymType.name = sym_name;
     s.AssignSymType.scope_id = scope_id;
-    s.AssignSymType.type = (char *)type;
+    s.AssignSymType.type = type;
     log_step(s);
 }
 
 void log_semantic_analysis_complete(const char* status, int total_errors) {
+    if (!isTraceOn()) return;
     Step s;
     s.type = SEMANTIC_ANALYSIS_COMPLETE;
     s.SemanticAnalysisComplete.status = status;
@@ -89,6 +102,7 @@ void log_semantic_analysis_complete(const char* status, int total_errors) {
 }
 
 void log_parse_error(const char* message, int line_no, int char_no) {
+    if (!isTraceOn()) return;
     Step s;
     s.type = PARSE_ERROR;
     s.ParseError.message = message;
@@ -114,6 +128,7 @@ void log_parse_stack_snapshot(const void *b,
     const yy_state_t *top    = (const yy_state_t *)t;
 
     /* CRITICAL GUARD */
+    if (!isTraceOn()) return;
     if (bottom == NULL || top == NULL || bottom > top) {
         return;
     }
@@ -138,6 +153,7 @@ void log_parse_stack_snapshot(const void *b,
     step2.ParseStackSnapshot.states = states;
     step2.ParseStackSnapshot.size = size;
     log_step(step2);
+    free(states);
 }
 
 
@@ -156,15 +172,15 @@ ASTNode* createProgramNode(ASTNode* stmt_list, SourceSpan span);
 ASTNode* createStmtListNode(ASTNode* stmtList, ASTNode* stmt, SourceSpan span);
 ASTNode* createBlockStmtNode(ASTNode* stmt_list, SourceSpan span);
 ASTNode* createReturnNode(ASTNode* return_value, SourceSpan span);
-ASTNode* createBinaryExpNode(ASTNode* left, ASTNode* right, const char* op, SourceSpan span);
-ASTNode* createUnaryExpNode(ASTNode* left, const char* op, SourceSpan span);
+ASTNode* createBinaryExpNode(ASTNode* left, ASTNode* right, Operator op, SourceSpan span);
+ASTNode* createUnaryExpNode(ASTNode* left, Operator op, SourceSpan span);
 ASTNode* createTermExpNode(ASTNode* term, SourceSpan span);
-ASTNode* createIdentifierNode(const char* id, char* type, SourceSpan span);
+ASTNode* createIdentifierNode(const char* id, TypeId type, SourceSpan span);
 ASTNode* createIdRefNode(const char* id, SourceSpan span);
 ASTNode* createIntLiteralNode(int i, SourceSpan span);
 ASTNode* createCharLiteralNode(char c, SourceSpan span);
 ASTNode* createStrLiteralNode(const char* s, SourceSpan span);
-ASTNode* createTypeNode(char* type, SourceSpan span);
+ASTNode* createTypeNode(TypeId type, SourceSpan span);
 ASTNode* createDeclNode(ASTNode* type_spec, ASTNode* var_list, SourceSpan span);
 void setVarListType(ASTNode* typeNode, ASTNode* var_list);
 ASTNode* createVarNode(const char* id, SourceSpan span, SourceSpan id_span);
@@ -708,25 +724,25 @@ type_spec:
     INT { 
         log_rule("type_spec → INT", 59); 
         log_semantic_step("$$ = createTypeNode(INT)", 59, 1);
-        $$ = createTypeNode("int", YYLOC_TO_SPAN(@$)); 
+        $$ = createTypeNode(TYPE_INT, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("type_spec", 1, 59);
     }               
     | CHAR { 
         log_rule("type_spec → CHAR", 60); 
         log_semantic_step("$$ = createTypeNode(CHAR)", 60, 1);
-        $$ = createTypeNode("char", YYLOC_TO_SPAN(@$)); 
+        $$ = createTypeNode(TYPE_CHAR, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("type_spec", 1, 60);
     }     
     | FLOAT { 
         log_rule("type_spec → FLOAT", 61); 
         log_semantic_step("$$ = createTypeNode(FLOAT)", 61, 1);
-        $$ = createTypeNode("float", YYLOC_TO_SPAN(@$)); 
+        $$ = createTypeNode(TYPE_FLOAT, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("type_spec", 1, 61);
     }          
     | STRING { 
         log_rule("type_spec → STRING", 62); 
         log_semantic_step("$$ = createTypeNode(STRING)", 62, 1);
-        $$ = createTypeNode("string", YYLOC_TO_SPAN(@$)); 
+        $$ = createTypeNode(TYPE_STRING, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("type_spec", 1, 62);
     }           
     ;
@@ -790,7 +806,7 @@ func_header:
     | VOID ID '(' {
         log_rule("func_header → VOID ID '('", 69);
         log_semantic_step("$$.type = createTypeNode(VOID)", 69, 1);
-        $$.type = createTypeNode("void", YYLOC_TO_SPAN(@$));
+        $$.type = createTypeNode(TYPE_VOID, YYLOC_TO_SPAN(@$));
         log_semantic_step("$$.id = createFuncIdNode($2, $$.type)", 69, 2);
         $$.id = createFuncIdNode($2, $$.type, YYLOC_TO_SPAN(@2));
         log_semantic_step("enterFunctionScope()", 69, 3);
@@ -878,109 +894,109 @@ expr:
     expr PLUS expr          { 
         log_rule("expr → expr PLUS expr", 79); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, +)", 79, 1);
-        $$ = createBinaryExpNode($1, $3, "+", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_ADD, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 79);
     }              
     | expr MINUS expr       { 
         log_rule("expr → expr MINUS expr", 80); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, -)", 80, 1);
-        $$ = createBinaryExpNode($1, $3, "-", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_SUB, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 80);
     }
     | expr MULT expr        { 
         log_rule("expr → expr MULT expr", 81); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, *)", 81, 1);
-        $$ = createBinaryExpNode($1, $3, "*", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_MUL, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 81);
     }
     | expr DIV expr         { 
         log_rule("expr → expr DIV expr", 82); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, /)", 82, 1);
-        $$ = createBinaryExpNode($1, $3, "/", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_DIV, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 82);
     }
     | expr EQ expr          { 
         log_rule("expr → expr EQ expr", 83); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, ==)", 83, 1);
-        $$ = createBinaryExpNode($1, $3, "==", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_EQ, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 83);
     }
     | expr NEQ expr         { 
         log_rule("expr → expr NEQ expr", 84); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, !=)", 84, 1);
-        $$ = createBinaryExpNode($1, $3, "!=", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_NEQ, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 84);
     }
     | expr LT expr          { 
         log_rule("expr → expr LT expr", 85); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, <)", 85, 1);
-        $$ = createBinaryExpNode($1, $3, "<", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_LT, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 85);
     }
     | expr GT expr          { 
         log_rule("expr → expr GT expr", 86); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, >)", 86, 1);
-        $$ = createBinaryExpNode($1, $3, ">", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_GT, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 86);
     }
     | expr LEQ expr         { 
         log_rule("expr → expr LEQ expr", 87); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, <=)", 87, 1);
-        $$ = createBinaryExpNode($1, $3, "<=", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_LEQ, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 87);
     }
     | expr GEQ expr         { 
         log_rule("expr → expr GEQ expr", 88); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, >=)", 88, 1);
-        $$ = createBinaryExpNode($1, $3, ">=", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_GEQ, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 88);
     }
     | expr AND expr         { 
         log_rule("expr → expr AND expr", 89); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, &&)", 89, 1);
-        $$ = createBinaryExpNode($1, $3, "&&", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_AND, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 89);
     }
     | expr OR expr          { 
         log_rule("expr → expr OR expr", 90); 
         log_semantic_step("$$ = createBinaryExpNode($1, $3, ||)", 90, 1);
-        $$ = createBinaryExpNode($1, $3, "||", YYLOC_TO_SPAN(@$)); 
+        $$ = createBinaryExpNode($1, $3, OP_OR, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 3, 90);
     }
     | NOT expr %prec UNARY  { 
         log_rule("expr → NOT expr", 91); 
         log_semantic_step("$$ = createUnaryExpNode($2, !)", 91, 1);
-        $$ = createUnaryExpNode($2, "!", YYLOC_TO_SPAN(@$)); 
+        $$ = createUnaryExpNode($2, OP_NOT, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 2, 91);
     }
     | MINUS expr %prec UNARY{ 
         log_rule("expr → MINUS expr", 92); 
         log_semantic_step("$$ = createUnaryExpNode($2, -)", 92, 1);
-        $$ = createUnaryExpNode($2, "-", YYLOC_TO_SPAN(@$)); 
+        $$ = createUnaryExpNode($2, OP_SUB, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 2, 92);
     }
     | INC expr %prec UNARY  { 
         log_rule("expr → INC expr", 93); 
         log_semantic_step("$$ = createUnaryExpNode($2, PRE_INC)", 93, 1);
-        $$ = createUnaryExpNode($2, "PRE_INC", YYLOC_TO_SPAN(@$)); 
+        $$ = createUnaryExpNode($2, OP_PRE_INC, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 2, 93);
     }
     | DEC expr %prec UNARY  { 
         log_rule("expr → DEC expr", 94); 
         log_semantic_step("$$ = createUnaryExpNode($2, PRE_DEC)", 94, 1);
-        $$ = createUnaryExpNode($2, "PRE_DEC", YYLOC_TO_SPAN(@$)); 
+        $$ = createUnaryExpNode($2, OP_PRE_DEC, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 2, 94);
     }
     | expr INC %prec UNARY  { 
         log_rule("expr → expr INC", 95); 
         log_semantic_step("$$ = createUnaryExpNode($1, POST_INC)", 95, 1);
-        $$ = createUnaryExpNode($1, "POST_INC", YYLOC_TO_SPAN(@$)); 
+        $$ = createUnaryExpNode($1, OP_POST_INC, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 2, 95);
     }
     | expr DEC %prec UNARY  { 
         log_rule("expr → expr DEC", 96); 
         log_semantic_step("$$ = createUnaryExpNode($1, POST_DEC)", 96, 1);
-        $$ = createUnaryExpNode($1, "POST_DEC", YYLOC_TO_SPAN(@$)); 
+        $$ = createUnaryExpNode($1, OP_POST_DEC, YYLOC_TO_SPAN(@$)); 
         log_rule_complete("expr", 2, 96);
     }
     | ID                    { 
@@ -1041,7 +1057,6 @@ void yyerror(const char* s) {
 
 extern int yydebug;
 int main(int argc, char *argv[]){
-    yydebug = 1;
 
     // Run time flags
     int exportAST_flag = 0;  
@@ -1052,8 +1067,22 @@ int main(int argc, char *argv[]){
     int debug_ast_flag = 0;
     int debug_semantic_flag = 0;
     int debug_icg_flag = 0;
-    init_logger();
-    initASTRegistry();
+    int run_flag = 0;
+    int print_bytecode_flag = 0;
+    int emit_asm_flag = 0;
+    int jit_flag = 0;
+    int print_cfg_flag = 0;
+    int opt_level = 0;
+    int debug_opt_flag = 0;
+    int debug_cfg_flag = 0;
+    int debug_jit_flag = 0;
+    int debug_asm_flag = 0;
+    int debug_interp_flag = 0;
+    int stats_flag = 0;
+    int stats_json_flag = 0;
+    int no_trace_flag = 0;
+    initASTArena();
+    initInternTable();
 
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--export-ast") == 0) {
@@ -1081,28 +1110,88 @@ int main(int argc, char *argv[]){
         if (strcmp(argv[i], "--debug-icg") == 0) {
             debug_icg_flag = 1;
         }
+        if (strcmp(argv[i], "--run") == 0) {
+            run_flag = 1;
+        }
+        if (strcmp(argv[i], "--print-bytecode") == 0) {
+            print_bytecode_flag = 1;
+        }
+        if (strcmp(argv[i], "--emit-asm") == 0) {
+            emit_asm_flag = 1;
+        }
+        if (strcmp(argv[i], "--jit") == 0) {
+            jit_flag = 1;
+        }
+        if (strcmp(argv[i], "--print-cfg") == 0) {
+            print_cfg_flag = 1;
+        }
+        if (strcmp(argv[i], "-O0") == 0) {
+            opt_level = 0;
+        }
+        if (strcmp(argv[i], "-O1") == 0) {
+            opt_level = 1;
+        }
+        if (strcmp(argv[i], "--debug-opt") == 0) {
+            debug_opt_flag = 1;
+        }
+        if (strcmp(argv[i], "--debug-cfg") == 0) {
+            debug_cfg_flag = 1;
+        }
+        if (strcmp(argv[i], "--debug-jit") == 0) {
+            debug_jit_flag = 1;
+        }
+        if (strcmp(argv[i], "--debug-asm") == 0) {
+            debug_asm_flag = 1;
+        }
+        if (strcmp(argv[i], "--debug-interp") == 0) {
+            debug_interp_flag = 1;
+        }
+        if (strcmp(argv[i], "--stats") == 0) {
+            stats_flag = 1;
+        }
+        if (strcmp(argv[i], "--stats=json") == 0) {
+            stats_flag = 1;
+            stats_json_flag = 1;
+        }
+        if (strcmp(argv[i], "--no-trace") == 0) {
+            no_trace_flag = 1;
+        }
     }
 
+    // Step tracing for the visualizer, including bison's own trace
+    if(no_trace_flag)       setTraceEnabled(false);
+    yydebug = isTraceOn() ? 1 : 0;
+    init_logger();
+
     // Turn on debuggers
     if(debug_flag){
         setASTDebugger();
         setSymTableDebugger();
         setSemanticDebugger();
         setICGDebugger();
+        setInternDebugger();
     }
 
     if(debug_sym_table)     setSymTableDebugger();
     if(debug_ast_flag)      setASTDebugger();
     if(debug_semantic_flag) setSemanticDebugger();
     if(debug_icg_flag)      setICGDebugger();
+    if(debug_interp_flag)   setInterpreterDebugger();
+    if(debug_jit_flag)      setJITDebugger();
+    if(debug_asm_flag)      setAsmGenDebugger();
+    if(debug_opt_flag)      setOptimizerDebugger();
+    if(debug_cfg_flag)      setCFGDebugger();
+    if(stats_flag)          enableStats(stats_json_flag);
   
     // Phase 1: Lexing + Parsing
     start_phase(PHASE_LEX_PARSE);
+    beginPhaseStats("parse");
 
     symTable = createSymbolTable("global", NULL, 100);
     currentScope = symTable; // Initial current scope
     
     int parse_status = yyparse();
+    endPhaseStats(symTable);
 
     if (parse_status != 0 || hasParseError) {
         log_parse_error(
@@ -1127,10 +1216,11 @@ int main(int argc, char *argv[]){
             exportASTAsJSON(folderPathForAST_Vis, root);
         }
 
+        printPhaseStats();
         close_logger();
-        freeAST(root);
-        freeASTRegistry();
+        freeASTArena();
         freeSymbolTable(symTable);
+        freeInternTable();
         return 1;
     }
 
@@ -1138,7 +1228,9 @@ int main(int argc, char *argv[]){
 
     if (debug_flag || debug_semantic_flag) printf("\n------SEMANTIC ANALYSIS START------\n\n");
     start_phase(PHASE_SEMANTIC);
+    beginPhaseStats("semantic");
     SemanticStatus sem_stat = performSemanticAnalysis(root, symTable, brkCntListHEAD);
+    endPhaseStats(symTable);
     log_semantic_analysis_complete(
         sem_stat == SEMANTIC_SUCCESS ? "SUCCESS" : "ERROR",
         getSemanticTotalErrors()
@@ -1165,22 +1257,75 @@ int main(int argc, char *argv[]){
         printf("\nPARSING SUCCESS\n");
 
         start_phase(PHASE_ICG);
+        beginPhaseStats("icg");
         startICG(root);
         logICGPlaybackTrace();
+        endPhaseStats(symTable);
         end_phase();
 
+        OptimizerStats opt_stats;
+        if(opt_level > 0){
+            beginPhaseStats("optimize");
+            optimizeTAC(codeList, opt_level, &opt_stats);
+            endPhaseStats(symTable);
+        }
+
         printf("\nThreeAddressCode------------------------\n\n");
         printTAC();
+        if(opt_level > 0) printOptimizerStats(&opt_stats);
+
+        if(print_cfg_flag){
+            ProgramCFG* cfg = buildProgramCFG(codeList);
+            printf("\nControlFlowGraph------------------------\n\n");
+            printProgramCFG(cfg);
+            freeProgramCFG(cfg);
+        }
+
+        if(print_bytecode_flag){
+            BytecodeProgram* bytecode = lowerTACToBytecode(codeList);
+            printf("\nBytecode---------------------------------\n\n");
+            printBytecode(bytecode);
+            freeBytecode(bytecode);
+        }
+
+        // Native x86-64 assembly in ASM/program.s
+        if(emit_asm_flag){
+            exportX86Assembly(folderPathForASM, codeList);
+        }
+
+        // Execute the generated TAC
+        if(run_flag){
+            InterpreterStats stats;
+            beginPhaseStats("run");
+            InterpreterStatus run_stat = runTAC(codeList, &stats);
+            endPhaseStats(symTable);
+            printInterpreterGlobals();
+            printInterpreterStats(&stats);
+            if(run_stat != INTERP_SUCCESS) printf("\nEXECUTION FAILED\n");
+            freeInterpreter();
+        }
+
+        // Compile the TAC to machine code and run it in process
+        if(jit_flag){
+            JITStats jit_stats;
+            beginPhaseStats("jit");
+            JITStatus jit_stat = runJIT(codeList, &jit_stats);
+            endPhaseStats(symTable);
+            printJITStats(&jit_stats);
+            if(jit_stat != JIT_SUCCESS) printf("\nJIT EXECUTION FAILED\n");
+        }
     }
         
     
     printf("\n\n");
 
-
+    printPhaseStats();
 
     close_logger();
-    freeAST(root);
+    freeICG();
+    freeASTArena();
     freeSymbolTable(symTable);
+    freeInternTable();
 }
 
 
@@ -1189,22 +1334,31 @@ ASTNode* createProgramNode(ASTNode* stmt_list, SourceSpan span) {
     // Create a node for the root of the program
     ASTNode* programNode = createASTNode(NODE_PROGRAM, span);
 
-    programNode->program_data.stmt_list = stmt_list;
+    programNode->program_data.stmt_list = astRef(stmt_list);
     programNode->program_data.scope = symTable;
     
     return programNode;
 }
 
+// The list builders create the list for its first item and append to it
+// afterwards, returning the same node
+static ASTNode* appendListNode(NodeType type, ASTNode* list, ASTNode* item, SourceSpan span) {
+    if (list == NULL) {
+        list = createASTNode(type, span);
+    } else {
+        applySourceSpan(list, span);
+    }
+    appendASTListItem(list, item);
+    return list;
+}
+
 ASTNode* createStmtListNode(ASTNode* stmt_list, ASTNode* stmt, SourceSpan span) {
-    ASTNode* node = createASTNode(NODE_STMT_LIST, span);
-    node->stmt_list_data.stmt_list = stmt_list; // Pointer to the next statement or NULL
-    node->stmt_list_data.stmt = stmt;
-    return node;
+    return appendListNode(NODE_STMT_LIST, stmt_list, stmt, span);
 }
 
 ASTNode* createBlockStmtNode(ASTNode* stmt_list, SourceSpan span){
     ASTNode* node = createASTNode(NODE_BLOCK_STMT, span);
-    node->block_stmt_data.stmt_list = stmt_list;
+    node->block_stmt_data.stmt_list = astRef(stmt_list);
 
     return node;
 }
@@ -1213,14 +1367,14 @@ ASTNode* createBlockStmtNode(ASTNode* stmt_list, SourceSpan span){
 
 ASTNode* createReturnNode(ASTNode* return_value, SourceSpan span){
     ASTNode* node = createASTNode(NODE_RETURN, span);
-    node->return_data.return_value = return_value;
-    node->return_data.associated_node = NULL;
+    node->return_data.return_value = astRef(return_value);
+    node->return_data.associated_node = 0;
     return node;
 }
 
 ASTNode* createBreakNode(SourceSpan span){
     ASTNode* node = createASTNode(NODE_BREAK_STMT, span);
-    node->break_continue_stmt_data.associated_loop_node = NULL;
+    node->break_continue_stmt_data.associated_loop_node = 0;
 
     // Add to the list
     BrkCntStmtsList* list = (BrkCntStmtsList*)malloc(sizeof(BrkCntStmtsList));
@@ -1237,7 +1391,7 @@ ASTNode* createBreakNode(SourceSpan span){
 }
 ASTNode* createContinueNode(SourceSpan span){
     ASTNode* node = createASTNode(NODE_CONTINUE_STMT, span);
-    node->break_continue_stmt_data.associated_loop_node = NULL;
+    node->break_continue_stmt_data.associated_loop_node = 0;
 
     // Add to the list
     BrkCntStmtsList* list = (BrkCntStmtsList*)malloc(sizeof(BrkCntStmtsList));
@@ -1257,27 +1411,27 @@ ASTNode* createContinueNode(SourceSpan span){
 
 // EXPRESSIONS
 
-ASTNode* createBinaryExpNode(ASTNode* left, ASTNode* right, const char* op, SourceSpan span) {
+ASTNode* createBinaryExpNode(ASTNode* left, ASTNode* right, Operator op, SourceSpan span) {
     ASTNode* node = createASTNode(NODE_EXPR_BINARY, span);
-    node->expr_data.left = left;
-    node->expr_data.right = right;
-    node->expr_data.op = strdup(op);  // Store the operation
+    node->expr_data.left = astRef(left);
+    node->expr_data.right = astRef(right);
+    node->expr_data.op = op;  // Store the operation
     return node;
 }
 
-ASTNode* createUnaryExpNode(ASTNode* left, const char* op, SourceSpan span){
+ASTNode* createUnaryExpNode(ASTNode* left, Operator op, SourceSpan span){
     ASTNode* node = createASTNode(NODE_EXPR_UNARY, span);
-    node->expr_data.left = left;
-    node->expr_data.right = NULL;
-    node->expr_data.op = strdup(op);  // Store the operation
+    node->expr_data.left = astRef(left);
+    node->expr_data.right = 0;
+    node->expr_data.op = op;  // Store the operation
     return node;
 }
 
 ASTNode* createTermExpNode(ASTNode* term, SourceSpan span){
     ASTNode* node = createASTNode(NODE_EXPR_TERM, span);
-    node->expr_data.left = term;
-    node->expr_data.right = NULL;
-    node->expr_data.op = NULL;
+    node->expr_data.left = astRef(term);
+    node->expr_data.right = 0;
+    node->expr_data.op = OP_NONE;
 
     return node;
 }
@@ -1286,7 +1440,7 @@ ASTNode* createTermExpNode(ASTNode* term, SourceSpan span){
 
 // IDENTIFIERS
 
-ASTNode* createIdentifierNode(const char* id, char* type, SourceSpan span) {
+ASTNode* createIdentifierNode(const char* id, TypeId type, SourceSpan span) {
     ASTNode* node = createASTNode(NODE_ID, span);
 
     symbol* sym = createSymbol(id, type, currentScope, -1, 0, span.start_line, span.start_col);
@@ -1297,7 +1451,7 @@ ASTNode* createIdentifierNode(const char* id, char* type, SourceSpan span) {
 
 ASTNode* createFuncIdNode(const char* id, ASTNode* type_spec, SourceSpan span){
     ASTNode* node = createASTNode(NODE_ID, span);
-    char* type = (char*)type_spec->type_data.type;
+    TypeId type = type_spec->type_data.type;
 
     symbol* sym = createSymbol(id, type, currentScope, -1, 1, span.start_line, span.start_col);
     node->id_data.sym = sym;
@@ -1310,8 +1464,8 @@ ASTNode* createIdRefNode(const char* id, SourceSpan span){
     node->id_ref_data.name = id;
     node->id_ref_data.ref = NULL;
     node->id_ref_data.scope = currentScope;
-    node->id_ref_data.line_no = span.start_line;
-    node->id_ref_data.char_no = span.start_col;
+    node->id_ref_data.depth = -1;
+    node->id_ref_data.slot = -1;
     return node;
 }
 
@@ -1341,45 +1495,41 @@ ASTNode* createStrLiteralNode(const char* s, SourceSpan span){
 
 ASTNode* createDeclNode(ASTNode* type_spec, ASTNode* var_list, SourceSpan span){
     ASTNode* node = createASTNode(NODE_DECL, span);
-    node->decl_data.type_spec = type_spec;
-    node->decl_data.var_list = var_list;
+    node->decl_data.type_spec = astRef(type_spec);
+    node->decl_data.var_list = astRef(var_list);
 
     return node;
 }
 
-ASTNode* createTypeNode(char* type, SourceSpan span){
+ASTNode* createTypeNode(TypeId type, SourceSpan span){
     ASTNode* node = createASTNode(NODE_TYPE_SPEC, span);
     node->type_data.type = type;
     return node;
 }
 
 ASTNode* createVarListNode(ASTNode* var_list, ASTNode* var, SourceSpan span){
-    ASTNode* node = createASTNode(NODE_VAR_LIST, span);
-    node->var_list_data.var_list = var_list;
-    node->var_list_data.var = var;
-
-    return node;
+    return appendListNode(NODE_VAR_LIST, var_list, var, span);
 }
 
 ASTNode* createVarNode(const char* id, SourceSpan span, SourceSpan id_span) {
     ASTNode* node = createASTNode(NODE_VAR, span);
-    node->var_data.id = createIdentifierNode(id, NULL, id_span);  // Simple variable
-    node->var_data.value = NULL;
+    node->var_data.id = astRef(createIdentifierNode(id, TYPE_NONE, id_span));  // Simple variable
+    node->var_data.value = 0;
 
     return node;
 }
 
 ASTNode* createVarAssgnNode(const char* id, ASTNode* value, SourceSpan span, SourceSpan id_span){
    ASTNode* node = createASTNode(NODE_VAR, span);
-   node->var_data.id = createIdentifierNode(id, NULL, id_span);
-   node->var_data.value = value;
+   node->var_data.id = astRef(createIdentifierNode(id, TYPE_NONE, id_span));
+   node->var_data.value = astRef(value);
    return node;
 }
 
 ASTNode* createAssgnNode(const char* id, ASTNode* value, SourceSpan span, SourceSpan id_span){
     ASTNode* node = createASTNode(NODE_ASSGN, span);
-    node->assgn_data.left = createIdRefNode(id, id_span);
-    node->assgn_data.right = value;
+    node->assgn_data.left = astRef(createIdRefNode(id, id_span));
+    node->assgn_data.right = astRef(value);
 
     return node;
 }
@@ -1387,20 +1537,20 @@ ASTNode* createAssgnNode(const char* id, ASTNode* value, SourceSpan span, Source
 void setVarListType(ASTNode* typeNode, ASTNode* var_list) {
     if (var_list == NULL) return;
 
-    const char* type = typeNode->type_data.type;
+    TypeId type = typeNode->type_data.type;
 
     if (var_list->type == NODE_VAR_LIST) {
-        // If it's a var_list, recursively update both parts (var_list and individual var)
-        setVarListType(typeNode, var_list->var_list_data.var_list);
-        setVarListType(typeNode, var_list->var_list_data.var);
+        for (int i = 0; i < var_list->list_data.count; i++) {
+            setVarListType(typeNode, astNode(var_list->list_data.items[i]));
+        }
     } else if (var_list->type == NODE_VAR) {
         // For an individual variable, check if it's an assignment or just a declaration
-        if (var_list->var_data.id != NULL && var_list->var_data.id->id_data.sym != NULL) {
-            symbol* sym = var_list->var_data.id->id_data.sym;
-            if (sym->type == NULL) {
-                if (isParserDebuggerOn) printLog("Assigning type: %s to sym: %s in Var List", type, sym->name);
-                sym->type = strdup(type); // Assign the type to the variable's symbol
-                log_assgn_sym_type(sym->name, sym->scope->table_id, type);
+        if (var_list->var_data.id && astNode(var_list->var_data.id)->id_data.sym != NULL) {
+            symbol* sym = astNode(var_list->var_data.id)->id_data.sym;
+            if (sym->type == TYPE_NONE) {
+                if (isParserDebuggerOn) printLog("Assigning type: %s to sym: %s in Var List", getTypeName(type), sym->name);
+                sym->type = type; // Assign the type to the variable's symbol
+                log_assgn_sym_type(sym->name, sym->scope->table_id, getTypeName(type));
             }
         }
 
@@ -1417,14 +1567,14 @@ ASTNode* createIfNode(ASTNode* cond, ASTNode* if_branch, SourceSpan span) {
     // Implicit creation of cond & branch nodes
 
     ASTNode* node_cond = createASTNode(NODE_IF_COND, span);
-    node_cond->if_cond_data.cond = cond;
-    node->if_else_data.condition = node_cond;
+    node_cond->if_cond_data.cond = astRef(cond);
+    node->if_else_data.condition = astRef(node_cond);
 
     ASTNode* node_if_branch = createASTNode(NODE_IF_BRANCH, span);
-    node_if_branch->if_else_branch.branch = if_branch;
-    node->if_else_data.if_branch = node_if_branch;
+    node_if_branch->if_else_branch.branch = astRef(if_branch);
+    node->if_else_data.if_branch = astRef(node_if_branch);
 
-    node->if_else_data.else_branch = NULL;
+    node->if_else_data.else_branch = 0;
 
     return node;
 }
@@ -1435,16 +1585,16 @@ ASTNode* createIfElseNode(ASTNode* cond, ASTNode* if_branch, ASTNode* else_branc
     // Implicit creation of cond & branch nodes
 
     ASTNode* node_cond = createASTNode(NODE_IF_COND, span);
-    node_cond->if_cond_data.cond = cond;
-    node->if_else_data.condition = node_cond;
+    node_cond->if_cond_data.cond = astRef(cond);
+    node->if_else_data.condition = astRef(node_cond);
 
     ASTNode* node_if_branch = createASTNode(NODE_IF_BRANCH, span);
-    node_if_branch->if_else_branch.branch = if_branch;
-    node->if_else_data.if_branch = node_if_branch;
+    node_if_branch->if_else_branch.branch = astRef(if_branch);
+    node->if_else_data.if_branch = astRef(node_if_branch);
    
     ASTNode* node_else_branch = createASTNode(NODE_ELSE_BRANCH, span);
-    node_else_branch->if_else_branch.branch = else_branch;
-    node->if_else_data.else_branch = node_else_branch;
+    node_else_branch->if_else_branch.branch = astRef(else_branch);
+    node->if_else_data.else_branch = astRef(node_else_branch);
 
     return node;
 }
@@ -1454,13 +1604,13 @@ ASTNode* createWhileNode(ASTNode* cond, ASTNode* body, SourceSpan span){
 
     // Implict creation of cond and branch nodes
     ASTNode* node_while_cond = createASTNode(NODE_WHILE_COND, span);
-    node_while_cond->while_cond_data.cond = cond;
+    node_while_cond->while_cond_data.cond = astRef(cond);
 
     ASTNode* node_while_body = createASTNode(NODE_WHILE_BODY, span);
-    node_while_body->while_body_data.body = body;
+    node_while_body->while_body_data.body = astRef(body);
 
-    node->while_data.condition = node_while_cond;
-    node->while_data.while_body = node_while_body;
+    node->while_data.condition = astRef(node_while_cond);
+    node->while_data.while_body = astRef(node_while_body);
 
     return node;
 
@@ -1472,21 +1622,21 @@ ASTNode* createForNode(ASTNode* init, ASTNode* cond, ASTNode* updation, ASTNode*
 
     // Implicit creation of init, cond and updation nodes;
     ASTNode* node_for_init = createASTNode(NODE_FOR_INIT, span);
-    node_for_init->for_init_data.init = init;
+    node_for_init->for_init_data.init = astRef(init);
 
     ASTNode* node_for_cond = createASTNode(NODE_FOR_COND, span); 
-    node_for_cond->for_cond_data.cond = cond;
+    node_for_cond->for_cond_data.cond = astRef(cond);
 
     ASTNode* node_for_upd = createASTNode(NODE_FOR_UPDATION, span);
-    node_for_upd->for_updation_data.updation = updation;
+    node_for_upd->for_updation_data.updation = astRef(updation);
 
     ASTNode* node_for_body = createASTNode(NODE_FOR_BODY, span);
-    node_for_body->for_body_data.body = body;
+    node_for_body->for_body_data.body = astRef(body);
 
-    node->for_data.init = node_for_init;
-    node->for_data.condition = node_for_cond;
-    node->for_data.updation = node_for_upd;
-    node->for_data.body = node_for_body;
+    node->for_data.init = astRef(node_for_init);
+    node->for_data.condition = astRef(node_for_cond);
+    node->for_data.updation = astRef(node_for_upd);
+    node->for_data.body = astRef(node_for_body);
 
     return node;
 }
@@ -1495,21 +1645,14 @@ ASTNode* createForNode(ASTNode* init, ASTNode* cond, ASTNode* updation, ASTNode*
 ASTNode* createCommaExprList(ASTNode* expr_list, ASTNode* expr_list_item, SourceSpan span){
     ASTNode* node = createASTNode(NODE_EXPR_COMMA_LIST, span);
 
-    node->expr_comma_list_data.expr_comma_list = expr_list;
-    node->expr_comma_list_data.expr_comma_list_item = expr_list_item;
+    node->expr_comma_list_data.expr_comma_list = astRef(expr_list);
+    node->expr_comma_list_data.expr_comma_list_item = astRef(expr_list_item);
 
     return node;
 }
 
 int countParams(ASTNode* params) {
-    if (params == NULL) return 0;
-
-    // Check if the node is a parameter list node
-    if (params->type == NODE_PARAM_LIST) {
-        return countParams(params->param_list_data.param_list) + countParams(params->param_list_data.param);
-    }
-
-    return 1;
+    return params ? params->list_data.count : 0;
 }
 
 
@@ -1522,57 +1665,45 @@ ASTNode* createFuncDeclNode(ASTNode* type_spec, ASTNode* id, ASTNode* params, AS
     }
 
     node->func_decl_data.global_id = func_id++; 
-    node->func_decl_data.id = id;
+    node->func_decl_data.id = astRef(id);
     id->id_data.sym->func_node = node;
 
-    node->func_decl_data.params = params;
+    node->func_decl_data.params = astRef(params);
     node->func_decl_data.param_count = countParams(params);
     /* printf("Params count: %d\n", node->func_decl_data.param_count); */
 
     // Implicit creation of Function body node
     ASTNode* body_node = createASTNode(NODE_FUNC_BODY, span);
-    body_node->func_body_data.body = body;
+    body_node->func_body_data.body = astRef(body);
 
-    node->func_decl_data.body = body_node;
+    node->func_decl_data.body = astRef(body_node);
     node->func_decl_data.scope = currentScope;
 
     return node;
 }
 
 ASTNode* createParamsListNode(ASTNode* params_list, ASTNode* param, SourceSpan span){
-    ASTNode* node = createASTNode(NODE_PARAM_LIST, span);
-
-    node->param_list_data.param_list = params_list;
-    node->param_list_data.param = param;
-
-    return node;
+    return appendListNode(NODE_PARAM_LIST, params_list, param, span);
 }
 
 ASTNode* createParamNode(ASTNode* type_spec, const char* id, SourceSpan span, SourceSpan id_span){
     ASTNode* node = createASTNode(NODE_PARAM, span);
-    char* type = (char*)type_spec->type_data.type;
-    node->param_data.type_spec = type_spec;
-    node->param_data.id = createIdentifierNode(id, type, id_span);
+    TypeId type = type_spec->type_data.type;
+    node->param_data.type_spec = astRef(type_spec);
+    node->param_data.id = astRef(createIdentifierNode(id, type, id_span));
 
     return node;
 }
 
 int countArgs(ASTNode* arg_list) {
-    if (arg_list == NULL) return 0;
-
-    // Check if the node is a parameter list node
-    if (arg_list->type == NODE_ARG_LIST) {
-        return countArgs(arg_list->arg_list_data.arg_list) + countArgs(arg_list->arg_list_data.arg);
-    }
-
-    return 1;
+    return arg_list ? arg_list->list_data.count : 0;
 }
 
 ASTNode* createFuncCallNode(const char* id, ASTNode* arg_list, SourceSpan span, SourceSpan id_span){
     ASTNode* node = createASTNode(NODE_FUNC_CALL, span);
 
-    node->func_call_data.id = createIdRefNode(id, id_span);
-    node->func_call_data.arg_list = arg_list;
+    node->func_call_data.id = astRef(createIdRefNode(id, id_span));
+    node->func_call_data.arg_list = astRef(arg_list);
     node->func_call_data.arg_count = countArgs(arg_list);
 
     return node;
@@ -1580,17 +1711,14 @@ ASTNode* createFuncCallNode(const char* id, ASTNode* arg_list, SourceSpan span,
 }
 
 ASTNode* createArgListNode(ASTNode* arg_list, ASTNode* arg, SourceSpan span){
-    ASTNode* node = createASTNode(NODE_ARG_LIST, span);
-
-    node->arg_list_data.arg_list = arg_list;
-    node->arg_list_data.arg = createArgNode(arg, span);
-
-    return node;
+    ASTNode* list = appendListNode(NODE_ARG_LIST, arg_list, NULL, span);
+    appendASTListItem(list, createArgNode(arg, span));
+    return list;
 }
 
 ASTNode* createArgNode(ASTNode* arg, SourceSpan span){
     ASTNode* node = createASTNode(NODE_ARG, span);
-    node->arg_data.arg = arg;
+    node->arg_data.arg = astRef(arg);
 
     return node;
 }
@@ -6,12 +6,6 @@
 #include <assert.h>
 #include "logger.h"
 
-#define TYPE_VOID "void"
-#define TYPE_INT "int"
-#define TYPE_CHAR "char"
-#define TYPE_STRING "string"
-#define TYPE_UNKNOWN "unknown"
-
 bool isDebugOn = false;
 static const char* currentSemanticPass = NULL;
 static int semanticTotalErrors = 0;
@@ -20,34 +14,37 @@ void setSemanticDebugger(){
 } 
 
 
-OpType getOpType(const char* op) {
-
-    if(!op) return OP_UNKNOWN;
-
-    if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0 ||
-        strcmp(op, "*") == 0 || strcmp(op, "/") == 0){
-        return OP_ARITHMETIC;
-    } 
-    else if (strcmp(op, "==") == 0 || strcmp(op, "<=") == 0 ||
-             strcmp(op, ">=") == 0 || strcmp(op, "<") == 0 ||
-             strcmp(op, ">") == 0 || strcmp(op, "!=") == 0) {
-        return OP_COMP;
-    }
-    else if (strcmp(op, "&&") == 0 || strcmp(op, "||") == 0 || strcmp(op, "!") == 0) {
-        return OP_LOGICAL;
-    }
-    else if (strcmp(op, "PRE_INC") == 0 || strcmp(op, "PRE_DEC") == 0 ||
-             strcmp(op, "POST_INC") == 0 || strcmp(op, "POST_DEC") == 0) {
-        return OP_INC_DEC;
-    }
-    
-    return OP_UNKNOWN;  // For unsupported or unknown operators
+static const OpType opTypes[OPERATOR_COUNT] = {
+    [OP_NONE]     = OP_UNKNOWN,
+    [OP_ADD]      = OP_ARITHMETIC,
+    [OP_SUB]      = OP_ARITHMETIC,
+    [OP_MUL]      = OP_ARITHMETIC,
+    [OP_DIV]      = OP_ARITHMETIC,
+    [OP_EQ]       = OP_COMP,
+    [OP_NEQ]      = OP_COMP,
+    [OP_LT]       = OP_COMP,
+    [OP_GT]       = OP_COMP,
+    [OP_LEQ]      = OP_COMP,
+    [OP_GEQ]      = OP_COMP,
+    [OP_AND]      = OP_LOGICAL,
+    [OP_OR]       = OP_LOGICAL,
+    [OP_NOT]      = OP_LOGICAL,
+    [OP_PRE_INC]  = OP_INC_DEC,
+    [OP_PRE_DEC]  = OP_INC_DEC,
+    [OP_POST_INC] = OP_INC_DEC,
+    [OP_POST_DEC] = OP_INC_DEC,
+};
+
+OpType getOpType(Operator op) {
+    if (op <= OP_NONE || op >= OPERATOR_COUNT) return OP_UNKNOWN;  // For unsupported or unknown operators
+    return opTypes[op];
 }
 
 void printErrors();
 extern int errorCount;
 
 static void logSemanticPassStatus(const char* pass, const char* status, const char* message) {
+    if (!isTraceOn()) return;
     Step step;
     step.type = SEMANTIC_PASS_STATUS;
     step.SemanticPassStatus.pass = pass;
@@ -66,6 +63,7 @@ static void logSemanticSymbolHighlight(
     int char_no,
     int has_location
 ) {
+    if (!isTraceOn()) return;
     Step step;
     step.type = SEMANTIC_SYMBOL_HIGHLIGHT;
     step.SemanticSymbolHighlight.scope_id = scope_id;
@@ -80,15 +78,15 @@ static void logSemanticSymbolHighlight(
 }
 
 static void logSemanticNodeHighlight(ASTNode* node, const char* action, const char* message) {
-    if (!node || !currentSemanticPass) return;
+    if (!isTraceOn() || !node || !currentSemanticPass) return;
 
     Step step;
     step.type = SEMANTIC_NODE_HIGHLIGHT;
     step.SemanticNodeHighlight.pass = currentSemanticPass;
     step.SemanticNodeHighlight.node_id = node->node_id;
     step.SemanticNodeHighlight.node_type = getNodeName(node->type);
-    step.SemanticNodeHighlight.line_no = node->line_no;
-    step.SemanticNodeHighlight.char_no = node->char_no;
+    step.SemanticNodeHighlight.line_no = nodeSpan(node)->start_line;
+    step.SemanticNodeHighlight.char_no = nodeSpan(node)->start_col;
     step.SemanticNodeHighlight.action = action;
     step.SemanticNodeHighlight.message = message;
     log_step(step);
@@ -98,23 +96,35 @@ typedef struct {
     const char* pass;
 } SemanticTraversalLogContext;
 
+// State carried through the fused walks in place of per-loop and
+// per-function sub-traversals
+typedef struct {
+    SemanticTraversalLogContext log;
+    ASTNode* loop;            // Innermost enclosing loop
+    ASTNode* function;        // Innermost enclosing function declaration
+    ASTNode** returnChecks;   // Function declarations and returns, in visit order
+    int returnCheckCount;
+    int returnCheckCapacity;
+} SemanticWalkContext;
+
 static void semanticTraversalLogger(ASTNode* node, void* ctx) {
     SemanticTraversalLogContext* traversalCtx = (SemanticTraversalLogContext*)ctx;
-    if (!node || !traversalCtx || !traversalCtx->pass) return;
+    if (!isTraceOn() || !node || !traversalCtx || !traversalCtx->pass) return;
 
     Step step;
     step.type = SEMANTIC_NODE_HIGHLIGHT;
     step.SemanticNodeHighlight.pass = traversalCtx->pass;
     step.SemanticNodeHighlight.node_id = node->node_id;
     step.SemanticNodeHighlight.node_type = getNodeName(node->type);
-    step.SemanticNodeHighlight.line_no = node->line_no;
-    step.SemanticNodeHighlight.char_no = node->char_no;
+    step.SemanticNodeHighlight.line_no = nodeSpan(node)->start_line;
+    step.SemanticNodeHighlight.char_no = nodeSpan(node)->start_col;
     step.SemanticNodeHighlight.action = "VISIT";
     step.SemanticNodeHighlight.message = NULL;
     log_step(step);
 }
 
 static void logSemanticError(const char* message, int line_no, int char_no, ASTNode* node, const char* scope_id, const char* symbol_name) {
+    if (!isTraceOn()) return;
     Step step;
     char nodeIdBuf[32];
     step.type = SEMANTIC_ERROR_LOG;
@@ -178,7 +188,9 @@ static void addErrorWithContext(
 }
 
 
-const char* inferAndValidateType(ASTNode* node); 
+TypeId inferAndValidateType(ASTNode* node); 
+static void validateTypesAndReturns(ASTNode* root, SemanticWalkContext* ctx);
+static void validateFunctionReturnTypes(SemanticWalkContext* ctx);
 // const char* getNodeTypeName(ASTNode* node);
 
 // Main function
@@ -194,12 +206,12 @@ SemanticStatus performSemanticAnalysis(ASTNode* root, SymbolTable* globalTable,
     if (isDebugOn) printf("------Checking for duplicates COMPLETED!\n\n");
     logSemanticPassStatus(currentSemanticPass, "COMPLETE", "DUPLICATE SYMBOL VALIDATION COMPLETE");
 
-    currentSemanticPass = "validateSymbolUsage";
-    logSemanticPassStatus(currentSemanticPass, "START", "VALIDATING SYMBOL USAGE");
-    if (isDebugOn) printf("------Validating Symbol Usage....\n");
-    validateSymbolUsage(root);
-    if (isDebugOn) printf("------Validating Symbol Usage COMPLETED!\n\n");
-    logSemanticPassStatus(currentSemanticPass, "COMPLETE", "SYMBOL USAGE VALIDATION COMPLETE");
+    currentSemanticPass = "bindSymbolsAndLoops";
+    logSemanticPassStatus(currentSemanticPass, "START", "BINDING SYMBOLS AND LOOPS");
+    if (isDebugOn) printf("------Binding Symbols and Loops....\n");
+    bindSymbolsAndLoops(root);
+    if (isDebugOn) printf("------Binding Symbols and Loops COMPLETED!\n\n");
+    logSemanticPassStatus(currentSemanticPass, "COMPLETE", "SYMBOL AND LOOP BINDING COMPLETE");
 
     if(errorCount > 0){
         printErrors();
@@ -211,7 +223,7 @@ SemanticStatus performSemanticAnalysis(ASTNode* root, SymbolTable* globalTable,
     currentSemanticPass = "validateLoops";
     logSemanticPassStatus(currentSemanticPass, "START", "VALIDATING LOOPS");
     if (isDebugOn) printf("------Validating Loops....\n");
-    validateLoops(root, list);
+    validateLoops(list);
     if (isDebugOn) printf("------Validating Loops COMPLETED!....\n\n");
     logSemanticPassStatus(currentSemanticPass, "COMPLETE", "LOOP VALIDATION COMPLETE");
 
@@ -222,25 +234,24 @@ SemanticStatus performSemanticAnalysis(ASTNode* root, SymbolTable* globalTable,
         return SEMANTIC_ERROR;
     }
 
-    currentSemanticPass = "validateTypes";
+    SemanticWalkContext ctx = {0};
+    currentSemanticPass = "validateTypesAndReturns";
     logSemanticPassStatus(currentSemanticPass, "START", "VALIDATING TYPES");
     if (isDebugOn) printf("------Validating Types....\n");
-    validateTypes(root);
+    validateTypesAndReturns(root, &ctx);
     if (isDebugOn) printf("------Validating Types COMPLETED!....\n\n");
     logSemanticPassStatus(currentSemanticPass, "COMPLETE", "TYPE VALIDATION COMPLETE");
 
-    if(errorCount > 0){
-        printErrors();
-        errorCount = 0;
-        currentSemanticPass = NULL;
-        return SEMANTIC_ERROR;
+    if(errorCount == 0){
+        currentSemanticPass = "validateFunctionReturnTypes";
+        logSemanticPassStatus(currentSemanticPass, "START", "VALIDATING FUNCTION RETURN TYPES");
+        if (isDebugOn) printf("------Validating Function Return Types....\n");
+        validateFunctionReturnTypes(&ctx);
+        if (isDebugOn) printf("------Validating Function Return Types COMPLETED!!\n\n");
+        logSemanticPassStatus(currentSemanticPass, "COMPLETE", "FUNCTION RETURN TYPE VALIDATION COMPLETE");
     }
-    currentSemanticPass = "validateFunctionReturnTypes";
-    logSemanticPassStatus(currentSemanticPass, "START", "VALIDATING FUNCTION RETURN TYPES");
-    if (isDebugOn) printf("------Validating Function Return Types....\n");
-    validateFunctionReturnTypes(root);
-    if (isDebugOn) printf("------Validating Function Return Types COMPLETED!!\n\n");
-    logSemanticPassStatus(currentSemanticPass, "COMPLETE", "FUNCTION RETURN TYPE VALIDATION COMPLETE");
+    free(ctx.returnChecks);
+
     if(errorCount > 0){
         printErrors();
         errorCount = 0;
@@ -281,40 +292,38 @@ void printErrors() {
 void checkDuplicates(SymbolTable* table) {
     if (!table) return;
 
-    for (int i = 0; i < table->size; ++i) {
-        if(table->symbols[i]->is_duplicate) continue;
+    // The scope index holds the first declaration of every name, any other symbol with that name is a duplicate
+    for (int j = 0; j < table->size; ++j) {
+        symbol* sym = table->symbols[j];
+        symbol* first = lookupSymbolInScope(table, sym->name);
+        if (!first || first == sym) continue;
 
-        for (int j = i+1; j < table->size; ++j) {
-            
-            if (strcmp(table->symbols[i]->name, table->symbols[j]->name) == 0) {
-                table->symbols[j]->is_duplicate = 1;
-                char errorMsg[256];
-                char scopeIdBuf[32];
-                snprintf(errorMsg, sizeof(errorMsg), "Duplicate declaration of '%s' (previously declared at line %d, char %d)",
-                    table->symbols[j]->name,
-                    table->symbols[i]->line_no,
-                    table->symbols[i]->char_no);
-                snprintf(scopeIdBuf, sizeof(scopeIdBuf), "%d", table->table_id);
-                logSemanticSymbolHighlight(
-                    table->table_id,
-                    table->symbols[j]->name,
-                    "DUPLICATE",
-                    NULL,
-                    NULL,
-                    table->symbols[j]->line_no,
-                    table->symbols[j]->char_no,
-                    1
-                );
-                addErrorWithContext(
-                    errorMsg,
-                    table->symbols[j]->line_no,
-                    table->symbols[j]->char_no,
-                    NULL,
-                    scopeIdBuf,
-                    table->symbols[j]->name
-                );
-            }
-        }
+        sym->is_duplicate = 1;
+        char errorMsg[256];
+        char scopeIdBuf[32];
+        snprintf(errorMsg, sizeof(errorMsg), "Duplicate declaration of '%s' (previously declared at line %d, char %d)",
+            sym->name,
+            first->line_no,
+            first->char_no);
+        snprintf(scopeIdBuf, sizeof(scopeIdBuf), "%d", table->table_id);
+        logSemanticSymbolHighlight(
+            table->table_id,
+            sym->name,
+            "DUPLICATE",
+            NULL,
+            NULL,
+            sym->line_no,
+            sym->char_no,
+            1
+        );
+        addErrorWithContext(
+            errorMsg,
+            sym->line_no,
+            sym->char_no,
+            NULL,
+            scopeIdBuf,
+            sym->name
+        );
     }
 
     // Check child scopes recursively
@@ -333,13 +342,14 @@ int validateSymbolUsageCallback(ASTNode* root, void* cxt){
         if(isDebugOn) printf("Validating symbol %s\n", varName);
         // Look up the symbol in the current or any parent scope
         SymbolTable* currentScope = root->id_ref_data.scope;
-        symbol* foundSymbol = lookupSymbol(currentScope, varName);
+        int depth;
+        symbol* foundSymbol = resolveSymbol(currentScope, varName, &depth);
 
         // If the symbol is not found, it's an undeclared variable
         if (!foundSymbol) {
             char errorMsg[256];
             snprintf(errorMsg, sizeof(errorMsg), "Undeclared variable '%s'", varName);
-            addErrorWithContext(errorMsg, root->line_no, root->char_no, root, NULL, varName);  // Adding error with line and char info
+            addErrorWithContext(errorMsg, nodeSpan(root)->start_line, nodeSpan(root)->start_col, root, NULL, varName);  // Adding error with line and char info
             root->id_ref_data.ref = NULL; 
             assert(root->id_ref_data.ref == NULL);
             return 0;
@@ -348,181 +358,68 @@ int validateSymbolUsageCallback(ASTNode* root, void* cxt){
             if(isDebugOn) printf("Found ref for %s in scope %s\n", varName, foundSymbol->scope->scopeName);
             assert(foundSymbol != NULL);
             root->id_ref_data.ref = foundSymbol;
+            root->id_ref_data.depth = depth;
+            root->id_ref_data.slot = foundSymbol->location;
         }
     }
     return 1;
 }
 
-void validateSymbolUsage(ASTNode* root){
-    SemanticTraversalLogContext traversalCtx = { .pass = currentSemanticPass };
-    traverseAST(root, validateSymbolUsageCallback, NULL, semanticTraversalLogger, &traversalCtx);
-    // Traverse the children
-    // Traverse each type of node according to the specific structure
-    // switch (root->type) {
-    //     case NODE_PROGRAM:
-    //         validateSymbolUsage(root->program_data.stmt_list);
-    //         break;
-
-    //     case NODE_RETURN:
-    //         validateSymbolUsage(root->return_data.return_value);
-    //         break;
-
-    //     case NODE_STMT_LIST:
-    //         validateSymbolUsage(root->stmt_list_data.stmt_list);
-    //         validateSymbolUsage(root->stmt_list_data.stmt);
-    //         break;
-
-    //     case NODE_STMT:
-    //         validateSymbolUsage(root->stmt_data.stmt);
-    //         break;
-
-    //     case NODE_BLOCK_STMT:
-    //         validateSymbolUsage(root->block_stmt_data.stmt_list);
-    //         break;
-
-    //     case NODE_DECL:
-    //         // validateSymbolUsage(root->decl_data.type_spec);
-    //         validateSymbolUsage(root->decl_data.var_list);
-    //         break;
-
-    //     case NODE_VAR_LIST:
-    //         validateSymbolUsage(root->var_list_data.var_list);
-    //         validateSymbolUsage(root->var_list_data.var);
-    //         break;
-
-    //     case NODE_VAR:
-    //         validateSymbolUsage(root->var_data.id);
-    //         validateSymbolUsage(root->var_data.value);
-    //         break;
-
-    //     case NODE_ASSGN:
-    //         validateSymbolUsage(root->assgn_data.left);
-    //         validateSymbolUsage(root->assgn_data.right);
-    //         break;
-
-    //     case NODE_EXPR_BINARY:
-    //         validateSymbolUsage(root->expr_data.left);
-    //         validateSymbolUsage(root->expr_data.right);
-    //         break;
-
-    //     case NODE_EXPR_UNARY:
-    //     case NODE_EXPR_TERM:
-    //         validateSymbolUsage(root->expr_data.left);
-    //         break;
-
-    //     case NODE_IF:
-    //         validateSymbolUsage(root->if_else_data.condition);
-    //         validateSymbolUsage(root->if_else_data.if_branch);
-    //         break;
-
-    //     case NODE_IF_ELSE:
-    //         validateSymbolUsage(root->if_else_data.condition);
-    //         validateSymbolUsage(root->if_else_data.if_branch);
-    //         validateSymbolUsage(root->if_else_data.else_branch);
-    //         break;
-
-    //     case NODE_IF_COND:
-    //         validateSymbolUsage(root->if_cond_data.cond);
-    //         break;
-        
-    //     case NODE_IF_BRANCH:
-    //     case NODE_ELSE_BRANCH:
-    //         validateSymbolUsage(root->if_else_branch.branch);
-    //         break;
-        
+// Visits the children of a node the callback stopped traverseAST at, so the
+// callback can restore its context once the subtree is done
+static void traverseChildren(ASTNode* node, ASTTraversalCallback callback, SemanticWalkContext* ctx) {
+    switch (node->type) {
+        case NODE_WHILE:
+            traverseAST(astNode(node->while_data.condition), callback, ctx, semanticTraversalLogger, &ctx->log);
+            traverseAST(astNode(node->while_data.while_body), callback, ctx, semanticTraversalLogger, &ctx->log);
+            break;
 
-    //     case NODE_WHILE:
-    //         validateSymbolUsage(root->while_data.condition);
-    //         validateSymbolUsage(root->while_data.while_body);
-    //         break;
-
-    //     case NODE_WHILE_COND:   
-    //         validateSymbolUsage(root->while_cond_data.cond);
-    //         break;
-
-    //     case NODE_WHILE_BODY:   
-    //         validateSymbolUsage(root->while_body_data.body);
-    //         break;
-
-    //     case NODE_FOR:
-    //         validateSymbolUsage(root->for_data.init);
-    //         validateSymbolUsage(root->for_data.condition);
-    //         validateSymbolUsage(root->for_data.updation);
-    //         validateSymbolUsage(root->for_data.body);
-    //         break;
-
-    //     case NODE_FOR_INIT:
-    //         validateSymbolUsage(root->for_init_data.init);
-    //         break;
-
-    //     case NODE_FOR_COND: 
-    //         validateSymbolUsage(root->for_cond_data.cond); 
-    //         break;
-
-    //     case NODE_FOR_UPDATION: 
-    //         validateSymbolUsage(root->for_updation_data.updation); 
-    //         break;
-
-    //     case NODE_FOR_BODY: 
-    //         validateSymbolUsage(root->for_body_data.body); 
-    //         break; 
-
-    //     case NODE_EXPR_COMMA_LIST:
-    //         validateSymbolUsage(root->expr_comma_list_data.expr_comma_list);
-    //         validateSymbolUsage(root->expr_comma_list_data.expr_comma_list_item);
-    //         break;
-        
+        case NODE_FOR:
+            traverseAST(astNode(node->for_data.init), callback, ctx, semanticTraversalLogger, &ctx->log);
+            traverseAST(astNode(node->for_data.condition), callback, ctx, semanticTraversalLogger, &ctx->log);
+            traverseAST(astNode(node->for_data.updation), callback, ctx, semanticTraversalLogger, &ctx->log);
+            traverseAST(astNode(node->for_data.body), callback, ctx, semanticTraversalLogger, &ctx->log);
+            break;
 
-    //     case NODE_FUNC_DECL:
-    //         validateSymbolUsage(root->func_decl_data.params);
-    //         validateSymbolUsage(root->func_decl_data.body);
-    //         break;
-        
-    //     case NODE_FUNC_BODY:
-    //         validateSymbolUsage(root->func_body_data.body);
-    //         break;
-
-    //     case NODE_FUNC_CALL:
-    //         validateSymbolUsage(root->func_call_data.id);
-    //         validateSymbolUsage(root->func_call_data.arg_list);
-    //         break;
-
-    //     // case NODE_PARAM_LIST:
-    //     //     validateSymbolUsage(root->param_list_data.param);
-    //     //     validateSymbolUsage(root->param_list_data.param_list);
-    //     //     break;
-
-    //     case NODE_ARG_LIST:
-    //         validateSymbolUsage(root->arg_list_data.arg_list);
-    //         validateSymbolUsage(root->arg_list_data.arg);
-    //         break;
-
-    //     case NODE_ARG:
-    //         validateSymbolUsage(root->arg_data.arg);
-    //         break;
-
-    //     default:
-    //         break;
-    // }
+        case NODE_FUNC_DECL:
+            traverseAST(astNode(node->func_decl_data.id), callback, ctx, semanticTraversalLogger, &ctx->log);
+            traverseAST(astNode(node->func_decl_data.params), callback, ctx, semanticTraversalLogger, &ctx->log);
+            traverseAST(astNode(node->func_decl_data.body), callback, ctx, semanticTraversalLogger, &ctx->log);
+            break;
+
+        default:
+            break;
+    }
 }
 
-const char* promoteType(const char* leftType, const char* rightType) {
-    if (!leftType || !rightType) return NULL;
+// Binds identifier references and ties break/continue to their innermost loop
+static int bindSymbolsAndLoopsCallback(ASTNode* node, void* context) {
+    SemanticWalkContext* ctx = (SemanticWalkContext*)context;
 
-    // Both types match exactly, no promotion needed
-    if (strcmp(leftType, rightType) == 0) return leftType;
+    switch (node->type) {
+        case NODE_WHILE:
+        case NODE_FOR: {
+            ASTNode* outerLoop = ctx->loop;
+            ctx->loop = node;
+            traverseChildren(node, bindSymbolsAndLoopsCallback, ctx);
+            ctx->loop = outerLoop;
+            return 0;
+        }
 
-    // Promote char to int when paired with int
-    if ((strcmp(leftType, TYPE_INT) == 0 && strcmp(rightType, TYPE_CHAR) == 0) ||
-        (strcmp(leftType, TYPE_CHAR) == 0 && strcmp(rightType, TYPE_INT) == 0)) {
-        return TYPE_INT;
-    }
-    
+        case NODE_BREAK_STMT:
+        case NODE_CONTINUE_STMT:
+            node->break_continue_stmt_data.associated_loop_node = astRef(ctx->loop);
+            return 0;
 
-    // No valid promotion path
-    return NULL;
+        default:
+            return validateSymbolUsageCallback(node, NULL);
+    }
 }
 
+void bindSymbolsAndLoops(ASTNode* root){
+    SemanticWalkContext ctx = { .log = { .pass = currentSemanticPass } };
+    traverseAST(root, bindSymbolsAndLoopsCallback, &ctx, semanticTraversalLogger, &ctx.log);
+}
 
 void validateFunctionCallArgs(ASTNode* func_call_node) {
     // Get function call identifier and its symbol
@@ -531,14 +428,14 @@ void validateFunctionCallArgs(ASTNode* func_call_node) {
         return;
     }
 
-    if(isDebugOn) printf("Validating func call args for '%s()'\n", func_call_node->func_call_data.id->id_ref_data.name);
+    if(isDebugOn) printf("Validating func call args for '%s()'\n", astNode(func_call_node->func_call_data.id)->id_ref_data.name);
 
-    symbol* func_symbol = func_call_node->func_call_data.id->id_ref_data.ref;
+    symbol* func_symbol = astNode(func_call_node->func_call_data.id)->id_ref_data.ref;
     if(isDebugOn){
          if(!func_symbol) printf("Func sym not found!\n");
     }
     if (!func_symbol || !func_symbol->is_function) {
-        addErrorWithContext("Called identifier is not a function", func_call_node->line_no, func_call_node->char_no, func_call_node, NULL, NULL);
+        addErrorWithContext("Called identifier is not a function", nodeSpan(func_call_node)->start_line, nodeSpan(func_call_node)->start_col, func_call_node, NULL, NULL);
         return;
     }
 
@@ -552,28 +449,28 @@ void validateFunctionCallArgs(ASTNode* func_call_node) {
         snprintf(errorMsg, sizeof(errorMsg),
                  "Argument count mismatch for function '%s': expected %d, got %d",
                  func_symbol->name, expected_count, func_call_node->func_call_data.arg_count);
-        addErrorWithContext(errorMsg, func_call_node->line_no, func_call_node->char_no, func_call_node, NULL, func_symbol->name);
+        addErrorWithContext(errorMsg, nodeSpan(func_call_node)->start_line, nodeSpan(func_call_node)->start_col, func_call_node, NULL, func_symbol->name);
         return;
     }
 
-    // Initialize pointers to traverse arguments and parameters
-    ASTNode* arg_node = func_call_node->func_call_data.arg_list;
-    ASTNode* param_node = func_decl_node->func_decl_data.params;
-    int arg_index = expected_count-1;
-
+    if (expected_count == 0) return;
+    ASTRef* args = astNode(func_call_node->func_call_data.arg_list)->list_data.items;
+    ASTRef* params = astNode(func_decl_node->func_decl_data.params)->list_data.items;
 
-    while (arg_node && param_node) {
+    // Last argument first, the order errors have always been reported in
+    for (int arg_index = expected_count - 1; arg_index >= 0; arg_index--) {
+        ASTNode* arg_node = astNode(args[arg_index]);
 
-        if (arg_node->arg_list_data.arg == NULL || arg_node->arg_list_data.arg->arg_data.arg == NULL) {
-            addErrorWithContext("Invalid argument node structure", arg_node->line_no, arg_node->char_no, arg_node, NULL, NULL);
+        if (!arg_node->arg_data.arg) {
+            addErrorWithContext("Invalid argument node structure", nodeSpan(arg_node)->start_line, nodeSpan(arg_node)->start_col, arg_node, NULL, NULL);
             return;
         }
 
         // Get expected parameter type
-        const char* expected_type = param_node->param_list_data.param->param_data.type_spec->type_data.type;
+        TypeId expected_type = astNode(astNode(params[arg_index])->param_data.type_spec)->type_data.type;
 
         // Infer argument type
-        const char* arg_type = inferAndValidateType(arg_node->arg_list_data.arg->arg_data.arg);
+        TypeId arg_type = inferAndValidateType(astNode(arg_node->arg_data.arg));
 
         if(isDebugOn){
             if(!arg_type) printf("Type of Arg %d is NULL\n", arg_index);
@@ -582,62 +479,55 @@ void validateFunctionCallArgs(ASTNode* func_call_node) {
 
         if(expected_type && arg_type){
             // Type mismatch check
-            if (strcmp(arg_type, expected_type) != 0) {
+            if (arg_type != expected_type) {
                 char errorMsg[256];
                 snprintf(errorMsg, sizeof(errorMsg),
                         "Type mismatch in argument %d for function '%s': expected (%s), got (%s)",
-                        arg_index + 1, func_symbol->name, expected_type, arg_type);
-                addErrorWithContext(errorMsg, arg_node->arg_list_data.arg->line_no, arg_node->arg_list_data.arg->char_no, arg_node->arg_list_data.arg, NULL, func_symbol->name);
+                        arg_index + 1, func_symbol->name, getTypeName(expected_type), getTypeName(arg_type));
+                addErrorWithContext(errorMsg, nodeSpan(arg_node)->start_line, nodeSpan(arg_node)->start_col, arg_node, NULL, func_symbol->name);
             }
         }
-
-     
-
-        // Move to the next argument and parameter
-        arg_node = arg_node->arg_list_data.arg_list;
-        param_node = param_node->param_list_data.param_list;
-        arg_index--;
     }
 
     return;  // Arguments validated successfully
 }
 
 
-const char* inferAndValidateType(ASTNode* node) {
+TypeId inferAndValidateType(ASTNode* node) {
 
-    const char* type = NULL;
+    TypeId type = TYPE_NONE;
 
-    if (!node) return NULL;
+    if (!node) return TYPE_NONE;
     
     switch (node->type) {
         case NODE_ID:
-            if(isDebugOn) printf("Getting type of ID (%s), found type: %s\n", node->id_data.sym->name, node->id_data.sym->type);
+            if(isDebugOn) printf("Getting type of ID (%s), found type: %s\n", node->id_data.sym->name, getTypeName(node->id_data.sym->type));
 
             type = node->id_data.sym->type;
             if(!type){
                 char errorMsg[256]; 
                 snprintf(errorMsg, sizeof(errorMsg),"Type of '%s' is NULL", node->id_data.sym->name);
-                addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, node->id_data.sym->name);
+                addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, node->id_data.sym->name);
             } 
             node->inferedType = type;
             break;
 
         case NODE_ID_REF:
-            if(isDebugOn) printf("Getting type of ID ref (%s), found type: %s\n", node->id_ref_data.name, node->id_ref_data.ref->type);
+            if(isDebugOn) printf("Getting type of ID ref (%s), found type: %s\n", node->id_ref_data.name, getTypeName(node->id_ref_data.ref->type));
 
             if (node->id_ref_data.ref != NULL){
                 if(isDebugOn) printf("ref type is not NULL\n");
-                type = node->id_ref_data.ref->type ? node->id_ref_data.ref->type : NULL;
+                type = node->id_ref_data.ref->type;
             }else{
                 if(isDebugOn) printf("ref type is NULL\n");
-                type = NULL;
+                type = TYPE_NONE;
             }
 
             if(!type){
                 char errorMsg[256]; 
                 snprintf(errorMsg, sizeof(errorMsg),"Type of '%s' is NULL", node->id_ref_data.name);
-                addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, node->id_ref_data.name);
-                return NULL;
+                addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, node->id_ref_data.name);
+                return TYPE_NONE;
             } 
             node->inferedType = type;            
             break;
@@ -662,13 +552,13 @@ const char* inferAndValidateType(ASTNode* node) {
 
         case NODE_EXPR_TERM:
             if(isDebugOn) printf("Getting type of expr term\n");
-            type = inferAndValidateType(node->expr_data.left);
+            type = inferAndValidateType(astNode(node->expr_data.left));
             node->inferedType = type;
             break;
 
         case NODE_FUNC_CALL:
             if(isDebugOn) printf("Getting type of func call\n");
-            type = inferAndValidateType(node->func_call_data.id);
+            type = inferAndValidateType(astNode(node->func_call_data.id));
             node->inferedType = type;
 
             // validate the args
@@ -677,7 +567,7 @@ const char* inferAndValidateType(ASTNode* node) {
 
         case NODE_RETURN:
             if(isDebugOn) printf("Getting type of return stmt\n");
-            type = inferAndValidateType(node->return_data.return_value);
+            type = inferAndValidateType(astNode(node->return_data.return_value));
             node->inferedType = type ? type : TYPE_VOID;
             type = TYPE_VOID;
             break;
@@ -687,18 +577,18 @@ const char* inferAndValidateType(ASTNode* node) {
                 if(isDebugOn) printf("Getting type of var node\n");
                 if(!node->var_data.value) break;
 
-                const char* leftType = inferAndValidateType(node->var_data.id);
-                const char* rightType = inferAndValidateType(node->var_data.value);
+                TypeId leftType = inferAndValidateType(astNode(node->var_data.id));
+                TypeId rightType = inferAndValidateType(astNode(node->var_data.value));
 
-                if (leftType == NULL || rightType == NULL) break; 
+                if (leftType == TYPE_NONE || rightType == TYPE_NONE) break; 
                
                 type = promoteType(leftType, rightType);
 
                 // Just to check if it is not compatible at all
                 if (!type) {
                     char errorMsg[256]; 
-                    snprintf(errorMsg, sizeof(errorMsg), "Type mismatch in assignment: cannot assign (%s) to (%s)", rightType, leftType);
-                    addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, NULL);
+                    snprintf(errorMsg, sizeof(errorMsg), "Type mismatch in assignment: cannot assign (%s) to (%s)", getTypeName(rightType), getTypeName(leftType));
+                    addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, NULL);
                 }
 
                 node->inferedType = leftType; // required type
@@ -708,18 +598,18 @@ const char* inferAndValidateType(ASTNode* node) {
         case NODE_ASSGN:
             {   
                 if(isDebugOn) printf("Getting type of assgn node\n");
-                const char* leftType = inferAndValidateType(node->assgn_data.left);
-                const char* rightType = inferAndValidateType(node->assgn_data.right);
+                TypeId leftType = inferAndValidateType(astNode(node->assgn_data.left));
+                TypeId rightType = inferAndValidateType(astNode(node->assgn_data.right));
 
                 
-                if (leftType == NULL || rightType == NULL) break;  
+                if (leftType == TYPE_NONE || rightType == TYPE_NONE) break;  
 
                 // Apply promotion
                 type = promoteType(leftType, rightType);  
                 if(!type){
                     char errorMsg[256]; 
-                    snprintf(errorMsg, sizeof(errorMsg), "Type mismatch in assignment: cannot assign (%s) to (%s)", rightType, leftType);
-                    addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, NULL);
+                    snprintf(errorMsg, sizeof(errorMsg), "Type mismatch in assignment: cannot assign (%s) to (%s)", getTypeName(rightType), getTypeName(leftType));
+                    addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, NULL);
                     break;
                 }
 
@@ -728,26 +618,26 @@ const char* inferAndValidateType(ASTNode* node) {
             }
         
         case NODE_EXPR_BINARY: {
-            if(isDebugOn) printf("Getting type of bin expr op(%s)\n", node->expr_data.op);
-            const char* leftType = inferAndValidateType(node->expr_data.left);
-            const char* rightType = inferAndValidateType(node->expr_data.right);
-            const char* op = node->expr_data.op;
+            if(isDebugOn) printf("Getting type of bin expr op(%s)\n", getOperatorName(node->expr_data.op));
+            TypeId leftType = inferAndValidateType(astNode(node->expr_data.left));
+            TypeId rightType = inferAndValidateType(astNode(node->expr_data.right));
+            Operator op = node->expr_data.op;
 
-            if (leftType == NULL || rightType == NULL || op == NULL) break; 
+            if (leftType == TYPE_NONE || rightType == TYPE_NONE || op == OP_NONE) break; 
             
             // Apply promotion
             type = promoteType(leftType, rightType);
 
             switch (getOpType(op)){
                 case OP_COMP:
-                    if (strcmp(op, "==") == 0 || strcmp(op, "!=") == 0){
+                    if (op == OP_EQ || op == OP_NEQ){
                         // if one of the types is str and other is not
                         if (!type) {
                             char errorMsg[256];
                             snprintf(errorMsg, sizeof(errorMsg), 
-                                    "Type mismatch: cannot apply operator (%s) to (%s) and (%s)", node->expr_data.op,
-                                    leftType, rightType);
-                            addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, NULL);
+                                    "Type mismatch: cannot apply operator (%s) to (%s) and (%s)", getOperatorName(op),
+                                    getTypeName(leftType), getTypeName(rightType));
+                            addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, NULL);
                         }else{
                             type = TYPE_INT;
                             node->inferedType = type;
@@ -755,13 +645,13 @@ const char* inferAndValidateType(ASTNode* node) {
                         
                     }
                     // Cannot apply any other comp op for strs.
-                    else if(!type || strcmp(type, TYPE_STRING) == 0){
+                    else if(!type || type == TYPE_STRING){
                         char errorMsg[256];
                         snprintf(errorMsg, sizeof(errorMsg), 
-                                "Type mismatch: cannot apply operator (%s) to (%s) and (%s)", node->expr_data.op,
-                                leftType, rightType);
-                        addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, NULL); 
-                        type = NULL;
+                                "Type mismatch: cannot apply operator (%s) to (%s) and (%s)", getOperatorName(op),
+                                getTypeName(leftType), getTypeName(rightType));
+                        addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, NULL); 
+                        type = TYPE_NONE;
                     }
                     else{
                             type = TYPE_INT;
@@ -770,12 +660,12 @@ const char* inferAndValidateType(ASTNode* node) {
                     break;
 
                 case OP_ARITHMETIC:
-                    if (!type || strcmp(type, TYPE_STRING) == 0) {
+                    if (!type || type == TYPE_STRING) {
                         char errorMsg[256];
                         snprintf(errorMsg, sizeof(errorMsg), 
-                                "Type mismatch: cannot apply operator (%s) to (%s) and (%s)", node->expr_data.op,
-                                leftType, rightType);
-                        addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, NULL);
+                                "Type mismatch: cannot apply operator (%s) to (%s) and (%s)", getOperatorName(op),
+                                getTypeName(leftType), getTypeName(rightType));
+                        addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, NULL);
                     }
                     node->inferedType = type; 
                     break;
@@ -794,21 +684,21 @@ const char* inferAndValidateType(ASTNode* node) {
         }
 
         case NODE_EXPR_UNARY: {
-            if(isDebugOn) printf("Getting type of unary expr op(%s)\n", node->expr_data.op);
-            type = inferAndValidateType(node->expr_data.left);
-            const char* op = node->expr_data.op;
+            if(isDebugOn) printf("Getting type of unary expr op(%s)\n", getOperatorName(node->expr_data.op));
+            type = inferAndValidateType(astNode(node->expr_data.left));
+            Operator op = node->expr_data.op;
 
-            if(!type || !op) break;
+            if(type == TYPE_NONE || op == OP_NONE) break;
 
             // Cannot apply ++, -- to any other node other than ID_REF of non-str type
             switch(getOpType(op)){
                 case OP_INC_DEC:
                 {   
-                    NodeType nType = node->expr_data.left->expr_data.left->type; // UnaryExpr --> TermExpr
-                    if( nType != NODE_ID_REF || strcmp(type, TYPE_STRING) == 0){
+                    NodeType nType = astNode(astNode(node->expr_data.left)->expr_data.left)->type; // UnaryExpr --> TermExpr
+                    if( nType != NODE_ID_REF || type == TYPE_STRING){
                         char errorMsg[256];
-                        snprintf(errorMsg, sizeof(errorMsg), "Type mismatch: cannot apply operator (%s) to (%s)", node->expr_data.op, type);
-                        addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, NULL);
+                        snprintf(errorMsg, sizeof(errorMsg), "Type mismatch: cannot apply operator (%s) to (%s)", getOperatorName(op), getTypeName(type));
+                        addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, NULL);
                     }else{
                         type = TYPE_INT;
                         node->inferedType = TYPE_INT;
@@ -818,10 +708,10 @@ const char* inferAndValidateType(ASTNode* node) {
 
                 case OP_ARITHMETIC:
                 {   
-                    if(strcmp(op, "-") == 0 && strcmp(type, TYPE_STRING) == 0){
+                    if(op == OP_SUB && type == TYPE_STRING){
                         char errorMsg[256];
-                        snprintf(errorMsg, sizeof(errorMsg), "Type mismatch: cannot apply operator (%s) to (%s)", node->expr_data.op, type);
-                        addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, NULL); 
+                        snprintf(errorMsg, sizeof(errorMsg), "Type mismatch: cannot apply operator (%s) to (%s)", getOperatorName(op), getTypeName(type));
+                        addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, NULL); 
                     }else{
                         type = TYPE_INT;
                         node->inferedType = TYPE_INT;
@@ -837,7 +727,7 @@ const char* inferAndValidateType(ASTNode* node) {
                     node->inferedType = TYPE_INT;
                     break;      
                 default:
-                    type = NULL;
+                    type = TYPE_NONE;
                     break;
             }
             
@@ -845,8 +735,8 @@ const char* inferAndValidateType(ASTNode* node) {
         }
 
         default:
-            printf("Unknown node type at line %d\n", node->line_no);
-            type = NULL;
+            printf("Unknown node type at line %d\n", nodeSpan(node)->start_line);
+            type = TYPE_NONE;
             break;
     }
 
@@ -867,15 +757,15 @@ int validateTypesCallback(ASTNode* node, void* context) {
             // Check if value exists
             if(!node->var_data.value) return 0;
 
-            const char* type = inferAndValidateType(node);
-            if (node->var_data.id && node->var_data.id->type == NODE_ID && node->var_data.id->id_data.sym) {
-                symbol* sym = node->var_data.id->id_data.sym;
+            TypeId type = inferAndValidateType(node);
+            if (astNode(node->var_data.id) && astNode(node->var_data.id)->type == NODE_ID && astNode(node->var_data.id)->id_data.sym) {
+                symbol* sym = astNode(node->var_data.id)->id_data.sym;
                 logSemanticSymbolHighlight(
                     sym->scope ? sym->scope->table_id : 0,
                     sym->name,
                     "TYPE_UPDATE",
-                    sym->type,
-                    type ? type : sym->type,
+                    getTypeName(sym->type),
+                    getTypeName(type ? type : sym->type),
                     sym->line_no,
                     sym->char_no,
                     1
@@ -886,37 +776,37 @@ int validateTypesCallback(ASTNode* node, void* context) {
 
         case NODE_ASSGN: {
             if(isDebugOn) printf("Validating assignment\n");
-            const char* type = inferAndValidateType(node);
+            TypeId type = inferAndValidateType(node);
             return 0;
         }
 
         case NODE_EXPR_BINARY: {
             if(isDebugOn) printf("Validating bin expr\n");
-            const char* type = inferAndValidateType(node);
+            TypeId type = inferAndValidateType(node);
             return 0;
         }
 
         case NODE_EXPR_UNARY: {
             if(isDebugOn) printf("Validating unary expr\n");
-            const char* type = inferAndValidateType(node);
+            TypeId type = inferAndValidateType(node);
             return 0;
         }
 
         case NODE_EXPR_TERM: {
             if(isDebugOn) printf("Validating term expr\n");
-            const char* type = inferAndValidateType(node);
+            TypeId type = inferAndValidateType(node);
             return 0;
         }
 
         case NODE_RETURN: {
             if(isDebugOn) printf("Validating return stmt\n"); 
-            const char* type = inferAndValidateType(node);
+            TypeId type = inferAndValidateType(node);
             return 0;
         }
 
         case NODE_FUNC_CALL: {
             if(isDebugOn) printf("Validating func call\n");
-            const char* type = inferAndValidateType(node);
+            TypeId type = inferAndValidateType(node);
             return 0; 
         }
         default:
@@ -926,56 +816,57 @@ int validateTypesCallback(ASTNode* node, void* context) {
     return 1; // Continue traversing
 }
 
-// The main validateTypes function that calls traverseAST with the callback
-void validateTypes(ASTNode* root) {
-    SemanticTraversalLogContext traversalCtx = { .pass = currentSemanticPass };
-    traverseAST(root, validateTypesCallback, NULL, semanticTraversalLogger, &traversalCtx);
+static void addReturnCheck(SemanticWalkContext* ctx, ASTNode* node) {
+    if (ctx->returnCheckCount == ctx->returnCheckCapacity) {
+        ctx->returnCheckCapacity = ctx->returnCheckCapacity ? ctx->returnCheckCapacity * 2 : 16;
+        ctx->returnChecks = realloc(ctx->returnChecks, sizeof(ASTNode*) * ctx->returnCheckCapacity);
+        if (!ctx->returnChecks) {
+            fprintf(stderr, "Memory allocation failed for return checks\n");
+            exit(1);
+        }
+    }
+    ctx->returnChecks[ctx->returnCheckCount++] = node;
 }
 
-
-
-
-
-
-
-int validateBreakContinueStmtsCallback(ASTNode* node, void* ctx){
-    if(node->type == NODE_WHILE || node->type == NODE_FOR) return 0;
-
-    if(node->type == NODE_BREAK_STMT || node->type == NODE_CONTINUE_STMT){
-        ASTNode* loop_node = (ASTNode*)(ctx);
-        node->break_continue_stmt_data.associated_loop_node = loop_node;
-
+// Infers types and binds every return to its innermost function. The return
+// types themselves are compared by validateFunctionReturnTypes() once this
+// walk is known to be free of type errors.
+static int validateTypesAndReturnsCallback(ASTNode* node, void* context) {
+    SemanticWalkContext* ctx = (SemanticWalkContext*)context;
+
+    if (node->type == NODE_FUNC_DECL) {
+        addReturnCheck(ctx, node);
+        ASTNode* outerFunction = ctx->function;
+        ctx->function = node;
+        traverseChildren(node, validateTypesAndReturnsCallback, ctx);
+        ctx->function = outerFunction;
         return 0;
-    } 
-
-    return 1;
-}
+    }
 
-int validateLoopsCallback(ASTNode* node, void* context){
-    if(node->type == NODE_WHILE){
-        SemanticTraversalLogContext* traversalCtx = (SemanticTraversalLogContext*)context;
-        traverseAST(node->while_data.while_body->while_body_data.body, validateBreakContinueStmtsCallback, node, semanticTraversalLogger, traversalCtx);
-    }else if(node->type == NODE_FOR){
-        SemanticTraversalLogContext* traversalCtx = (SemanticTraversalLogContext*)context;
-        traverseAST(node->for_data.body->for_body_data.body, validateBreakContinueStmtsCallback, node, semanticTraversalLogger, traversalCtx);
+    if (node->type == NODE_RETURN && ctx->function) {
+        node->return_data.associated_node = astRef(ctx->function);
+        addReturnCheck(ctx, node);
     }
 
-    return 1;
+    return validateTypesCallback(node, NULL);
 }
 
-void validateLoops(ASTNode* node, BrkCntStmtsList* list){
-    SemanticTraversalLogContext traversalCtx = { .pass = currentSemanticPass };
-    traverseAST(node, validateLoopsCallback, &traversalCtx, semanticTraversalLogger, &traversalCtx);
+static void validateTypesAndReturns(ASTNode* root, SemanticWalkContext* ctx) {
+    ctx->log.pass = currentSemanticPass;
+    traverseAST(root, validateTypesAndReturnsCallback, ctx, semanticTraversalLogger, &ctx->log);
+}
 
-    // Check for invalid/unassigned break/continue stmts
+
+// Reports break/continue statements bindSymbolsAndLoops() found no loop for
+void validateLoops(BrkCntStmtsList* list){
     BrkCntStmtsList* temp = list;
     while(temp){
         if(temp->node->type == NODE_BREAK_STMT || temp->node->type == NODE_CONTINUE_STMT){
-            if(temp->node->break_continue_stmt_data.associated_loop_node == NULL){
+            if(!temp->node->break_continue_stmt_data.associated_loop_node){
                 char errorMsg[256];
                 char* type = temp->node->type == NODE_BREAK_STMT ? "break" : temp->node->type == NODE_CONTINUE_STMT ? "continue" : " ";
                 snprintf(errorMsg, sizeof(errorMsg), "\"%s\" must be within loop body", type);
-                addErrorWithContext(errorMsg, temp->node->line_no, temp->node->char_no, temp->node, NULL, NULL); 
+                addErrorWithContext(errorMsg, nodeSpan(temp->node)->start_line, nodeSpan(temp->node)->start_col, temp->node, NULL, NULL); 
             }
         }
         temp = temp->next;
@@ -983,79 +874,33 @@ void validateLoops(ASTNode* node, BrkCntStmtsList* list){
 }
 
 
-typedef struct {
-    ASTNode* func_decl_node;
-    bool ret_found;
-    const char* expected_type;
-} RetValCtx;
-
-int validateReturnStmtsCallback(ASTNode* node, void* ctx){
-
-    if(node->type == NODE_FUNC_DECL) return 0; // Stop traversing this branch
+// Goes over the functions and returns collected by validateTypesAndReturns()
+static void validateFunctionReturnTypes(SemanticWalkContext* ctx){
+    for (int i = 0; i < ctx->returnCheckCount; i++) {
+        ASTNode* node = ctx->returnChecks[i];
 
-    if(node->type == NODE_RETURN){
-        RetValCtx* val_ctx = (RetValCtx*)(ctx);
-        val_ctx->ret_found = true;
-        const char* ret_type = node->inferedType; // Assumed that the type is already infered by previous phase
-        const char* expected_type = val_ctx->expected_type;
+        if (node->type == NODE_FUNC_DECL) {
+            symbol* func_sym = astNode(node->func_decl_data.id)->id_data.sym;
+            if (!func_sym->type) {
+                char errorMsg[256];
+                snprintf(errorMsg, sizeof(errorMsg), "Type of '%s' is NULL", func_sym->name);
+                addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, func_sym->name);
+            }
+            continue;
+        }
 
-        if(!ret_type || !expected_type) return 0;
+        ASTNode* func_decl_node = astNode(node->return_data.associated_node);
+        symbol* func_sym = astNode(func_decl_node->func_decl_data.id)->id_data.sym;
+        TypeId ret_type = node->inferedType;
+        TypeId expected_type = func_sym->type;
+        if (!ret_type || !expected_type) continue;
 
-        if(strcmp(ret_type, expected_type) != 0){
+        if (ret_type != expected_type) {
             char errorMsg[256];
             snprintf(errorMsg, sizeof(errorMsg),
                      "Return type mismatch: expected (%s), got (%s) for '%s()'",
-                     expected_type, ret_type, val_ctx->func_decl_node->func_decl_data.id->id_data.sym->name);
-            addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, NULL);
-            
+                     getTypeName(expected_type), getTypeName(ret_type), func_sym->name);
+            addErrorWithContext(errorMsg, nodeSpan(node)->start_line, nodeSpan(node)->start_col, node, NULL, NULL);
         }
-
-        // Bind the reutrn stmt with the associated node
-        node->return_data.associated_node = val_ctx->func_decl_node;
-
-        return 0; // Stop traversing further down this branch
-    }
-
-    return 1; // Traverse other nodes
-}
-
-
-int validateFuncRetTypesCallback(ASTNode* node, void* context){
-    // Only handle function declarations
-    if (node->type != NODE_FUNC_DECL) return 1; // Skip non func_decl nodes and continue traversing
-
-    RetValCtx ret_ctx = {
-        .func_decl_node = node,
-        .ret_found = false,
-        .expected_type = node->func_decl_data.id->id_data.sym->type
-    };
-
-    if(!(ret_ctx.expected_type)){
-        char errorMsg[256];
-        snprintf(errorMsg, sizeof(errorMsg),
-                "Type of '%s' is NULL",
-                node->func_decl_data.id->id_data.sym->name);
-        addErrorWithContext(errorMsg, node->line_no, node->char_no, node, NULL, node->func_decl_data.id->id_data.sym->name); 
-
-        return 1;
     }
-
-    // Traverse only the function body to find return statements
-    SemanticTraversalLogContext traversalCtx = { .pass = currentSemanticPass };
-    traverseAST(node->func_decl_data.body, validateReturnStmtsCallback, &ret_ctx, semanticTraversalLogger, &traversalCtx);
-
-    // Non-void functions must have return stmts
-    // if(!(ret_ctx.ret_found) && strcmp(ret_ctx.expected_type, TYPE_VOID) != 0 ){
-    //     char errorMsg[256];
-    //     snprintf(errorMsg, sizeof(errorMsg),
-    //             "Missing return statement in function '%s' with (non-void) return type",
-    //             node->func_decl_data.id->id_data.sym->name);
-    //     addError(errorMsg, node->line_no, node->char_no); 
-    // }
-
-    return 1; // Look for other func declarations
-}
-void validateFunctionReturnTypes(ASTNode* root){
-    SemanticTraversalLogContext traversalCtx = { .pass = currentSemanticPass };
-    traverseAST(root, validateFuncRetTypesCallback, NULL, semanticTraversalLogger, &traversalCtx);
 }
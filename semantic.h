@@ -26,14 +26,13 @@ typedef struct BrkCntStmtsList{
 // Function to perform semantic analysis
 SemanticStatus performSemanticAnalysis(ASTNode* root, SymbolTable* globalTable, BrkCntStmtsList* list);
 
-// Helper function to validate symbol declarations for id_ref nodes
-void validateSymbolUsage(ASTNode* root);
+// Passes run by performSemanticAnalysis, types and return types are checked in
+// a single internal walk after these
 void checkDuplicates(SymbolTable* table);
-void validateLoops(ASTNode* node, BrkCntStmtsList* list);
-void validateTypes(ASTNode* root);
-void validateFunctionReturnTypes(ASTNode* root);
+void bindSymbolsAndLoops(ASTNode* root);
+void validateLoops(BrkCntStmtsList* list);
 void setSemanticDebugger();
-OpType getOpType(const char* op);
+OpType getOpType(Operator op);
 int getSemanticTotalErrors();
 
 #endif
@@ -0,0 +1,113 @@
+#include "stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include "ast.h"
+#include "icg.h"
+#include "intern.h"
+
+#define MAX_PHASES 16
+
+static bool isStatsOn = false;
+static bool statsAsJSON = false;
+
+static PhaseStats phases[MAX_PHASES];
+static int phaseCount = 0;
+
+static struct timespec phaseWallStart;
+static clock_t phaseCPUStart;
+
+void enableStats(bool json) {
+    isStatsOn = true;
+    statsAsJSON = json;
+}
+
+bool isStatsEnabled() {
+    return isStatsOn;
+}
+
+static void nowTimespec(struct timespec* ts) {
+#ifdef _WIN32
+    timespec_get(ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, ts);
+#endif
+}
+
+static long peakRSSKb() {
+#ifdef _WIN32
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+    return usage.ru_maxrss;  // Kilobytes on Linux
+#endif
+}
+
+static int countSymbolsIn(SymbolTable* table) {
+    if (!table) return 0;
+    int count = table->size;
+    for (int i = 0; i < table->num_children; i++) count += countSymbolsIn(table->children[i]);
+    return count;
+}
+
+void beginPhaseStats(const char* name) {
+    if (!isStatsOn || phaseCount == MAX_PHASES) return;
+    memset(&phases[phaseCount], 0, sizeof(PhaseStats));
+    phases[phaseCount].name = name;
+    phaseCPUStart = clock();
+    nowTimespec(&phaseWallStart);
+}
+
+void endPhaseStats(SymbolTable* globalScope) {
+    if (!isStatsOn || phaseCount == MAX_PHASES) return;
+    struct timespec end;
+    nowTimespec(&end);
+    clock_t cpuEnd = clock();
+
+    PhaseStats* phase = &phases[phaseCount++];
+    phase->wall_ms = (end.tv_sec - phaseWallStart.tv_sec) * 1000.0 + (end.tv_nsec - phaseWallStart.tv_nsec) / 1e6;
+    phase->cpu_ms = (double)(cpuEnd - phaseCPUStart) * 1000.0 / CLOCKS_PER_SEC;
+    phase->peak_rss_kb = peakRSSKb();
+    phase->ast_nodes = astArena.count;
+    phase->symbols = countSymbolsIn(globalScope);
+    phase->interned_strings = getInternCount();
+    getICGArenaUsage(&phase->icg_allocations, &phase->icg_bytes);
+    phase->tac_instructions = countTAC(codeList);
+}
+
+static void printStatsJSON() {
+    printf("{ \"phases\": [\n");
+    for (int i = 0; i < phaseCount; i++) {
+        const PhaseStats* p = &phases[i];
+        printf("  { \"phase\": \"%s\", \"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"peak_rss_kb\": %ld, "
+               "\"ast_nodes\": %d, \"symbols\": %d, \"interned_strings\": %d, "
+               "\"icg_allocations\": %zu, \"icg_bytes\": %zu, \"tac_instructions\": %d }%s\n",
+               p->name, p->wall_ms, p->cpu_ms, p->peak_rss_kb,
+               p->ast_nodes, p->symbols, p->interned_strings,
+               p->icg_allocations, p->icg_bytes, p->tac_instructions,
+               i + 1 < phaseCount ? "," : "");
+    }
+    printf("] }\n");
+}
+
+void printPhaseStats() {
+    if (!isStatsOn) return;
+    if (statsAsJSON) {
+        printStatsJSON();
+        return;
+    }
+    printf("\nCompilerStats----------------------------\n\n");
+    printf("%-10s %10s %10s %12s %9s %8s %9s %11s %11s %6s\n",
+           "Phase", "Wall ms", "CPU ms", "Peak RSS KB", "AST nodes", "Symbols", "Interned", "ICG allocs", "ICG bytes", "TAC");
+    for (int i = 0; i < phaseCount; i++) {
+        const PhaseStats* p = &phases[i];
+        printf("%-10s %10.3f %10.3f %12ld %9d %8d %9d %11zu %11zu %6d\n",
+               p->name, p->wall_ms, p->cpu_ms, p->peak_rss_kb,
+               p->ast_nodes, p->symbols, p->interned_strings,
+               p->icg_allocations, p->icg_bytes, p->tac_instructions);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "symTable.h"
+
+// Measurements of one compiler phase. Counts are totals at the end of the phase.
+typedef struct PhaseStats {
+    const char* name;
+    double wall_ms;
+    double cpu_ms;
+    long peak_rss_kb;         // Process high water mark, -1 where unsupported
+    int ast_nodes;
+    int symbols;
+    int interned_strings;
+    size_t icg_allocations;   // Objects bump allocated by the ICG arena
+    size_t icg_bytes;
+    int tac_instructions;
+} PhaseStats;
+
+// Turns on collection for --stats, otherwise beginPhaseStats/endPhaseStats do nothing
+void enableStats(bool json);
+bool isStatsEnabled();
+
+void beginPhaseStats(const char* name);
+void endPhaseStats(SymbolTable* globalScope);
+
+// Prints every finished phase as a table, or as JSON with --stats=json
+void printPhaseStats();
+
+#endif
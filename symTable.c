@@ -1,9 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "symTable.h"
 #include "ast.h"
 #include "logger.h"
+#include "intern.h"
 
 #define INITIAL_LOCAL_SCOPE_CAPACITY 20
 
@@ -13,6 +15,40 @@ void setSymTableDebugger(){
     isSymTableDebugOn = true;
 } 
 
+// Names are interned, so the index hashes the name pointer itself
+static unsigned int hashSymbolName(const char* name) {
+    uintptr_t key = (uintptr_t)name;
+    return (unsigned int)((key >> 3) * 2654435761u);
+}
+
+// Position of the first symbol named 'name', or -1
+static int findSymbolIndex(const SymbolTable* table, const char* name) {
+    unsigned int mask = table->index_capacity - 1;
+    unsigned int pos = hashSymbolName(name) & mask;
+    while (table->index[pos] != -1) {
+        if (table->symbols[table->index[pos]]->name == name) return table->index[pos];
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+static void indexSymbol(SymbolTable* table, int position) {
+    unsigned int mask = table->index_capacity - 1;
+    unsigned int pos = hashSymbolName(table->symbols[position]->name) & mask;
+    while (table->index[pos] != -1) pos = (pos + 1) & mask;
+    table->index[pos] = position;
+}
+
+static void allocSymbolIndex(SymbolTable* table, int capacity) {
+    table->index_capacity = capacity;
+    table->index = (int*)malloc(sizeof(int) * capacity);
+    if (!table->index) {
+        printf("Memory allocation for symbol index failed\n");
+        exit(1);
+    }
+    for (int i = 0; i < capacity; i++) table->index[i] = -1;
+}
+
 // Create a new symbol table
 SymbolTable* createSymbolTable(char* scopeName, SymbolTable* parent, int initial_capacity) {
     
@@ -28,20 +64,27 @@ SymbolTable* createSymbolTable(char* scopeName, SymbolTable* parent, int initial
     table->size = 0;
     table->capacity = initial_capacity;
     table->parent = parent;
+    table->children = NULL;
+    table->num_children = 0;
+    int index_capacity = 16;
+    while (index_capacity < initial_capacity * 2) index_capacity *= 2;
+    allocSymbolIndex(table, index_capacity);
     // printf("Created SymTable: %s\n", name);
 
-    Step s;
-    s.type = PARSE_CREATE_SCOPE;
-    s.CreateScope.parent_id = parent != NULL ? parent->table_id : 0;
-    s.CreateScope.scopeName = scopeName;
-    s.CreateScope.table_id = table->table_id;
-    log_step(s);
+    if (isTraceOn()) {
+        Step s;
+        s.type = PARSE_CREATE_SCOPE;
+        s.CreateScope.parent_id = parent != NULL ? parent->table_id : 0;
+        s.CreateScope.scopeName = scopeName;
+        s.CreateScope.table_id = table->table_id;
+        log_step(s);
+    }
 
     return table;
 }
 
 // Create a new symbol
-symbol* createSymbol(const char* name, char* type, SymbolTable* scope, int location, int is_function, int line_no, int char_no) {
+symbol* createSymbol(const char* name, TypeId type, SymbolTable* scope, int location, int is_function, int line_no, int char_no) {
     // printf("Creating symbol: %s\n", name);  
     symbol* sym = (symbol*)malloc(sizeof(symbol));
     if (!sym) {
@@ -49,15 +92,16 @@ symbol* createSymbol(const char* name, char* type, SymbolTable* scope, int locat
         exit(1);
     }
 
-    sym->name = strdup(name);    // Copy the name of the variable
-    sym->type = type ? strdup(type) : NULL;  
+    sym->name = intern(name);
+    sym->type = type;
     sym->scope = scope;                    // Assign the current scope
     sym->location = location;              // Placeholder for memory location
     sym->is_function = is_function;        // Set as variable (not a function initially)
     sym->line_no = line_no;
     sym->char_no = char_no;
     sym->is_duplicate = 0;  // Initialize duplicate flag to 0
-    if(isSymTableDebugOn) printf("[SYM TABLE] Created symbol: %s, type: %s\n", name, sym->type);   
+    sym->tac_name = NULL;
+    if(isSymTableDebugOn) printf("[SYM TABLE] Created symbol: %s, type: %s\n", name, getTypeName(sym->type));   
     return sym;
 }
 
@@ -72,47 +116,77 @@ void addSymbol(SymbolTable* table, symbol* sym) {
             exit(1);
         }
     }
+    sym->location = table->size;
     table->symbols[table->size++] = sym;
-    Step s;
-    s.type = PARSE_ADD_SYM;
-    s.AddSymbol.name = sym->name;
-    s.AddSymbol.type = sym->type;
-    s.AddSymbol.scope_id = sym->scope->table_id;
-    s.AddSymbol.is_duplicate = sym->is_duplicate;
-    s.AddSymbol.is_function = sym->is_function;
-    s.AddSymbol.line_no = sym->line_no;
-    s.AddSymbol.char_no = sym->char_no;
-    log_step(s);
-    if(isSymTableDebugOn) printf("[SYM TABLE] Added symbol: %s, type: %s\n", sym->name, sym->type);  // Add this
+
+    // Only the first declaration of a name is indexed, later ones are duplicates
+    if (findSymbolIndex(table, sym->name) == -1) {
+        if (table->size * 2 > table->index_capacity) {
+            free(table->index);
+            allocSymbolIndex(table, table->index_capacity * 2);
+            for (int i = 0; i < table->size - 1; i++) {
+                if (findSymbolIndex(table, table->symbols[i]->name) == -1) indexSymbol(table, i);
+            }
+        }
+        indexSymbol(table, table->size - 1);
+    }
+
+    if (isTraceOn()) {
+        Step s;
+        s.type = PARSE_ADD_SYM;
+        s.AddSymbol.name = sym->name;
+        s.AddSymbol.type = getTypeName(sym->type);
+        s.AddSymbol.scope_id = sym->scope->table_id;
+        s.AddSymbol.is_duplicate = sym->is_duplicate;
+        s.AddSymbol.is_function = sym->is_function;
+        s.AddSymbol.line_no = sym->line_no;
+        s.AddSymbol.char_no = sym->char_no;
+        log_step(s);
+    }
+    if(isSymTableDebugOn) printf("[SYM TABLE] Added symbol: %s, type: %s\n", sym->name, getTypeName(sym->type));  // Add this
 }
 
 // Look up a symbol in the current scope, searching up to parent scopes if not found
 symbol* lookupSymbol(SymbolTable* table, const char* name) {
+    int depth;
+    return resolveSymbol(table, name, &depth);
+}
+
+symbol* resolveSymbol(SymbolTable* table, const char* name, int* depth) {
+    name = intern(name);
     SymbolTable* current = table;
+    *depth = 0;
     while (current) {
-        for (int i = 0; i < current->size; i++) {
-            if (strcmp(current->symbols[i]->name, name) == 0) {
-                return current->symbols[i];
-            }
-        }
+        int position = findSymbolIndex(current, name);
+        if (position != -1) return current->symbols[position];
         current = current->parent;  // Move to the parent scope
+        (*depth)++;
     }
+    *depth = -1;
     return NULL;  // Symbol not found in any accessible scope
 }
 
+symbol* lookupSymbolInScope(SymbolTable* table, const char* name) {
+    if (!table) return NULL;
+    int position = findSymbolIndex(table, intern(name));
+    return position == -1 ? NULL : table->symbols[position];
+}
+
 
 // Scope management
 SymbolTable* enterScope(char* name, SymbolTable* currentScope) {
     SymbolTable* newScope = createSymbolTable(name, currentScope, INITIAL_LOCAL_SCOPE_CAPACITY);
     
-    Step s;
-    s.type = PARSE_ENTER_SCOPE;
-    s.EnterScope.scopeName = name;
-    s.EnterScope.table_id = newScope->table_id;
-    log_step(s);
+    if (isTraceOn()) {
+        Step s;
+        s.type = PARSE_ENTER_SCOPE;
+        s.EnterScope.scopeName = name;
+        s.EnterScope.table_id = newScope->table_id;
+        log_step(s);
+    }
 
     if(currentScope){
-        currentScope->children = realloc(currentScope->children, sizeof(SymbolTable*) * (currentScope->num_children) + 1);
+        currentScope->children = realloc(currentScope->children, sizeof(SymbolTable*) * (currentScope->num_children + 1));
         currentScope->children[currentScope->num_children++] = newScope;
     }
 
@@ -120,12 +194,13 @@ SymbolTable* enterScope(char* name, SymbolTable* currentScope) {
 }
 
 SymbolTable* exitScope(SymbolTable* currentScope) {
-    Step s;
-    s.type = PARSE_EXIT_SCOPE;
-    s.ExitScope.scopeName = currentScope->scopeName;
-    s.ExitScope.table_id = currentScope->table_id;
-
-    log_step(s);
+    if (isTraceOn()) {
+        Step s;
+        s.type = PARSE_EXIT_SCOPE;
+        s.ExitScope.scopeName = currentScope->scopeName;
+        s.ExitScope.table_id = currentScope->table_id;
+        log_step(s);
+    }
     if (currentScope == NULL || currentScope->parent == NULL) {
         // Stay in the global scope if there's no parent to go back to
         return currentScope;
@@ -137,11 +212,11 @@ SymbolTable* exitScope(SymbolTable* currentScope) {
 void freeSymbolTable(SymbolTable* table) {
     if (!table) return;
     for (int i = 0; i < table->size; i++) {
-        free((char*)table->symbols[i]->name);
-        free(table->symbols[i]->type);
         free(table->symbols[i]);
     }
     free(table->symbols);
+    free(table->index);
+    free(table->children);
     freeSymbolTable(table->parent); // Free parent scope if needed
     free(table);
 }
@@ -164,7 +239,7 @@ void printSymbolTable(SymbolTable* table) {
             snprintf(scopeInfo, sizeof(scopeInfo), "%s [%d]", sym->scope->scopeName, sym->scope->table_id);
             printf("| %-20s | %-12s | %-18s | %-10d | %-10d | %-10d | %-10s | %-14d |\n",
                 sym->name, 
-                sym->type, 
+                getTypeName(sym->type), 
                 scopeInfo,
                 sym->location, 
                 sym->line_no,
@@ -1,21 +1,24 @@
 #ifndef SYMTABLE_H
 #define SYMTABLE_H
 
+#include "types.h"
+
 
 // Forward declaration of ASTNode
 typedef struct ASTNode ASTNode;
 typedef struct SymbolTable SymbolTable;
 // Symbol structure
 typedef struct symbol {
-    const char* name;      // Symbol name (e.g., variable or function name)
-    char* type;      // Symbol type (e.g., int, float, etc.)
+    const char* name;      // Symbol name (e.g., variable or function name), interned
+    TypeId type;           // Symbol type, TYPE_NONE until the declaration assigns one
     SymbolTable* scope;       // Scope level (e.g., global = 0, local > 0)
-    int location;    // Memory location or offset in the stack
+    int location;    // Slot: position of the symbol in its scope, assigned by addSymbol
     int is_function; // Whether the symbol is a function
     ASTNode* func_node;
     int line_no;
     int char_no;
     int is_duplicate;
+    const char* tac_name;  // Scope suffixed name used in TAC, built once by getSymbolTACName()
 } symbol;
 
 // Symbol Table structure
@@ -25,6 +28,8 @@ typedef struct SymbolTable {
     symbol** symbols;   // Dynamic array of pointers to symbols
     int size;           // Number of symbols in the table
     int capacity;       // Capacity of the table
+    int* index;         // Open addressing table of positions in symbols, keyed by interned name
+    int index_capacity; // Power of two, at least twice the number of distinct names
     struct SymbolTable* parent; // Parent scope
     struct SymbolTable** children;
     int num_children;
@@ -33,8 +38,12 @@ typedef struct SymbolTable {
 // Function declarations
 SymbolTable* createSymbolTable(char* scopeName, SymbolTable* parent, int initial_capacity);
 void addSymbol(SymbolTable* table, symbol* sym);
-symbol* createSymbol(const char* name, char* type, SymbolTable* scope, int location, int is_function, int line_no, int char_no);
+symbol* createSymbol(const char* name, TypeId type, SymbolTable* scope, int location, int is_function, int line_no, int char_no);
 symbol* lookupSymbol(SymbolTable* table, const char* name);
+// Like lookupSymbol, and sets *depth to the number of parent hops to the declaring scope
+symbol* resolveSymbol(SymbolTable* table, const char* name, int* depth);
+// First symbol declared with this name in the table itself, parents are not searched
+symbol* lookupSymbolInScope(SymbolTable* table, const char* name);
 void freeSymbolTable(SymbolTable* table);
 void printSymbolTable(SymbolTable* table);
 SymbolTable* enterScope(char* name, SymbolTable* currentScope);
@@ -0,0 +1,39 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// On-disk layout of Logs/compiler_trace.bin, written by logger.c and turned
+// into Logs/compiler_logs.json by Scripts/trace_to_json.py.
+//
+//   TraceHeader
+//   TraceRecord * record_count
+//   string table: string_count entries of (uint32_t length, bytes), ids 1..n
+//
+// All values are little endian. String fields of a record hold a string id,
+// 0 stands for NULL. Strings are stored once however many records use them.
+
+#define TRACE_MAGIC "CTRC"
+#define TRACE_VERSION 1
+
+// Enough for the widest Step (ICGEmit)
+#define TRACE_FIELD_COUNT 12
+
+// Record kinds past the StepType values
+#define TRACE_PHASE_BEGIN 0x100   // fields[0] = PhaseType
+#define TRACE_PHASE_END   0x101
+
+typedef struct TraceHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t record_count;
+    uint32_t string_count;
+    uint64_t string_table_offset;
+} TraceHeader;
+
+typedef struct TraceRecord {
+    uint32_t kind;                       // StepType or TRACE_PHASE_*
+    int32_t fields[TRACE_FIELD_COUNT];   // Integers and string ids in Step field order
+} TraceRecord;
+
+#endif
@@ -0,0 +1,31 @@
+#include "types.h"
+#include <stddef.h>
+
+static const char* typeNames[TYPE_COUNT] = {
+    [TYPE_NONE]   = NULL,
+    [TYPE_VOID]   = "void",
+    [TYPE_INT]    = "int",
+    [TYPE_CHAR]   = "char",
+    [TYPE_FLOAT]  = "float",
+    [TYPE_STRING] = "string",
+};
+
+// Identical types need no promotion and char promotes to int when paired with int.
+// Every other pair has no valid promotion path.
+static const TypeId promotion[TYPE_COUNT][TYPE_COUNT] = {
+    [TYPE_VOID]   = { [TYPE_VOID]   = TYPE_VOID },
+    [TYPE_INT]    = { [TYPE_INT]    = TYPE_INT, [TYPE_CHAR] = TYPE_INT },
+    [TYPE_CHAR]   = { [TYPE_CHAR]   = TYPE_CHAR, [TYPE_INT] = TYPE_INT },
+    [TYPE_FLOAT]  = { [TYPE_FLOAT]  = TYPE_FLOAT },
+    [TYPE_STRING] = { [TYPE_STRING] = TYPE_STRING },
+};
+
+const char* getTypeName(TypeId type) {
+    if (type < 0 || type >= TYPE_COUNT) return NULL;
+    return typeNames[type];
+}
+
+TypeId promoteType(TypeId left, TypeId right) {
+    if (left <= TYPE_NONE || left >= TYPE_COUNT || right <= TYPE_NONE || right >= TYPE_COUNT) return TYPE_NONE;
+    return promotion[left][right];
+}
@@ -0,0 +1,20 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+// Type of a symbol or expression. TYPE_NONE means not known yet or invalid.
+typedef enum TypeId {
+    TYPE_NONE = 0,
+    TYPE_VOID,
+    TYPE_INT,
+    TYPE_CHAR,
+    TYPE_FLOAT,
+    TYPE_STRING,
+    TYPE_COUNT
+} TypeId;
+
+const char* getTypeName(TypeId type);
+
+// Common type of the two operands, TYPE_NONE if they cannot be combined
+TypeId promoteType(TypeId left, TypeId right);
+
+#endif